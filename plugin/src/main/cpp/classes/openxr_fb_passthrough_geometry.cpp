@@ -32,21 +32,14 @@
 #include "extensions/openxr_fb_passthrough_extension_wrapper.h"
 
 #include <godot_cpp/classes/engine.hpp>
-#include <godot_cpp/classes/shader.hpp>
-#include <godot_cpp/classes/shader_material.hpp>
 #include <godot_cpp/classes/standard_material3d.hpp>
+#include <godot_cpp/classes/world3d.hpp>
 #include <godot_cpp/classes/xr_server.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 
 using namespace godot;
 
 const Color PREVIEW_COLOR = Color(1.0, 0.0, 1.0);
-static const char *HOLE_PUNCH_SHADER_CODE =
-		"shader_type spatial;\n"
-		"render_mode blend_mix, depth_draw_opaque, cull_back, shadow_to_opacity, shadows_disabled;\n"
-		"void fragment() {\n"
-		"\tALBEDO = vec3(0.0, 0.0, 0.0);\n"
-		"}\n";
 
 void OpenXRFbPassthroughGeometry::set_mesh(const Ref<Mesh> &p_mesh) {
 	if (p_mesh == mesh) {
@@ -57,10 +50,15 @@ void OpenXRFbPassthroughGeometry::set_mesh(const Ref<Mesh> &p_mesh) {
 		destroy_passthrough_geometry();
 	}
 
+	// The hole punch is batched by mesh, so it has to move to the new mesh's batch.
+	if (hole_punch.is_valid()) {
+		delete_opaque_mesh();
+	}
+
 	mesh = p_mesh;
 
 	if (mesh.is_null()) {
-		if (opaque_mesh != nullptr) {
+		if (has_opaque_mesh()) {
 			delete_opaque_mesh();
 		}
 		return;
@@ -94,9 +92,9 @@ void OpenXRFbPassthroughGeometry::set_enable_hole_punch(bool p_enable) {
 		return;
 	}
 
-	if (opaque_mesh == nullptr && mesh.is_valid() && enable_hole_punch) {
+	if (!has_opaque_mesh() && mesh.is_valid() && enable_hole_punch) {
 		instatiate_opaque_mesh();
-	} else if (opaque_mesh != nullptr && !enable_hole_punch) {
+	} else if (has_opaque_mesh() && !enable_hole_punch) {
 		delete_opaque_mesh();
 	}
 }
@@ -114,7 +112,7 @@ void OpenXRFbPassthroughGeometry::create_passthrough_geometry() {
 		geometry_instance = OpenXRFbPassthroughExtensionWrapper::get_singleton()->geometry_instance_create(mesh->surface_get_arrays(0), get_transform());
 	}
 
-	if (opaque_mesh == nullptr && enable_hole_punch) {
+	if (!has_opaque_mesh() && mesh.is_valid() && enable_hole_punch) {
 		instatiate_opaque_mesh();
 	}
 
@@ -127,7 +125,7 @@ void OpenXRFbPassthroughGeometry::destroy_passthrough_geometry() {
 		geometry_instance = RID();
 	}
 
-	if (opaque_mesh != nullptr) {
+	if (has_opaque_mesh()) {
 		delete_opaque_mesh();
 	}
 }
@@ -138,15 +136,19 @@ void OpenXRFbPassthroughGeometry::update_passthrough_geometry_transform() {
 	}
 }
 
+bool OpenXRFbPassthroughGeometry::has_opaque_mesh() const {
+	return opaque_mesh != nullptr || hole_punch.is_valid();
+}
+
 void OpenXRFbPassthroughGeometry::instatiate_opaque_mesh() {
-	ERR_FAIL_COND_MSG(opaque_mesh != nullptr, "Opaque mesh child node already exists");
+	ERR_FAIL_COND_MSG(has_opaque_mesh(), "Opaque mesh already exists");
 	ERR_FAIL_COND_MSG(mesh.is_null(), "Mesh resource is null");
 
-	opaque_mesh = memnew(MeshInstance3D);
-	opaque_mesh->set_mesh(mesh);
-	add_child(opaque_mesh, false, Node::INTERNAL_MODE_BACK);
-
 	if (Engine::get_singleton()->is_editor_hint()) {
+		opaque_mesh = memnew(MeshInstance3D);
+		opaque_mesh->set_mesh(mesh);
+		add_child(opaque_mesh, false, Node::INTERNAL_MODE_BACK);
+
 		Ref<StandardMaterial3D> standard_material;
 		standard_material.instantiate();
 		standard_material->set_shading_mode(BaseMaterial3D::SHADING_MODE_UNSHADED);
@@ -154,24 +156,29 @@ void OpenXRFbPassthroughGeometry::instatiate_opaque_mesh() {
 
 		opaque_mesh->set_surface_override_material(0, standard_material);
 	} else {
-		Ref<Shader> shader;
-		shader.instantiate();
-		shader->set_code(HOLE_PUNCH_SHADER_CODE);
-
-		Ref<ShaderMaterial> shader_material;
-		shader_material.instantiate();
-		shader_material->set_shader(shader);
+		// The hole punch is drawn directly in the world's scenario, so it needs to be in the tree.
+		if (!is_inside_tree()) {
+			return;
+		}
 
-		opaque_mesh->set_surface_override_material(0, shader_material);
+		hole_punch = OpenXRFbPassthroughExtensionWrapper::get_singleton()->hole_punch_create(mesh, get_world_3d()->get_scenario(), get_global_transform());
+		set_notify_transform(true);
 	}
 }
 
 void OpenXRFbPassthroughGeometry::delete_opaque_mesh() {
-	ERR_FAIL_COND_MSG(opaque_mesh == nullptr, "Opaque mesh child node does not exist");
+	ERR_FAIL_COND_MSG(!has_opaque_mesh(), "Opaque mesh does not exist");
+
+	if (opaque_mesh != nullptr) {
+		remove_child(opaque_mesh);
+		opaque_mesh->queue_free();
+		opaque_mesh = nullptr;
+	}
 
-	remove_child(opaque_mesh);
-	opaque_mesh->queue_free();
-	opaque_mesh = nullptr;
+	if (hole_punch.is_valid()) {
+		OpenXRFbPassthroughExtensionWrapper::get_singleton()->hole_punch_free(hole_punch);
+		hole_punch = RID();
+	}
 }
 
 void OpenXRFbPassthroughGeometry::_notification(int p_what) {
@@ -186,7 +193,7 @@ void OpenXRFbPassthroughGeometry::_notification(int p_what) {
 			}
 		} break;
 		case NOTIFICATION_EXIT_TREE: {
-			if (geometry_instance.is_valid()) {
+			if (geometry_instance.is_valid() || hole_punch.is_valid()) {
 				destroy_passthrough_geometry();
 			}
 		} break;
@@ -200,6 +207,11 @@ void OpenXRFbPassthroughGeometry::_notification(int p_what) {
 		case NOTIFICATION_LOCAL_TRANSFORM_CHANGED: {
 			update_passthrough_geometry_transform();
 		} break;
+		case NOTIFICATION_TRANSFORM_CHANGED: {
+			if (hole_punch.is_valid()) {
+				OpenXRFbPassthroughExtensionWrapper::get_singleton()->hole_punch_set_transform(hole_punch, get_global_transform());
+			}
+		} break;
 	}
 }
 
@@ -30,13 +30,18 @@
 #include "classes/openxr_fb_scene_manager.h"
 
 #include <godot_cpp/classes/open_xr_interface.hpp>
+#include <godot_cpp/classes/time.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
 #include <godot_cpp/classes/xr_anchor3d.hpp>
 #include <godot_cpp/classes/xr_origin3d.hpp>
+#include <godot_cpp/classes/xr_pose.hpp>
 #include <godot_cpp/classes/xr_server.hpp>
 
 #include "classes/openxr_fb_spatial_entity_query.h"
 #include "extensions/openxr_fb_scene_capture_extension_wrapper.h"
 #include "extensions/openxr_fb_scene_extension_wrapper.h"
+#include "extensions/openxr_fb_spatial_entity_extension_wrapper.h"
+#include "util.h"
 
 using namespace godot;
 
@@ -50,6 +55,12 @@ void OpenXRFbSceneManager::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_auto_create", "enable"), &OpenXRFbSceneManager::set_auto_create);
 	ClassDB::bind_method(D_METHOD("get_auto_create"), &OpenXRFbSceneManager::get_auto_create);
 
+	ClassDB::bind_method(D_METHOD("set_instantiation_budget_usec", "usec"), &OpenXRFbSceneManager::set_instantiation_budget_usec);
+	ClassDB::bind_method(D_METHOD("get_instantiation_budget_usec"), &OpenXRFbSceneManager::get_instantiation_budget_usec);
+
+	ClassDB::bind_method(D_METHOD("set_scene_cache_path", "path"), &OpenXRFbSceneManager::set_scene_cache_path);
+	ClassDB::bind_method(D_METHOD("get_scene_cache_path"), &OpenXRFbSceneManager::get_scene_cache_path);
+
 	ClassDB::bind_method(D_METHOD("set_visible", "visible"), &OpenXRFbSceneManager::set_visible);
 	ClassDB::bind_method(D_METHOD("get_visible"), &OpenXRFbSceneManager::get_visible);
 	ClassDB::bind_method(D_METHOD("show"), &OpenXRFbSceneManager::show);
@@ -63,13 +74,19 @@ void OpenXRFbSceneManager::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_scene_capture_enabled"), &OpenXRFbSceneManager::is_scene_capture_enabled);
 	ClassDB::bind_method(D_METHOD("is_scene_capture_supported"), &OpenXRFbSceneManager::is_scene_capture_supported);
 
-	ClassDB::bind_method(D_METHOD("get_anchor_uuids"), &OpenXRFbSceneManager::get_anchor_uuids);
+	ClassDB::bind_method(D_METHOD("get_anchor_uuids", "label_mask"), &OpenXRFbSceneManager::get_anchor_uuids, DEFVAL(0));
 	ClassDB::bind_method(D_METHOD("get_anchor_node", "uuid"), &OpenXRFbSceneManager::get_anchor_node);
 	ClassDB::bind_method(D_METHOD("get_spatial_entity", "uuid"), &OpenXRFbSceneManager::get_spatial_entity);
 
+	ClassDB::bind_method(D_METHOD("raycast_anchors", "from", "to", "label_mask"), &OpenXRFbSceneManager::raycast_anchors, DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("get_anchors_in_sphere", "center", "radius", "label_mask"), &OpenXRFbSceneManager::get_anchors_in_sphere, DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("get_nearest_anchors", "point", "count", "label_mask"), &OpenXRFbSceneManager::get_nearest_anchors, DEFVAL(1), DEFVAL(0));
+
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "default_scene", PROPERTY_HINT_RESOURCE_TYPE, "PackedScene"), "set_default_scene", "get_default_scene");
 	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "scene_setup_method", PROPERTY_HINT_NONE, ""), "set_scene_setup_method", "get_scene_setup_method");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "auto_create", PROPERTY_HINT_NONE, ""), "set_auto_create", "get_auto_create");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "instantiation_budget_usec", PROPERTY_HINT_RANGE, "0,100000,1,or_greater,suffix:µs"), "set_instantiation_budget_usec", "get_instantiation_budget_usec");
+	ADD_PROPERTY(PropertyInfo(Variant::STRING, "scene_cache_path", PROPERTY_HINT_FILE, ""), "set_scene_cache_path", "get_scene_cache_path");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "visible", PROPERTY_HINT_NONE, ""), "set_visible", "get_visible");
 
 	ADD_SIGNAL(MethodInfo("openxr_fb_scene_anchor_created", PropertyInfo(Variant::Type::OBJECT, "scene_node"), PropertyInfo(Variant::Type::OBJECT, "spatial_entity")));
@@ -80,9 +97,14 @@ void OpenXRFbSceneManager::_bind_methods() {
 bool OpenXRFbSceneManager::_set(const StringName &p_name, const Variant &p_value) {
 	PackedStringArray parts = p_name.split("/", true, 2);
 	if (parts.size() == 2 && parts[0] == "scenes") {
-		const PackedStringArray &semantic_labels = OpenXRFbSceneExtensionWrapper::get_supported_semantic_labels();
-		if (semantic_labels.has(parts[1])) {
-			scenes[parts[1]] = p_value;
+		int label = OpenXRFbSceneExtensionWrapper::find_semantic_label(parts[1]);
+		if (label >= 0) {
+			scenes[label] = p_value;
+			if (scenes[label].is_valid()) {
+				scene_label_mask |= 1u << label;
+			} else {
+				scene_label_mask &= ~(1u << label);
+			}
 			return true;
 		}
 	}
@@ -92,10 +114,9 @@ bool OpenXRFbSceneManager::_set(const StringName &p_name, const Variant &p_value
 bool OpenXRFbSceneManager::_get(const StringName &p_name, Variant &r_ret) const {
 	PackedStringArray parts = p_name.split("/", true, 2);
 	if (parts.size() == 2 && parts[0] == "scenes") {
-		const PackedStringArray &semantic_labels = OpenXRFbSceneExtensionWrapper::get_supported_semantic_labels();
-		if (semantic_labels.has(parts[1])) {
-			const Ref<PackedScene> *scene = scenes.getptr(parts[1]);
-			r_ret = scene ? Variant(*scene) : Variant();
+		int label = OpenXRFbSceneExtensionWrapper::find_semantic_label(parts[1]);
+		if (label >= 0) {
+			r_ret = scenes[label];
 			return true;
 		}
 	}
@@ -117,6 +138,7 @@ void OpenXRFbSceneManager::_notification(int p_what) {
 				openxr_interface->connect("session_begun", callable_mp(this, &OpenXRFbSceneManager::_on_openxr_session_begun));
 				openxr_interface->connect("session_stopping", callable_mp(this, &OpenXRFbSceneManager::_on_openxr_session_stopping));
 			}
+			XRServer::get_singleton()->connect("tracker_added", callable_mp(this, &OpenXRFbSceneManager::_on_tracker_added));
 
 			xr_origin = Object::cast_to<XROrigin3D>(get_parent());
 			if (xr_origin && auto_create && openxr_interface.is_valid() && openxr_interface->is_initialized()) {
@@ -129,12 +151,22 @@ void OpenXRFbSceneManager::_notification(int p_what) {
 				openxr_interface->disconnect("session_begun", callable_mp(this, &OpenXRFbSceneManager::_on_openxr_session_begun));
 				openxr_interface->disconnect("session_stopping", callable_mp(this, &OpenXRFbSceneManager::_on_openxr_session_stopping));
 			}
+			XRServer::get_singleton()->disconnect("tracker_added", callable_mp(this, &OpenXRFbSceneManager::_on_tracker_added));
 
 			if (xr_origin && anchors_created) {
 				remove_scene_anchors();
 			}
 			xr_origin = nullptr;
 		} break;
+		case NOTIFICATION_PROCESS: {
+			_process_pending_work();
+		} break;
+		case NOTIFICATION_APPLICATION_PAUSED:
+		case NOTIFICATION_WM_CLOSE_REQUEST: {
+			if (!scene_cache_path.is_empty() && anchors_created && !capturing_scene_snapshot) {
+				_save_scene_cache();
+			}
+		} break;
 	}
 }
 
@@ -187,12 +219,42 @@ bool OpenXRFbSceneManager::get_auto_create() const {
 	return auto_create;
 }
 
+void OpenXRFbSceneManager::set_instantiation_budget_usec(int p_usec) {
+	ERR_FAIL_COND(p_usec < 0);
+	instantiation_budget_usec = p_usec;
+}
+
+int OpenXRFbSceneManager::get_instantiation_budget_usec() const {
+	return instantiation_budget_usec;
+}
+
+void OpenXRFbSceneManager::set_scene_cache_path(const String &p_path) {
+	if (p_path == scene_cache_path) {
+		return;
+	}
+
+	if (!scene_cache_path.is_empty()) {
+		_save_scene_cache();
+	}
+
+	scene_cache_path = p_path;
+	if (scene_cache_path.is_empty()) {
+		scene_cache.clear();
+	} else {
+		scene_cache.load(scene_cache_path);
+	}
+}
+
+String OpenXRFbSceneManager::get_scene_cache_path() const {
+	return scene_cache_path;
+}
+
 void OpenXRFbSceneManager::set_visible(bool p_visible) {
 	visible = p_visible;
 
-	for (KeyValue<StringName, Anchor> &E : anchors) {
+	for (KeyValue<XrUuidEXT, Anchor> &E : anchors) {
 		Node3D *node = Object::cast_to<Node3D>(ObjectDB::get_instance(E.value.node));
-		ERR_CONTINUE_MSG(!node, vformat("Cannot find node for anchor %s.", E.key));
+		ERR_CONTINUE_MSG(!node, vformat("Cannot find node for anchor %s.", OpenXRUtilities::uuid_to_string_name(E.key)));
 		if (node) {
 			node->set_visible(p_visible);
 		}
@@ -226,6 +288,11 @@ Error OpenXRFbSceneManager::create_scene_anchors() {
 	if (ret == OK) {
 		// Count as created right away so we don't double create the anchors.
 		anchors_created = true;
+
+		// Show the cached scene while the runtime is queried.
+		if (!scene_cache_path.is_empty()) {
+			_create_cached_scene_anchors();
+		}
 	} else {
 		ERR_PRINT("OpenXRFbSceneManager: Unable to query room layout.");
 	}
@@ -233,16 +300,205 @@ Error OpenXRFbSceneManager::create_scene_anchors() {
 	return ret;
 }
 
+void OpenXRFbSceneManager::_create_cached_scene_anchors() {
+	XrUuidEXT room_uuid;
+	if (!scene_cache.get_last_room(room_uuid)) {
+		return;
+	}
+
+	scene_room = room_uuid;
+	has_scene_room = true;
+
+	const SceneCache::Room *room = scene_cache.get_room(room_uuid);
+	for (const KeyValue<XrUuidEXT, SceneCache::EntityData> &E : *room) {
+		Ref<OpenXRFbSpatialEntity> entity = memnew(OpenXRFbSpatialEntity(E.key, E.value));
+
+		Ref<PackedScene> packed_scene = get_scene_for_entity(entity);
+		if (packed_scene.is_valid()) {
+			_queue_scene_anchor(entity, packed_scene);
+		}
+	}
+}
+
+void OpenXRFbSceneManager::_remove_cached_scene_anchors(const Array &p_keep_entities) {
+	UuidHashMap<bool> keep;
+	for (int i = 0; i < p_keep_entities.size(); i++) {
+		Ref<OpenXRFbSpatialEntity> entity = p_keep_entities[i];
+		if (entity.is_valid()) {
+			keep.insert(entity->get_xr_uuid(), true);
+		}
+	}
+
+	LocalVector<XrUuidEXT> stale;
+	for (const KeyValue<XrUuidEXT, Anchor> &E : anchors) {
+		if (E.value.entity->is_cached() && !keep.has(E.key)) {
+			stale.push_back(E.key);
+		}
+	}
+	for (const XrUuidEXT &uuid : stale) {
+		_remove_scene_anchor(uuid);
+	}
+
+	for (uint32_t i = 0; i < pending_anchors.size();) {
+		if (pending_anchors[i].entity->is_cached() && !keep.has(pending_anchors[i].entity->get_xr_uuid())) {
+			pending_anchors.remove_at_unordered(i);
+			pending_anchors_sorted = false;
+		} else {
+			i++;
+		}
+	}
+}
+
+void OpenXRFbSceneManager::_capture_scene_anchor(const Ref<OpenXRFbSpatialEntity> &p_entity) {
+	ERR_FAIL_COND(scene_captures_started >= scene_captures.size());
+	const uint32_t index = scene_captures_started++;
+
+	SceneCapture &capture = scene_captures[index];
+	if (!p_entity->capture_scene_data(capture.data)) {
+		// Nothing to cache or compare against.
+		_setup_scene_anchor(p_entity, false);
+		return;
+	}
+	capture.entity = p_entity;
+	capture.cached_entity = _find_cached_entity(p_entity->get_xr_uuid());
+
+	scene_captures_left++;
+	capture.task_id = WorkerThreadPool::get_singleton()->add_task(callable_mp(this, &OpenXRFbSceneManager::_scene_capture_task).bind(index), false, "Capture scene anchor data");
+}
+
+void OpenXRFbSceneManager::_scene_capture_task(uint32_t p_index) {
+	SceneCapture &capture = scene_captures[p_index];
+	capture.entity->fetch_scene_mesh_data(capture.data);
+	capture.unchanged = capture.cached_entity.is_valid() && capture.cached_entity->get_cached_data().has_same_geometry(capture.data);
+
+	// The anchor is set up on the main thread.
+	callable_mp(this, &OpenXRFbSceneManager::_finish_scene_capture).call_deferred(p_index, scene_capture_generation);
+}
+
+void OpenXRFbSceneManager::_finish_scene_capture(uint32_t p_index, uint32_t p_generation) {
+	if (p_generation != scene_capture_generation) {
+		// The captures were cancelled after this one finished.
+		return;
+	}
+
+	SceneCapture &capture = scene_captures[p_index];
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(capture.task_id);
+
+	Ref<OpenXRFbSpatialEntity> entity = capture.entity;
+	const bool unchanged = capture.unchanged;
+	scene_snapshot.insert(entity->get_xr_uuid(), capture.data);
+	// Release the entities and the mesh data right away.
+	capture = SceneCapture();
+	scene_captures_left--;
+
+	_setup_scene_anchor(entity, unchanged);
+
+	if (scene_captures_left == 0 && pending_entities.is_empty() && capturing_scene_snapshot) {
+		_finish_scene_snapshot();
+	}
+}
+
+void OpenXRFbSceneManager::_cancel_scene_captures() {
+	for (const SceneCapture &capture : scene_captures) {
+		if (capture.task_id >= 0) {
+			WorkerThreadPool::get_singleton()->wait_for_task_completion(capture.task_id);
+		}
+	}
+	scene_captures.clear();
+	scene_captures_started = 0;
+	scene_captures_left = 0;
+	scene_capture_generation++;
+}
+
+Ref<OpenXRFbSpatialEntity> OpenXRFbSceneManager::_find_cached_entity(const XrUuidEXT &p_uuid) const {
+	const Anchor *anchor = anchors.getptr(p_uuid);
+	if (anchor) {
+		return anchor->entity->is_cached() ? anchor->entity : Ref<OpenXRFbSpatialEntity>();
+	}
+
+	for (const PendingAnchor &pending_anchor : pending_anchors) {
+		if (pending_anchor.entity->is_cached() && UuidComparator::compare(pending_anchor.entity->get_xr_uuid(), p_uuid)) {
+			return pending_anchor.entity;
+		}
+	}
+	return Ref<OpenXRFbSpatialEntity>();
+}
+
+void OpenXRFbSceneManager::_finish_scene_snapshot() {
+	capturing_scene_snapshot = false;
+	scene_captures.clear();
+	scene_captures_started = 0;
+
+	// Keep the last known poses of anchors that haven't been located yet.
+	const SceneCache::Room *previous_room = scene_cache.get_room(scene_room);
+	if (previous_room) {
+		for (KeyValue<XrUuidEXT, SceneCache::EntityData> &E : scene_snapshot) {
+			const SceneCache::EntityData *previous_data = previous_room->getptr(E.key);
+			if (previous_data && previous_data->has_pose) {
+				E.value.pose = previous_data->pose;
+				E.value.has_pose = true;
+			}
+		}
+	}
+
+	scene_cache.set_room(scene_room, scene_snapshot);
+	scene_snapshot.clear();
+	_save_scene_cache();
+}
+
+void OpenXRFbSceneManager::_update_scene_cache_poses() {
+	if (!has_scene_room) {
+		return;
+	}
+
+	for (const KeyValue<XrUuidEXT, Anchor> &E : anchors) {
+		XRAnchor3D *node = Object::cast_to<XRAnchor3D>(ObjectDB::get_instance(E.value.node));
+		if (node && !E.value.entity->is_cached() && node->get_has_tracking_data()) {
+			scene_cache.set_entity_pose(scene_room, E.key, node->get_transform());
+		}
+	}
+}
+
+void OpenXRFbSceneManager::_save_scene_cache() {
+	_update_scene_cache_poses();
+	if (scene_cache.is_dirty()) {
+		scene_cache.save();
+	}
+}
+
 void OpenXRFbSceneManager::_on_room_layout_query_completed(Array p_results) {
+	if (!anchors_created) {
+		// The anchors were removed while the query was running.
+		return;
+	}
+
 	Array anchor_uuids;
+	LocalVector<XrUuidEXT> room_layouts;
 
 	for (int i = 0; i < p_results.size(); i++) {
 		Ref<OpenXRFbSpatialEntity> room_layout = p_results[i];
 		ERR_CONTINUE(room_layout.is_null());
 		anchor_uuids.append_array(room_layout->get_contained_uuids());
+		room_layouts.push_back(room_layout->get_xr_uuid());
+	}
+
+	// The scene spans all the room layouts, so they're cached together.
+	if (!room_layouts.is_empty()) {
+		const XrUuidEXT room_key = SceneCache::make_room_key(room_layouts);
+		if (has_scene_room && !UuidComparator::compare(scene_room, room_key)) {
+			// The cached scene is for different rooms.
+			_remove_cached_scene_anchors(Array());
+		}
+		scene_room = room_key;
+		has_scene_room = true;
 	}
 
 	if (anchor_uuids.size() == 0) {
+		_remove_cached_scene_anchors(Array());
+		if (has_scene_room) {
+			scene_cache.erase_room(scene_room);
+			has_scene_room = false;
+		}
 		anchors_created = false;
 		emit_signal("openxr_fb_scene_data_missing");
 		return;
@@ -257,78 +513,333 @@ void OpenXRFbSceneManager::_on_room_layout_query_completed(Array p_results) {
 }
 
 void OpenXRFbSceneManager::_on_anchor_query_completed(const Array &p_results) {
-	for (int i = 0; i < p_results.size(); i++) {
+	if (!anchors_created) {
+		// The anchors were removed while the query was running.
+		return;
+	}
+
+	// Cached anchors that the runtime no longer knows about are removed right
+	// away. The others are validated as their entities are set up.
+	_remove_cached_scene_anchors(p_results);
+	_cancel_scene_captures();
+	if (!scene_cache_path.is_empty() && has_scene_room) {
+		scene_snapshot.clear();
+		capturing_scene_snapshot = true;
+	}
+
+	// Entities are popped off the back, so queue them in reverse to set them up in order.
+	pending_entities.reserve(pending_entities.size() + p_results.size());
+	for (int i = p_results.size() - 1; i >= 0; i--) {
 		Ref<OpenXRFbSpatialEntity> entity = p_results[i];
 		ERR_CONTINUE(entity.is_null());
+		pending_entities.push_back(entity);
+	}
+	if (capturing_scene_snapshot) {
+		scene_captures.resize(pending_entities.size());
+	}
 
-		Ref<PackedScene> packed_scene = get_scene_for_entity(entity);
-		if (packed_scene.is_null()) {
-			// If the developer doesn't give a default or a specific scene, that's fine, just skip it.
-			continue;
-		}
+	if (pending_entities.is_empty() && capturing_scene_snapshot) {
+		_finish_scene_snapshot();
+	}
+
+	_update_pending_work_processing();
+}
+
+void OpenXRFbSceneManager::_setup_scene_anchor(const Ref<OpenXRFbSpatialEntity> &p_runtime_entity, bool p_unchanged) {
+	Ref<OpenXRFbSpatialEntity> entity = p_runtime_entity;
+	const XrUuidEXT &uuid = p_runtime_entity->get_xr_uuid();
 
-		// Ensure that the spatial entity is locatable before creating the anchor.
-		if (entity->is_component_enabled(OpenXRFbSpatialEntity::COMPONENT_TYPE_LOCATABLE)) {
-			_create_scene_anchor(entity, packed_scene);
-		} else if (entity->is_component_supported(OpenXRFbSpatialEntity::COMPONENT_TYPE_LOCATABLE)) {
-			entity->connect("openxr_fb_spatial_entity_set_component_enabled_completed", callable_mp(this, &OpenXRFbSceneManager::_on_anchor_enable_locatable_completed).bind(entity, packed_scene), CONNECT_ONE_SHOT);
-			entity->set_component_enabled(OpenXRFbSpatialEntity::COMPONENT_TYPE_LOCATABLE, true);
+	// Patch the cached scene against the runtime.
+	const Anchor *cached_anchor = anchors.getptr(uuid);
+	if (cached_anchor && cached_anchor->entity->is_cached()) {
+		if (p_unchanged) {
+			// Unchanged, so keep the instantiated scene and start tracking it.
+			cached_anchor->entity->attach_space(p_runtime_entity->get_space());
+			entity = cached_anchor->entity;
+		} else {
+			_remove_scene_anchor(uuid);
+		}
+	} else {
+		// The cached anchor hasn't been instantiated yet, so use the runtime entity instead.
+		for (uint32_t i = 0; i < pending_anchors.size(); i++) {
+			if (pending_anchors[i].entity->is_cached() && UuidComparator::compare(pending_anchors[i].entity->get_xr_uuid(), uuid)) {
+				pending_anchors.remove_at_unordered(i);
+				pending_anchors_sorted = false;
+				break;
+			}
 		}
 	}
+
+	Ref<PackedScene> packed_scene = get_scene_for_entity(entity);
+	if (packed_scene.is_null()) {
+		// If the developer doesn't give a default or a specific scene, that's fine, just skip it.
+		return;
+	}
+
+	// Ensure that the spatial entity is locatable before creating the anchor.
+	if (entity->is_component_enabled(OpenXRFbSpatialEntity::COMPONENT_TYPE_LOCATABLE)) {
+		_queue_scene_anchor(entity, packed_scene);
+	} else if (entity->is_component_supported(OpenXRFbSpatialEntity::COMPONENT_TYPE_LOCATABLE)) {
+		entity->connect("openxr_fb_spatial_entity_set_component_enabled_completed", callable_mp(this, &OpenXRFbSceneManager::_on_anchor_enable_locatable_completed).bind(entity, packed_scene), CONNECT_ONE_SHOT);
+		entity->set_component_enabled(OpenXRFbSpatialEntity::COMPONENT_TYPE_LOCATABLE, true);
+	}
 }
 
 void OpenXRFbSceneManager::_on_anchor_enable_locatable_completed(bool p_succeeded, OpenXRFbSpatialEntity::ComponentType p_component, bool p_enabled, const Ref<OpenXRFbSpatialEntity> &p_entity, const Ref<PackedScene> &p_packed_scene) {
 	ERR_FAIL_COND_MSG(!p_succeeded, vformat("Unable to make scene anchor %s locatable.", p_entity->get_uuid()));
-	_create_scene_anchor(p_entity, p_packed_scene);
+	if (!anchors_created) {
+		// The anchors were removed while waiting on the runtime.
+		return;
+	}
+	_queue_scene_anchor(p_entity, p_packed_scene);
+}
+
+void OpenXRFbSceneManager::_queue_scene_anchor(const Ref<OpenXRFbSpatialEntity> &p_entity, const Ref<PackedScene> &p_packed_scene) {
+	PendingAnchor pending_anchor;
+	pending_anchor.entity = p_entity;
+	pending_anchor.packed_scene = p_packed_scene;
+	pending_anchors.push_back(pending_anchor);
+	pending_anchors_sorted = false;
+
+	_update_pending_work_processing();
+}
+
+void OpenXRFbSceneManager::_update_pending_work_processing() {
+	set_process(!pending_entities.is_empty() || !pending_anchors.is_empty());
+}
+
+void OpenXRFbSceneManager::_process_pending_work() {
+	const uint64_t start_usec = Time::get_singleton()->get_ticks_usec();
+	const uint64_t budget_usec = instantiation_budget_usec;
+
+	// Always make some progress, even if a single step is over budget.
+	bool first = true;
+
+	// Set up entities before instantiating anything, so the runtime can work
+	// on making them locatable while we instantiate the ones that already are.
+	while (!pending_entities.is_empty()) {
+		if (!first && budget_usec > 0 && Time::get_singleton()->get_ticks_usec() - start_usec >= budget_usec) {
+			return;
+		}
+		first = false;
+
+		Ref<OpenXRFbSpatialEntity> entity = pending_entities[pending_entities.size() - 1];
+		pending_entities.remove_at(pending_entities.size() - 1);
+		if (capturing_scene_snapshot) {
+			// Set up once the data is captured.
+			_capture_scene_anchor(entity);
+		} else {
+			_setup_scene_anchor(entity, false);
+		}
+
+		if (pending_entities.is_empty() && scene_captures_left == 0 && capturing_scene_snapshot) {
+			_finish_scene_snapshot();
+		}
+	}
+
+	while (!pending_anchors.is_empty()) {
+		if (!first && budget_usec > 0 && Time::get_singleton()->get_ticks_usec() - start_usec >= budget_usec) {
+			return;
+		}
+		first = false;
+
+		if (!pending_anchors_sorted) {
+			_sort_pending_anchors();
+		}
+
+		PendingAnchor pending_anchor = pending_anchors[pending_anchors.size() - 1];
+		pending_anchors.remove_at(pending_anchors.size() - 1);
+		_create_scene_anchor(pending_anchor.entity, pending_anchor.packed_scene);
+	}
+
+	_update_pending_work_processing();
+}
+
+void OpenXRFbSceneManager::_sort_pending_anchors() {
+	OpenXRFbSpatialEntityExtensionWrapper *spatial_entity_wrapper = OpenXRFbSpatialEntityExtensionWrapper::get_singleton();
+	const Vector3 hmd_position = XRServer::get_singleton()->get_hmd_transform().origin;
+
+	for (PendingAnchor &pending_anchor : pending_anchors) {
+		Vector3 position;
+		if (pending_anchor.entity->is_cached()) {
+			const SceneCache::EntityData &cached_data = pending_anchor.entity->get_cached_data();
+			pending_anchor.distance = cached_data.has_pose ? hmd_position.distance_to(cached_data.pose.origin) : Math_INF;
+		} else if (spatial_entity_wrapper->locate_space(pending_anchor.entity->get_space(), position)) {
+			pending_anchor.distance = hmd_position.distance_to(position);
+		} else {
+			// Anchors that can't be located yet go last.
+			pending_anchor.distance = Math_INF;
+		}
+	}
+
+	pending_anchors.sort_custom<PendingAnchorFarthestFirst>();
+	pending_anchors_sorted = true;
+}
+
+void OpenXRFbSceneManager::_clear_pending_work() {
+	_cancel_scene_captures();
+	pending_entities.clear();
+	pending_anchors.clear();
+	pending_anchors_sorted = true;
+	set_process(false);
 }
 
 void OpenXRFbSceneManager::_create_scene_anchor(const Ref<OpenXRFbSpatialEntity> &p_entity, const Ref<PackedScene> &p_packed_scene) {
-	p_entity->track();
+	if (anchors.has(p_entity->get_xr_uuid())) {
+		// A cached anchor that the runtime has confirmed.
+		if (!p_entity->is_cached()) {
+			p_entity->track();
+		}
+		return;
+	}
+
+	if (!p_entity->is_cached()) {
+		p_entity->track();
+	}
 
 	XRAnchor3D *node = memnew(XRAnchor3D);
 	node->set_name(p_entity->get_uuid());
 	node->set_tracker(p_entity->get_uuid());
 	node->set_visible(visible);
+	if (p_entity->is_cached() && p_entity->get_cached_data().has_pose) {
+		// Placed at the last known pose until the runtime is tracking it.
+		node->set_transform(p_entity->get_cached_data().pose);
+	}
 	xr_origin->add_child(node);
 
 	Node *scene = p_packed_scene->instantiate();
 	node->add_child(scene);
 
-	anchors[p_entity->get_uuid()] = Anchor(node, p_entity);
+	Anchor &anchor = anchors.insert(p_entity->get_xr_uuid(), Anchor(node, p_entity))->value;
+	_add_anchor_to_bvh(anchor);
 
 	scene->call(scene_setup_method, p_entity);
 	emit_signal("openxr_fb_scene_anchor_created", scene, p_entity);
 }
 
+void OpenXRFbSceneManager::_add_anchor_to_bvh(Anchor &p_anchor) {
+	AABB bounds;
+	if (p_anchor.entity->is_component_enabled(OpenXRFbSpatialEntity::COMPONENT_TYPE_BOUNDED_3D)) {
+		bounds = p_anchor.entity->get_bounding_box_3d();
+	} else if (p_anchor.entity->is_component_enabled(OpenXRFbSpatialEntity::COMPONENT_TYPE_BOUNDED_2D)) {
+		// 2D bounds lie in the anchor's XY plane.
+		Rect2 rect = p_anchor.entity->get_bounding_box_2d();
+		bounds = AABB(Vector3(rect.position.x, rect.position.y, 0.0), Vector3(rect.size.x, rect.size.y, 0.0));
+	} else {
+		// Nothing to query against.
+		return;
+	}
+
+	p_anchor.bvh_item = anchor_bvh.add_item(p_anchor.entity->get_xr_uuid(), bounds, int64_t(p_anchor.entity->get_semantic_label_mask()));
+
+	if (p_anchor.entity->is_cached() && p_anchor.entity->get_cached_data().has_pose) {
+		anchor_bvh.set_item_transform(p_anchor.bvh_item, p_anchor.entity->get_cached_data().pose);
+	}
+
+	// The tracker may not exist until the entity is first located, see _on_tracker_added().
+	Ref<XRPositionalTracker> tracker = XRServer::get_singleton()->get_tracker(p_anchor.entity->get_uuid());
+	if (tracker.is_valid()) {
+		_connect_anchor_tracker(p_anchor, tracker);
+	}
+}
+
+void OpenXRFbSceneManager::_connect_anchor_tracker(Anchor &p_anchor, const Ref<XRPositionalTracker> &p_tracker) {
+	p_anchor.tracker = p_tracker;
+	p_tracker->connect("pose_changed", callable_mp(this, &OpenXRFbSceneManager::_on_anchor_pose_changed).bind(p_anchor.bvh_item));
+
+	Ref<XRPose> pose = p_tracker->get_pose("default");
+	if (pose.is_valid()) {
+		_on_anchor_pose_changed(pose, p_anchor.bvh_item);
+	}
+}
+
+void OpenXRFbSceneManager::_on_tracker_added(const StringName &p_tracker_name, int p_type) {
+	if (p_type != XRServer::TRACKER_ANCHOR) {
+		return;
+	}
+
+	XrUuidEXT uuid;
+	Anchor *anchor = OpenXRUtilities::string_to_uuid(p_tracker_name, uuid) ? anchors.getptr(uuid) : nullptr;
+	if (anchor && anchor->bvh_item >= 0 && anchor->tracker.is_null()) {
+		_connect_anchor_tracker(*anchor, XRServer::get_singleton()->get_tracker(p_tracker_name));
+	}
+}
+
+void OpenXRFbSceneManager::_on_anchor_pose_changed(const Ref<XRPose> &p_pose, int32_t p_bvh_item) {
+	if (p_pose->get_name() != StringName("default") || p_pose->get_tracking_confidence() == XRPose::XR_TRACKING_CONFIDENCE_NONE) {
+		return;
+	}
+
+	// Adjusted for the world scale, to match the anchor node's transform.
+	anchor_bvh.set_item_transform(p_bvh_item, p_pose->get_adjusted_transform());
+}
+
 Ref<PackedScene> OpenXRFbSceneManager::get_scene_for_entity(const Ref<OpenXRFbSpatialEntity> &p_entity) const {
-	PackedStringArray semantic_labels = p_entity->get_semantic_labels();
+	uint32_t label_mask = int64_t(p_entity->get_semantic_label_mask()) & scene_label_mask;
+	if (label_mask == 0) {
+		return default_scene;
+	}
 
-	// @todo Allow developers to override which label is selected.
-	String selected_label = semantic_labels.size() > 0 ? semantic_labels[0] : String();
+	// Prefer the first label given by the runtime, otherwise fall back on any
+	// other label of the entity that has a scene.
+	int label = p_entity->get_primary_semantic_label();
+	if (label < 0 || (label_mask & (1u << label)) == 0) {
+		label = 0;
+		while ((label_mask & (1u << label)) == 0) {
+			label++;
+		}
+	}
+
+	return scenes[label];
+}
 
-	if (!selected_label.is_empty() && scenes.has(selected_label)) {
-		return scenes[selected_label];
+void OpenXRFbSceneManager::_free_anchor(Anchor &p_anchor) {
+	Node3D *node = Object::cast_to<Node3D>(ObjectDB::get_instance(p_anchor.node));
+	if (node) {
+		Node *parent = node->get_parent();
+		if (parent) {
+			parent->remove_child(node);
+		}
+		node->queue_free();
 	}
 
-	return default_scene;
+	if (p_anchor.tracker.is_valid()) {
+		p_anchor.tracker->disconnect("pose_changed", callable_mp(this, &OpenXRFbSceneManager::_on_anchor_pose_changed).bind(p_anchor.bvh_item));
+	}
+
+	if (!p_anchor.entity->is_cached()) {
+		p_anchor.entity->untrack();
+	}
+}
+
+void OpenXRFbSceneManager::_remove_scene_anchor(const XrUuidEXT &p_uuid) {
+	Anchor *anchor = anchors.getptr(p_uuid);
+	ERR_FAIL_NULL(anchor);
+
+	_free_anchor(*anchor);
+	if (anchor->bvh_item >= 0) {
+		anchor_bvh.remove_item(anchor->bvh_item);
+	}
+	anchors.erase(p_uuid);
 }
 
 void OpenXRFbSceneManager::remove_scene_anchors() {
 	ERR_FAIL_COND(!anchors_created);
 
-	for (KeyValue<StringName, Anchor> &E : anchors) {
-		Node3D *node = Object::cast_to<Node3D>(ObjectDB::get_instance(E.value.node));
-		if (node) {
-			Node *parent = node->get_parent();
-			if (parent) {
-				parent->remove_child(node);
-			}
-			node->queue_free();
-		}
+	if (!scene_cache_path.is_empty() && !capturing_scene_snapshot) {
+		_save_scene_cache();
+	}
 
-		E.value.entity->untrack();
+	for (KeyValue<XrUuidEXT, Anchor> &E : anchors) {
+		_free_anchor(E.value);
 	}
 	anchors.clear();
+	anchor_bvh.clear();
+	_clear_pending_work();
+
+	has_scene_room = false;
+	scene_snapshot.clear();
+	capturing_scene_snapshot = false;
 
 	anchors_created = false;
 }
@@ -361,14 +872,24 @@ void OpenXRFbSceneManager::_scene_capture_callback(XrResult p_result, void *p_us
 	memdelete(userdata);
 }
 
-Array OpenXRFbSceneManager::get_anchor_uuids() const {
+Array OpenXRFbSceneManager::get_anchor_uuids(BitField<OpenXRFbSpatialEntity::SemanticLabelFlags> p_label_mask) const {
 	ERR_FAIL_COND_V(!anchors_created, Array());
 
+	if (p_label_mask == 0) {
+		Array ret;
+		ret.resize(anchors.size());
+		int i = 0;
+		for (const KeyValue<XrUuidEXT, Anchor> &E : anchors) {
+			ret[i++] = OpenXRUtilities::uuid_to_string_name(E.key);
+		}
+		return ret;
+	}
+
 	Array ret;
-	ret.resize(anchors.size());
-	int i = 0;
-	for (const KeyValue<StringName, Anchor> &E : anchors) {
-		ret[i++] = E.key;
+	for (const KeyValue<XrUuidEXT, Anchor> &E : anchors) {
+		if (E.value.entity->has_semantic_label(p_label_mask)) {
+			ret.push_back(OpenXRUtilities::uuid_to_string_name(E.key));
+		}
 	}
 	return ret;
 }
@@ -376,7 +897,8 @@ Array OpenXRFbSceneManager::get_anchor_uuids() const {
 XRAnchor3D *OpenXRFbSceneManager::get_anchor_node(const StringName &p_uuid) const {
 	ERR_FAIL_COND_V(!anchors_created, nullptr);
 
-	const Anchor *anchor = anchors.getptr(p_uuid);
+	XrUuidEXT uuid;
+	const Anchor *anchor = OpenXRUtilities::string_to_uuid(p_uuid, uuid) ? anchors.getptr(uuid) : nullptr;
 	if (anchor) {
 		return Object::cast_to<XRAnchor3D>(ObjectDB::get_instance(anchor->node));
 	}
@@ -387,10 +909,85 @@ XRAnchor3D *OpenXRFbSceneManager::get_anchor_node(const StringName &p_uuid) cons
 Ref<OpenXRFbSpatialEntity> OpenXRFbSceneManager::get_spatial_entity(const StringName &p_uuid) const {
 	ERR_FAIL_COND_V(!anchors_created, nullptr);
 
-	const Anchor *anchor = anchors.getptr(p_uuid);
+	XrUuidEXT uuid;
+	const Anchor *anchor = OpenXRUtilities::string_to_uuid(p_uuid, uuid) ? anchors.getptr(uuid) : nullptr;
 	if (anchor) {
 		return anchor->entity;
 	}
 
 	return Ref<OpenXRFbSpatialEntity>();
 }
+
+Dictionary OpenXRFbSceneManager::_make_anchor_result(int32_t p_bvh_item) const {
+	const XrUuidEXT &uuid = anchor_bvh.get_item_uuid(p_bvh_item);
+
+	Dictionary result;
+	result["uuid"] = OpenXRUtilities::uuid_to_string_name(uuid);
+
+	const Anchor *anchor = anchors.getptr(uuid);
+	result["anchor_node"] = anchor ? ObjectDB::get_instance(anchor->node) : nullptr;
+
+	return result;
+}
+
+Dictionary OpenXRFbSceneManager::raycast_anchors(const Vector3 &p_from, const Vector3 &p_to, BitField<OpenXRFbSpatialEntity::SemanticLabelFlags> p_label_mask) {
+	ERR_FAIL_COND_V(!anchors_created, Dictionary());
+	ERR_FAIL_NULL_V(xr_origin, Dictionary());
+
+	// The anchors are kept in the space of the XROrigin3D.
+	const Transform3D origin_transform = xr_origin->get_global_transform();
+	const Transform3D inverse_origin_transform = origin_transform.affine_inverse();
+
+	const Vector3 from = inverse_origin_transform.xform(p_from);
+	const Vector3 ray = inverse_origin_transform.xform(p_to) - from;
+	const float length = ray.length();
+	if (length == 0.0) {
+		return Dictionary();
+	}
+
+	SceneAnchorBVH::RayHit hit;
+	if (!anchor_bvh.raycast(from, ray / length, length, int64_t(p_label_mask), hit)) {
+		return Dictionary();
+	}
+
+	Dictionary result = _make_anchor_result(hit.item);
+	result["position"] = origin_transform.xform(hit.position);
+	result["normal"] = origin_transform.basis.xform(hit.normal).normalized();
+	result["distance"] = p_from.distance_to(result["position"]);
+	return result;
+}
+
+Array OpenXRFbSceneManager::get_anchors_in_sphere(const Vector3 &p_center, float p_radius, BitField<OpenXRFbSpatialEntity::SemanticLabelFlags> p_label_mask) {
+	ERR_FAIL_COND_V(!anchors_created, Array());
+	ERR_FAIL_NULL_V(xr_origin, Array());
+
+	// Assumes the XROrigin3D isn't scaled.
+	const Vector3 center = xr_origin->get_global_transform().affine_inverse().xform(p_center);
+
+	LocalVector<int32_t> items;
+	anchor_bvh.sphere_overlap(center, p_radius, int64_t(p_label_mask), items);
+
+	Array ret;
+	ret.resize(items.size());
+	for (uint32_t i = 0; i < items.size(); i++) {
+		ret[i] = OpenXRUtilities::uuid_to_string_name(anchor_bvh.get_item_uuid(items[i]));
+	}
+	return ret;
+}
+
+Array OpenXRFbSceneManager::get_nearest_anchors(const Vector3 &p_point, int p_count, BitField<OpenXRFbSpatialEntity::SemanticLabelFlags> p_label_mask) {
+	ERR_FAIL_COND_V(!anchors_created, Array());
+	ERR_FAIL_NULL_V(xr_origin, Array());
+
+	const Vector3 point = xr_origin->get_global_transform().affine_inverse().xform(p_point);
+
+	LocalVector<int32_t> items;
+	anchor_bvh.nearest(point, p_count, int64_t(p_label_mask), items);
+
+	Array ret;
+	ret.resize(items.size());
+	for (uint32_t i = 0; i < items.size(); i++) {
+		ret[i] = OpenXRUtilities::uuid_to_string_name(anchor_bvh.get_item_uuid(items[i]));
+	}
+	return ret;
+}
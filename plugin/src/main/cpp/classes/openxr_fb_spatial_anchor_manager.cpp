@@ -32,14 +32,18 @@
 #include <godot_cpp/classes/open_xr_interface.hpp>
 #include <godot_cpp/classes/open_xrapi_extension.hpp>
 #include <godot_cpp/classes/packed_scene.hpp>
+#include <godot_cpp/classes/resource_loader.hpp>
 #include <godot_cpp/classes/xr_anchor3d.hpp>
 #include <godot_cpp/classes/xr_origin3d.hpp>
 #include <godot_cpp/classes/xr_server.hpp>
 
 #include <godot_cpp/variant/utility_functions.hpp>
 
+#include "classes/openxr_fb_spatial_entity_batch.h"
 #include "classes/openxr_fb_spatial_entity_query.h"
 #include "extensions/openxr_fb_spatial_entity_extension_wrapper.h"
+#include "extensions/openxr_fb_spatial_entity_storage_batch_extension_wrapper.h"
+#include "util.h"
 
 using namespace godot;
 
@@ -55,25 +59,36 @@ void OpenXRFbSpatialAnchorManager::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("show"), &OpenXRFbSpatialAnchorManager::show);
 	ClassDB::bind_method(D_METHOD("hide"), &OpenXRFbSpatialAnchorManager::hide);
 
+	ClassDB::bind_method(D_METHOD("set_batch_storage_saves", "enable"), &OpenXRFbSpatialAnchorManager::set_batch_storage_saves);
+	ClassDB::bind_method(D_METHOD("get_batch_storage_saves"), &OpenXRFbSpatialAnchorManager::get_batch_storage_saves);
+
+	ClassDB::bind_method(D_METHOD("set_anchor_index_path", "path"), &OpenXRFbSpatialAnchorManager::set_anchor_index_path);
+	ClassDB::bind_method(D_METHOD("get_anchor_index_path"), &OpenXRFbSpatialAnchorManager::get_anchor_index_path);
+
 	ClassDB::bind_method(D_METHOD("create_anchor", "transform", "custom_data"), &OpenXRFbSpatialAnchorManager::create_anchor, DEFVAL(Dictionary()));
 	ClassDB::bind_method(D_METHOD("load_anchor", "uuid", "custom_data", "location"), &OpenXRFbSpatialAnchorManager::load_anchor, DEFVAL(Dictionary()), DEFVAL(OpenXRFbSpatialEntity::STORAGE_LOCAL));
 	ClassDB::bind_method(D_METHOD("load_anchors", "uuids", "all_custom_data", "location", "erase_unknown_anchors"), &OpenXRFbSpatialAnchorManager::load_anchors, DEFVAL(Dictionary()), DEFVAL(OpenXRFbSpatialEntity::STORAGE_LOCAL), DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("load_indexed_anchors", "location", "erase_unknown_anchors"), &OpenXRFbSpatialAnchorManager::load_indexed_anchors, DEFVAL(OpenXRFbSpatialEntity::STORAGE_LOCAL), DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("track_anchor", "spatial_entity"), &OpenXRFbSpatialAnchorManager::track_anchor);
 	ClassDB::bind_method(D_METHOD("untrack_anchor", "spatial_entity_or_uuid"), &OpenXRFbSpatialAnchorManager::untrack_anchor);
 
 	ClassDB::bind_method(D_METHOD("get_anchor_uuids"), &OpenXRFbSpatialAnchorManager::get_anchor_uuids);
 	ClassDB::bind_method(D_METHOD("get_anchor_node", "uuid"), &OpenXRFbSpatialAnchorManager::get_anchor_node);
 	ClassDB::bind_method(D_METHOD("get_spatial_entity", "uuid"), &OpenXRFbSpatialAnchorManager::get_spatial_entity);
+	ClassDB::bind_method(D_METHOD("get_indexed_anchor_uuids"), &OpenXRFbSpatialAnchorManager::get_indexed_anchor_uuids);
 
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "scene", PROPERTY_HINT_RESOURCE_TYPE, "PackedScene"), "set_scene", "get_scene");
 	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "scene_setup_method", PROPERTY_HINT_NONE, ""), "set_scene_setup_method", "get_scene_setup_method");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "visible", PROPERTY_HINT_NONE, ""), "set_visible", "get_visible");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "batch_storage_saves", PROPERTY_HINT_NONE, ""), "set_batch_storage_saves", "get_batch_storage_saves");
+	ADD_PROPERTY(PropertyInfo(Variant::STRING, "anchor_index_path", PROPERTY_HINT_FILE, ""), "set_anchor_index_path", "get_anchor_index_path");
 
 	ADD_SIGNAL(MethodInfo("openxr_fb_spatial_anchor_tracked", PropertyInfo(Variant::Type::OBJECT, "anchor_node"), PropertyInfo(Variant::Type::OBJECT, "spatial_entity"), PropertyInfo(Variant::Type::BOOL, "is_new")));
 	ADD_SIGNAL(MethodInfo("openxr_fb_spatial_anchor_untracked", PropertyInfo(Variant::Type::OBJECT, "anchor_node"), PropertyInfo(Variant::Type::OBJECT, "spatial_entity")));
 	ADD_SIGNAL(MethodInfo("openxr_fb_spatial_anchor_create_failed", PropertyInfo(Variant::Type::TRANSFORM3D, "transform"), PropertyInfo(Variant::Type::DICTIONARY, "custom_data")));
 	ADD_SIGNAL(MethodInfo("openxr_fb_spatial_anchor_load_failed", PropertyInfo(Variant::Type::STRING_NAME, "uuid"), PropertyInfo(Variant::Type::DICTIONARY, "custom_data"), PropertyInfo(Variant::Type::INT, "location")));
 	ADD_SIGNAL(MethodInfo("openxr_fb_spatial_anchor_track_failed", PropertyInfo(Variant::Type::OBJECT, "spatial_entity")));
+	ADD_SIGNAL(MethodInfo("openxr_fb_spatial_anchor_restored", PropertyInfo(Variant::Type::OBJECT, "anchor_node"), PropertyInfo(Variant::Type::STRING_NAME, "uuid"), PropertyInfo(Variant::Type::DICTIONARY, "custom_data")));
 }
 
 void OpenXRFbSpatialAnchorManager::_notification(int p_what) {
@@ -92,19 +107,26 @@ void OpenXRFbSpatialAnchorManager::_notification(int p_what) {
 				openxr_interface->disconnect("session_stopping", callable_mp(this, &OpenXRFbSpatialAnchorManager::_on_openxr_session_stopping));
 			}
 
+			_flush_anchor_index();
+
 			xr_origin = nullptr;
 			_cleanup_anchors();
 		} break;
+		case NOTIFICATION_APPLICATION_PAUSED:
+		case NOTIFICATION_WM_CLOSE_REQUEST: {
+			_flush_anchor_index();
+		} break;
 	}
 }
 
 void OpenXRFbSpatialAnchorManager::_on_openxr_session_stopping() {
+	_flush_anchor_index();
 	_cleanup_anchors();
 }
 
 // Removes anchor nodes and clears the anchor list - but doesn't change the local file.
 void OpenXRFbSpatialAnchorManager::_cleanup_anchors() {
-	for (KeyValue<StringName, Anchor> &E : anchors) {
+	for (KeyValue<XrUuidEXT, Anchor> &E : anchors) {
 		Node3D *node = Object::cast_to<Node3D>(ObjectDB::get_instance(E.value.node));
 		if (node) {
 			Node *parent = node->get_parent();
@@ -114,9 +136,12 @@ void OpenXRFbSpatialAnchorManager::_cleanup_anchors() {
 			node->queue_free();
 		}
 
-		E.value.entity->untrack();
+		if (E.value.entity.is_valid()) {
+			E.value.entity->untrack();
+		}
 	}
 	anchors.clear();
+	pending_saves.clear();
 }
 
 PackedStringArray OpenXRFbSpatialAnchorManager::_get_configuration_warnings() const {
@@ -151,9 +176,9 @@ StringName OpenXRFbSpatialAnchorManager::get_scene_setup_method() const {
 void OpenXRFbSpatialAnchorManager::set_visible(bool p_visible) {
 	visible = p_visible;
 
-	for (KeyValue<StringName, Anchor> &E : anchors) {
+	for (KeyValue<XrUuidEXT, Anchor> &E : anchors) {
 		Node3D *node = Object::cast_to<Node3D>(ObjectDB::get_instance(E.value.node));
-		ERR_CONTINUE_MSG(!node, vformat("Cannot find node for anchor %s.", E.key));
+		ERR_CONTINUE_MSG(!node, vformat("Cannot find node for anchor %s.", OpenXRUtilities::uuid_to_string_name(E.key)));
 		if (node) {
 			node->set_visible(p_visible);
 		}
@@ -172,6 +197,121 @@ void OpenXRFbSpatialAnchorManager::hide() {
 	set_visible(false);
 }
 
+void OpenXRFbSpatialAnchorManager::set_batch_storage_saves(bool p_enable) {
+	batch_storage_saves = p_enable;
+}
+
+bool OpenXRFbSpatialAnchorManager::get_batch_storage_saves() const {
+	return batch_storage_saves;
+}
+
+void OpenXRFbSpatialAnchorManager::set_anchor_index_path(const String &p_path) {
+	if (p_path == anchor_index_path) {
+		return;
+	}
+
+	if (!anchor_index_path.is_empty() && anchor_index.is_dirty()) {
+		_update_anchor_index_poses();
+		anchor_index.flush();
+	}
+
+	anchor_index_path = p_path;
+	if (anchor_index_path.is_empty()) {
+		anchor_index.clear();
+	} else {
+		anchor_index.load(anchor_index_path);
+	}
+}
+
+String OpenXRFbSpatialAnchorManager::get_anchor_index_path() const {
+	return anchor_index_path;
+}
+
+void OpenXRFbSpatialAnchorManager::_update_anchor_index_poses() {
+	for (const KeyValue<XrUuidEXT, Anchor> &E : anchors) {
+		XRAnchor3D *node = Object::cast_to<XRAnchor3D>(ObjectDB::get_instance(E.value.node));
+		if (node && E.value.entity.is_valid() && node->get_has_tracking_data()) {
+			anchor_index.set_pose(E.key, node->get_transform());
+		}
+	}
+}
+
+void OpenXRFbSpatialAnchorManager::_queue_anchor_index_flush() {
+	if (!anchor_index_flush_queued) {
+		anchor_index_flush_queued = true;
+		callable_mp(this, &OpenXRFbSpatialAnchorManager::_flush_anchor_index).call_deferred();
+	}
+}
+
+void OpenXRFbSpatialAnchorManager::_flush_anchor_index() {
+	anchor_index_flush_queued = false;
+	if (anchor_index_path.is_empty()) {
+		return;
+	}
+
+	_update_anchor_index_poses();
+	anchor_index.flush();
+}
+
+Node *OpenXRFbSpatialAnchorManager::_instantiate_anchor_scene(XRAnchor3D *p_node, const String &p_scene_path) {
+	Ref<PackedScene> anchor_scene = scene;
+	if (anchor_scene.is_null() && !p_scene_path.is_empty()) {
+		anchor_scene = ResourceLoader::get_singleton()->load(p_scene_path, "PackedScene");
+	}
+
+	if (anchor_scene.is_null()) {
+		return nullptr;
+	}
+
+	Node *scene_node = anchor_scene->instantiate();
+	p_node->add_child(scene_node);
+	return scene_node;
+}
+
+void OpenXRFbSpatialAnchorManager::_restore_indexed_anchor(const XrUuidEXT &p_uuid) {
+	const SpatialAnchorIndex::Record *record = anchor_index.get_record(p_uuid);
+	if (!record || anchors.has(p_uuid)) {
+		return;
+	}
+
+	const StringName uuid_name = OpenXRUtilities::uuid_to_string_name(p_uuid);
+
+	// Place the anchor at its last known pose, until the runtime has loaded it.
+	XRAnchor3D *node = memnew(XRAnchor3D);
+	node->set_name(uuid_name);
+	node->set_tracker(uuid_name);
+	node->set_visible(visible);
+	node->set_transform(record->pose);
+	xr_origin->add_child(node);
+
+	Node *scene_node = _instantiate_anchor_scene(node, record->scene_path);
+	anchors[p_uuid] = Anchor(node, scene_node, Ref<OpenXRFbSpatialEntity>());
+
+	emit_signal("openxr_fb_spatial_anchor_restored", node, uuid_name, record->custom_data);
+}
+
+void OpenXRFbSpatialAnchorManager::_remove_restored_anchor(const XrUuidEXT &p_uuid, bool p_erase_record) {
+	Anchor *anchor = anchors.getptr(p_uuid);
+	if (!anchor || anchor->entity.is_valid()) {
+		return;
+	}
+
+	Node3D *node = Object::cast_to<Node3D>(ObjectDB::get_instance(anchor->node));
+	if (node) {
+		Node *parent = node->get_parent();
+		if (parent) {
+			parent->remove_child(node);
+		}
+		node->queue_free();
+	}
+	anchors.erase(p_uuid);
+
+	if (p_erase_record) {
+		anchor_index.erase_record(p_uuid);
+		_queue_anchor_index_flush();
+	}
+}
+
 void OpenXRFbSpatialAnchorManager::create_anchor(const Transform3D &p_transform, const Dictionary &p_custom_data) {
 	ERR_FAIL_COND(!xr_origin);
 
@@ -204,10 +344,21 @@ void OpenXRFbSpatialAnchorManager::load_anchor(const StringName &p_uuid, const D
 	Dictionary data;
 	data[p_uuid] = p_custom_data;
 
+	XrUuidEXT uuid;
+	const SpatialAnchorIndex::Record *record = OpenXRUtilities::string_to_uuid(p_uuid, uuid) ? anchor_index.get_record(uuid) : nullptr;
+	if (record) {
+		if (p_custom_data.is_empty()) {
+			data[p_uuid] = record->custom_data;
+		}
+		_restore_indexed_anchor(uuid);
+	}
+
 	Ref<OpenXRFbSpatialEntityQuery> query;
 	query.instantiate();
 	query->query_by_uuid(uuids, p_location);
-	query->connect("openxr_fb_spatial_entity_query_completed", callable_mp(this, &OpenXRFbSpatialAnchorManager::_on_anchor_load_query_completed).bind(data, p_location, false));
+	query->set_stream_results(true);
+	query->connect("openxr_fb_spatial_entity_query_results_available", callable_mp(this, &OpenXRFbSpatialAnchorManager::_on_anchor_load_query_results).bind(data, false));
+	query->connect("openxr_fb_spatial_entity_query_completed", callable_mp(this, &OpenXRFbSpatialAnchorManager::_on_anchor_load_query_completed).bind(data, p_location, query->get_instance_id()));
 	query->execute();
 }
 
@@ -233,15 +384,33 @@ void OpenXRFbSpatialAnchorManager::load_anchors(const TypedArray<StringName> &p_
 		// Otherwise, we just query the specific anchors we know about.
 		query->query_by_uuid(p_uuids, p_location);
 		query->set_max_results(p_uuids.size());
-		all_custom_data = p_all_custom_data;
+		all_custom_data = p_all_custom_data.duplicate();
+	}
+
+	// Restore indexed anchors right away, rather than waiting for the query.
+	for (int i = 0; i < p_uuids.size(); i++) {
+		XrUuidEXT uuid;
+		const SpatialAnchorIndex::Record *record = OpenXRUtilities::string_to_uuid(p_uuids[i], uuid) ? anchor_index.get_record(uuid) : nullptr;
+		if (record) {
+			if (!p_all_custom_data.has(p_uuids[i])) {
+				all_custom_data[p_uuids[i]] = record->custom_data;
+			}
+			_restore_indexed_anchor(uuid);
+		}
 	}
 
-	query->connect("openxr_fb_spatial_entity_query_completed", callable_mp(this, &OpenXRFbSpatialAnchorManager::_on_anchor_load_query_completed).bind(all_custom_data, p_location, p_erase_unknown_anchors));
+	// Set up anchors as each page of results arrives. Both handlers share the custom data
+	// dictionary, so anchors that are found are removed from it, and any that remain once
+	// the query is complete have failed to load.
+	query->set_stream_results(true);
+	query->connect("openxr_fb_spatial_entity_query_results_available", callable_mp(this, &OpenXRFbSpatialAnchorManager::_on_anchor_load_query_results).bind(all_custom_data, p_erase_unknown_anchors));
+	query->connect("openxr_fb_spatial_entity_query_completed", callable_mp(this, &OpenXRFbSpatialAnchorManager::_on_anchor_load_query_completed).bind(all_custom_data, p_location, query->get_instance_id()));
 	query->execute();
 }
 
-void OpenXRFbSpatialAnchorManager::_on_anchor_load_query_completed(const Array &p_results, const Dictionary &p_anchors_custom_data, OpenXRFbSpatialEntity::StorageLocation p_location, bool p_erase_unknown_anchors) {
-	Dictionary anchors_custom_data = p_anchors_custom_data.duplicate();
+void OpenXRFbSpatialAnchorManager::_on_anchor_load_query_results(const Array &p_results, const Dictionary &p_anchors_custom_data, bool p_erase_unknown_anchors) {
+	// Shares the dictionary with _on_anchor_load_query_completed().
+	Dictionary anchors_custom_data = p_anchors_custom_data;
 	for (int i = 0; i < p_results.size(); i++) {
 		Ref<OpenXRFbSpatialEntity> spatial_entity = p_results[i];
 		if (spatial_entity.is_valid()) {
@@ -256,12 +425,41 @@ void OpenXRFbSpatialAnchorManager::_on_anchor_load_query_completed(const Array &
 			}
 		}
 	}
+}
 
-	Array failed_uuids = anchors_custom_data.keys();
+void OpenXRFbSpatialAnchorManager::_on_anchor_load_query_completed(const Array &p_results, const Dictionary &p_anchors_custom_data, OpenXRFbSpatialEntity::StorageLocation p_location, uint64_t p_query_id) {
+	// Only a query that actually ran tells us that an anchor no longer exists. If it failed, the
+	// anchors are reported as failed to load, but are kept in the index so they can be tried again.
+	OpenXRFbSpatialEntityQuery *query = Object::cast_to<OpenXRFbSpatialEntityQuery>(ObjectDB::get_instance(p_query_id));
+	bool query_succeeded = query && query->is_successful();
+
+	// Anchors still in the dictionary weren't in any page of results.
+	Array failed_uuids = p_anchors_custom_data.keys();
 	for (int i = 0; i < failed_uuids.size(); i++) {
 		StringName uuid = failed_uuids[i];
-		emit_signal("openxr_fb_spatial_anchor_load_failed", uuid, anchors_custom_data[uuid], p_location);
+		XrUuidEXT xr_uuid;
+		if (OpenXRUtilities::string_to_uuid(uuid, xr_uuid)) {
+			_remove_restored_anchor(xr_uuid, query_succeeded);
+		}
+		emit_signal("openxr_fb_spatial_anchor_load_failed", uuid, p_anchors_custom_data[uuid], p_location);
+	}
+}
+
+void OpenXRFbSpatialAnchorManager::load_indexed_anchors(OpenXRFbSpatialEntity::StorageLocation p_location, bool p_erase_unknown_anchors) {
+	ERR_FAIL_COND(!xr_origin);
+
+	Dictionary all_custom_data = anchor_index.get_all_custom_data();
+	TypedArray<StringName> uuids;
+	Array indexed_uuids = all_custom_data.keys();
+	for (int i = 0; i < indexed_uuids.size(); i++) {
+		uuids.push_back(indexed_uuids[i]);
+	}
+
+	if (uuids.is_empty() && !p_erase_unknown_anchors) {
+		return;
 	}
+
+	load_anchors(uuids, all_custom_data, p_location, p_erase_unknown_anchors);
 }
 
 void OpenXRFbSpatialAnchorManager::track_anchor(const Ref<OpenXRFbSpatialEntity> &p_spatial_entity) {
@@ -278,8 +476,19 @@ void OpenXRFbSpatialAnchorManager::_track_anchor(const Ref<OpenXRFbSpatialEntity
 	}
 }
 
+void OpenXRFbSpatialAnchorManager::_on_anchor_track_failed(const Ref<OpenXRFbSpatialEntity> &p_spatial_entity) {
+	// An anchor restored from the index is still waiting for its entity, so take down its node;
+	// the record is kept, since the anchor itself was found.
+	_remove_restored_anchor(p_spatial_entity->get_xr_uuid(), false);
+	emit_signal("openxr_fb_spatial_anchor_track_failed", p_spatial_entity);
+}
+
 void OpenXRFbSpatialAnchorManager::_on_anchor_track_enable_locatable_completed(bool p_succeeded, OpenXRFbSpatialEntity::ComponentType p_component, bool p_enabled, const Ref<OpenXRFbSpatialEntity> &p_spatial_entity, bool p_new_anchor) {
-	ERR_FAIL_COND_MSG(!p_succeeded, vformat("Unable to make spatial anchor %s locatable.", p_spatial_entity->get_uuid()));
+	if (!p_succeeded) {
+		ERR_PRINT(vformat("Unable to make spatial anchor %s locatable.", p_spatial_entity->get_uuid()));
+		_on_anchor_track_failed(p_spatial_entity);
+		return;
+	}
 
 	if (p_spatial_entity->is_component_enabled(OpenXRFbSpatialEntity::COMPONENT_TYPE_STORABLE)) {
 		_on_anchor_track_enable_storable_completed(true, OpenXRFbSpatialEntity::COMPONENT_TYPE_STORABLE, true, p_spatial_entity, p_new_anchor);
@@ -290,55 +499,133 @@ void OpenXRFbSpatialAnchorManager::_on_anchor_track_enable_locatable_completed(b
 }
 
 void OpenXRFbSpatialAnchorManager::_on_anchor_track_enable_storable_completed(bool p_succeeded, OpenXRFbSpatialEntity::ComponentType p_component, bool p_enabled, const Ref<OpenXRFbSpatialEntity> &p_spatial_entity, bool p_new_anchor) {
-	ERR_FAIL_COND_MSG(!p_succeeded, vformat("Unable to make spatial anchor %s storable.", p_spatial_entity->get_uuid()));
+	if (!p_succeeded) {
+		ERR_PRINT(vformat("Unable to make spatial anchor %s storable.", p_spatial_entity->get_uuid()));
+		_on_anchor_track_failed(p_spatial_entity);
+		return;
+	}
+
+	if (batch_storage_saves && OpenXRFbSpatialEntityStorageBatchExtensionWrapper::get_singleton()->is_spatial_entity_storage_batch_supported()) {
+		_queue_anchor_save(p_spatial_entity, p_new_anchor);
+		return;
+	}
 
 	p_spatial_entity->connect("openxr_fb_spatial_entity_saved", callable_mp(this, &OpenXRFbSpatialAnchorManager::_on_anchor_saved).bind(p_spatial_entity, p_new_anchor), CONNECT_ONE_SHOT);
 	p_spatial_entity->save_to_storage(OpenXRFbSpatialEntity::STORAGE_LOCAL);
 }
 
 void OpenXRFbSpatialAnchorManager::_on_anchor_saved(bool p_succeeded, OpenXRFbSpatialEntity::StorageLocation p_location, const Ref<OpenXRFbSpatialEntity> &p_spatial_entity, bool p_new_anchor) {
-	ERR_FAIL_COND_MSG(!p_succeeded, vformat("Unable to save spatial anchor %s to local storage.", p_spatial_entity->get_uuid()));
+	if (!p_succeeded) {
+		ERR_PRINT(vformat("Unable to save spatial anchor %s to local storage.", p_spatial_entity->get_uuid()));
+		_on_anchor_track_failed(p_spatial_entity);
+		return;
+	}
 	_complete_anchor_setup(p_spatial_entity, p_new_anchor);
 }
 
+void OpenXRFbSpatialAnchorManager::_queue_anchor_save(const Ref<OpenXRFbSpatialEntity> &p_spatial_entity, bool p_new_anchor) {
+	pending_saves.push_back(PendingSave(p_spatial_entity, p_new_anchor));
+
+	// All anchors that become storable before the end of this frame are saved together.
+	if (!pending_saves_flush_queued) {
+		pending_saves_flush_queued = true;
+		callable_mp(this, &OpenXRFbSpatialAnchorManager::_flush_anchor_saves).call_deferred();
+	}
+}
+
+void OpenXRFbSpatialAnchorManager::_flush_anchor_saves() {
+	pending_saves_flush_queued = false;
+	if (pending_saves.is_empty()) {
+		return;
+	}
+
+	TypedArray<OpenXRFbSpatialEntity> entities;
+	Array new_anchors;
+	entities.resize(pending_saves.size());
+	new_anchors.resize(pending_saves.size());
+	for (uint32_t i = 0; i < pending_saves.size(); i++) {
+		entities[i] = pending_saves[i].entity;
+		new_anchors[i] = pending_saves[i].new_anchor;
+	}
+	pending_saves.clear();
+
+	Ref<OpenXRFbSpatialEntityBatch> batch = OpenXRFbSpatialEntityBatch::create_batch(entities);
+	batch->connect("openxr_fb_spatial_entity_batch_saved", callable_mp(this, &OpenXRFbSpatialAnchorManager::_on_anchor_batch_saved).bind(entities, new_anchors), CONNECT_ONE_SHOT);
+	batch->save_to_storage(OpenXRFbSpatialEntity::STORAGE_LOCAL);
+}
+
+void OpenXRFbSpatialAnchorManager::_on_anchor_batch_saved(bool p_succeeded, OpenXRFbSpatialEntity::StorageLocation p_location, const Array &p_spatial_entities, const Array &p_new_anchors) {
+	for (int i = 0; i < p_spatial_entities.size(); i++) {
+		Ref<OpenXRFbSpatialEntity> spatial_entity = p_spatial_entities[i];
+		if (p_succeeded) {
+			_complete_anchor_setup(spatial_entity, p_new_anchors[i]);
+		} else {
+			ERR_PRINT(vformat("Unable to save spatial anchor %s to local storage.", spatial_entity->get_uuid()));
+			_on_anchor_track_failed(spatial_entity);
+		}
+	}
+}
+
 void OpenXRFbSpatialAnchorManager::_complete_anchor_setup(const Ref<OpenXRFbSpatialEntity> &p_entity, bool p_new_anchor) {
 	ERR_FAIL_COND(!xr_origin);
-	ERR_FAIL_COND(anchors.has(p_entity->get_uuid()));
+
+	const XrUuidEXT &uuid = p_entity->get_xr_uuid();
+	XRAnchor3D *node = nullptr;
+	Node *scene_node = nullptr;
+
+	Anchor *restored = anchors.getptr(uuid);
+	if (restored) {
+		ERR_FAIL_COND(restored->entity.is_valid());
+		node = Object::cast_to<XRAnchor3D>(ObjectDB::get_instance(restored->node));
+		if (node) {
+			scene_node = Object::cast_to<Node>(ObjectDB::get_instance(restored->scene_node));
+			restored->entity = p_entity;
+		} else {
+			anchors.erase(uuid);
+		}
+	}
 
 	p_entity->track();
 
-	XRAnchor3D *node = memnew(XRAnchor3D);
-	node->set_name(p_entity->get_uuid());
-	node->set_tracker(p_entity->get_uuid());
-	node->set_visible(visible);
-	xr_origin->add_child(node);
+	if (!node) {
+		node = memnew(XRAnchor3D);
+		node->set_name(p_entity->get_uuid());
+		node->set_tracker(p_entity->get_uuid());
+		node->set_visible(visible);
+		xr_origin->add_child(node);
 
-	anchors[p_entity->get_uuid()] = Anchor(node, p_entity);
+		scene_node = _instantiate_anchor_scene(node, String());
+		anchors[uuid] = Anchor(node, scene_node, p_entity);
+	}
 
-	if (scene.is_valid()) {
-		Node *scene_node = scene->instantiate();
-		node->add_child(scene_node);
+	if (scene_node) {
 		scene_node->call(scene_setup_method, p_entity);
 	}
 
+	if (!anchor_index_path.is_empty()) {
+		anchor_index.set_record(uuid, node->get_transform(), scene.is_valid() ? scene->get_path() : String(), p_entity->get_custom_data());
+		_queue_anchor_index_flush();
+	}
+
 	emit_signal("openxr_fb_spatial_anchor_tracked", node, p_entity, p_new_anchor);
 }
 
 void OpenXRFbSpatialAnchorManager::untrack_anchor(const Variant &p_spatial_entity_or_uuid) {
-	StringName uuid;
+	XrUuidEXT uuid;
 
 	if (p_spatial_entity_or_uuid.get_type() == Variant::OBJECT) {
 		Ref<OpenXRFbSpatialEntity> spatial_entity = p_spatial_entity_or_uuid;
 		ERR_FAIL_COND(spatial_entity.is_null());
-		uuid = spatial_entity->get_uuid();
+		uuid = spatial_entity->get_xr_uuid();
 	} else if (p_spatial_entity_or_uuid.get_type() == Variant::STRING || p_spatial_entity_or_uuid.get_type() == Variant::STRING_NAME) {
-		uuid = p_spatial_entity_or_uuid;
+		ERR_FAIL_COND_MSG(!OpenXRUtilities::string_to_uuid(p_spatial_entity_or_uuid, uuid), vformat("Invalid UUID: %s", p_spatial_entity_or_uuid));
 	} else {
 		ERR_FAIL_MSG("Invalid argument passed to OpenXRFbSpatialAnchorManager::untrack_anchor().");
 	}
 
 	Anchor *anchor = anchors.getptr(uuid);
 	ERR_FAIL_COND(!anchor);
+	ERR_FAIL_COND_MSG(anchor->entity.is_null(), vformat("Cannot untrack spatial anchor %s until it has been loaded.", OpenXRUtilities::uuid_to_string_name(uuid)));
 
 	Node3D *node = Object::cast_to<Node3D>(ObjectDB::get_instance(anchor->node));
 	if (node) {
@@ -360,6 +647,11 @@ void OpenXRFbSpatialAnchorManager::untrack_anchor(const Variant &p_spatial_entit
 }
 
 void OpenXRFbSpatialAnchorManager::_untrack_anchor(const Ref<OpenXRFbSpatialEntity> &p_spatial_entity) {
+	if (anchor_index.has_record(p_spatial_entity->get_xr_uuid())) {
+		anchor_index.erase_record(p_spatial_entity->get_xr_uuid());
+		_queue_anchor_index_flush();
+	}
+
 	if (p_spatial_entity->is_component_enabled(OpenXRFbSpatialEntity::COMPONENT_TYPE_STORABLE)) {
 		_on_anchor_untrack_enable_storable_completed(true, OpenXRFbSpatialEntity::COMPONENT_TYPE_STORABLE, true, p_spatial_entity);
 	} else {
@@ -386,14 +678,15 @@ Array OpenXRFbSpatialAnchorManager::get_anchor_uuids() const {
 	Array ret;
 	ret.resize(anchors.size());
 	int i = 0;
-	for (const KeyValue<StringName, Anchor> &E : anchors) {
-		ret[i++] = E.key;
+	for (const KeyValue<XrUuidEXT, Anchor> &E : anchors) {
+		ret[i++] = OpenXRUtilities::uuid_to_string_name(E.key);
 	}
 	return ret;
 }
 
 XRAnchor3D *OpenXRFbSpatialAnchorManager::get_anchor_node(const StringName &p_uuid) const {
-	const Anchor *anchor = anchors.getptr(p_uuid);
+	XrUuidEXT uuid;
+	const Anchor *anchor = OpenXRUtilities::string_to_uuid(p_uuid, uuid) ? anchors.getptr(uuid) : nullptr;
 	if (anchor) {
 		return Object::cast_to<XRAnchor3D>(ObjectDB::get_instance(anchor->node));
 	}
@@ -402,10 +695,15 @@ XRAnchor3D *OpenXRFbSpatialAnchorManager::get_anchor_node(const StringName &p_uu
 }
 
 Ref<OpenXRFbSpatialEntity> OpenXRFbSpatialAnchorManager::get_spatial_entity(const StringName &p_uuid) const {
-	const Anchor *anchor = anchors.getptr(p_uuid);
+	XrUuidEXT uuid;
+	const Anchor *anchor = OpenXRUtilities::string_to_uuid(p_uuid, uuid) ? anchors.getptr(uuid) : nullptr;
 	if (anchor) {
 		return anchor->entity;
 	}
 
 	return Ref<OpenXRFbSpatialEntity>();
 }
+
+Array OpenXRFbSpatialAnchorManager::get_indexed_anchor_uuids() const {
+	return anchor_index.get_uuids();
+}
@@ -37,7 +37,8 @@
 #include <godot_cpp/classes/mesh_instance3d.hpp>
 #include <godot_cpp/classes/plane_mesh.hpp>
 #include <godot_cpp/classes/project_settings.hpp>
-#include <godot_cpp/classes/surface_tool.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
 #include <godot_cpp/templates/local_vector.hpp>
 
 #include "extensions/openxr_fb_scene_extension_wrapper.h"
@@ -62,6 +63,8 @@ void OpenXRFbSpatialEntity::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_component_enabled", "component", "enabled"), &OpenXRFbSpatialEntity::set_component_enabled);
 
 	ClassDB::bind_method(D_METHOD("get_semantic_labels"), &OpenXRFbSpatialEntity::get_semantic_labels);
+	ClassDB::bind_method(D_METHOD("get_semantic_label_mask"), &OpenXRFbSpatialEntity::get_semantic_label_mask);
+	ClassDB::bind_method(D_METHOD("has_semantic_label", "label_mask"), &OpenXRFbSpatialEntity::has_semantic_label);
 	ClassDB::bind_method(D_METHOD("get_room_layout"), &OpenXRFbSpatialEntity::get_room_layout);
 	ClassDB::bind_method(D_METHOD("get_contained_uuids"), &OpenXRFbSpatialEntity::get_contained_uuids);
 	ClassDB::bind_method(D_METHOD("get_bounding_box_2d"), &OpenXRFbSpatialEntity::get_bounding_box_2d);
@@ -72,9 +75,12 @@ void OpenXRFbSpatialEntity::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("track"), &OpenXRFbSpatialEntity::track);
 	ClassDB::bind_method(D_METHOD("untrack"), &OpenXRFbSpatialEntity::untrack);
 	ClassDB::bind_method(D_METHOD("is_tracked"), &OpenXRFbSpatialEntity::is_tracked);
+	ClassDB::bind_method(D_METHOD("is_cached"), &OpenXRFbSpatialEntity::is_cached);
 
 	ClassDB::bind_method(D_METHOD("create_mesh_instance"), &OpenXRFbSpatialEntity::create_mesh_instance);
 	ClassDB::bind_method(D_METHOD("create_collision_shape"), &OpenXRFbSpatialEntity::create_collision_shape);
+	ClassDB::bind_method(D_METHOD("create_geometry_async", "mesh_instance", "collision_shape"), &OpenXRFbSpatialEntity::create_geometry_async, DEFVAL(true), DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("is_creating_geometry"), &OpenXRFbSpatialEntity::is_creating_geometry);
 
 	ClassDB::bind_static_method("OpenXRFbSpatialEntity", D_METHOD("create_spatial_anchor", "transform"), &OpenXRFbSpatialEntity::create_spatial_anchor);
 
@@ -99,19 +105,152 @@ void OpenXRFbSpatialEntity::_bind_methods() {
 	BIND_ENUM_CONSTANT(COMPONENT_TYPE_CONTAINER);
 	BIND_ENUM_CONSTANT(COMPONENT_TYPE_TRIANGLE_MESH);
 
+	BIND_BITFIELD_FLAG(SEMANTIC_LABEL_CEILING);
+	BIND_BITFIELD_FLAG(SEMANTIC_LABEL_DOOR_FRAME);
+	BIND_BITFIELD_FLAG(SEMANTIC_LABEL_FLOOR);
+	BIND_BITFIELD_FLAG(SEMANTIC_LABEL_INVISIBLE_WALL_FACE);
+	BIND_BITFIELD_FLAG(SEMANTIC_LABEL_WALL_ART);
+	BIND_BITFIELD_FLAG(SEMANTIC_LABEL_WALL_FACE);
+	BIND_BITFIELD_FLAG(SEMANTIC_LABEL_WINDOW_FRAME);
+	BIND_BITFIELD_FLAG(SEMANTIC_LABEL_COUCH);
+	BIND_BITFIELD_FLAG(SEMANTIC_LABEL_TABLE);
+	BIND_BITFIELD_FLAG(SEMANTIC_LABEL_BED);
+	BIND_BITFIELD_FLAG(SEMANTIC_LABEL_LAMP);
+	BIND_BITFIELD_FLAG(SEMANTIC_LABEL_PLANT);
+	BIND_BITFIELD_FLAG(SEMANTIC_LABEL_SCREEN);
+	BIND_BITFIELD_FLAG(SEMANTIC_LABEL_STORAGE);
+	BIND_BITFIELD_FLAG(SEMANTIC_LABEL_GLOBAL_MESH);
+	BIND_BITFIELD_FLAG(SEMANTIC_LABEL_OTHER);
+
 	ADD_SIGNAL(MethodInfo("openxr_fb_spatial_entity_set_component_enabled_completed", PropertyInfo(Variant::Type::BOOL, "succeeded"), PropertyInfo(Variant::Type::INT, "component"), PropertyInfo(Variant::Type::BOOL, "enabled")));
 	ADD_SIGNAL(MethodInfo("openxr_fb_spatial_entity_created", PropertyInfo(Variant::Type::BOOL, "succeeded")));
 	ADD_SIGNAL(MethodInfo("openxr_fb_spatial_entity_saved", PropertyInfo(Variant::Type::BOOL, "succeeded"), PropertyInfo(Variant::Type::INT, "location")));
 	ADD_SIGNAL(MethodInfo("openxr_fb_spatial_entity_erased", PropertyInfo(Variant::Type::BOOL, "succeeded"), PropertyInfo(Variant::Type::INT, "location")));
 	ADD_SIGNAL(MethodInfo("openxr_fb_spatial_entity_shared", PropertyInfo(Variant::Type::BOOL, "succeeded")));
+	ADD_SIGNAL(MethodInfo("openxr_fb_spatial_entity_geometry_created", PropertyInfo(Variant::Type::OBJECT, "mesh_instance"), PropertyInfo(Variant::Type::OBJECT, "collision_shape")));
+}
+
+// Builds a smooth shaded mesh from the runtime's triangle mesh. Vertices sharing
+// a position are merged, so the normals are smoothed across them.
+// Safe to call from worker threads.
+static Ref<ArrayMesh> build_triangle_mesh(const OpenXRMetaSpatialEntityMeshExtensionWrapper::TriangleMesh &p_mesh_data) {
+	const int vertex_count = p_mesh_data.vertices.size();
+	const int index_count = p_mesh_data.indices.size();
+	ERR_FAIL_COND_V_MSG(index_count % 3 != 0, Ref<ArrayMesh>(), "Triangle mesh index count isn't a multiple of 3.");
+	if (vertex_count == 0 || index_count == 0) {
+		return Ref<ArrayMesh>();
+	}
+
+	HashMap<Vector3, int32_t> vertex_map;
+	vertex_map.reserve(vertex_count);
+	LocalVector<int32_t> remap;
+	remap.resize(vertex_count);
+	LocalVector<Vector3> positions;
+	positions.reserve(vertex_count);
+
+	for (int i = 0; i < vertex_count; i++) {
+		const XrVector3f &vertex = p_mesh_data.vertices[i];
+		const Vector3 position(vertex.x, vertex.y, vertex.z);
+
+		HashMap<Vector3, int32_t>::Iterator E = vertex_map.find(position);
+		if (E) {
+			remap[i] = E->value;
+		} else {
+			remap[i] = positions.size();
+			vertex_map.insert(position, positions.size());
+			positions.push_back(position);
+		}
+	}
+
+	PackedInt32Array indices;
+	indices.resize(index_count);
+	int32_t *indices_ptrw = indices.ptrw();
+
+	LocalVector<Vector3> normals;
+	normals.resize(positions.size());
+	for (Vector3 &normal : normals) {
+		normal = Vector3();
+	}
+
+	for (int i = 0; i < index_count; i += 3) {
+		// Reverse the winding order.
+		const uint32_t a = p_mesh_data.indices[i + 2];
+		const uint32_t b = p_mesh_data.indices[i + 1];
+		const uint32_t c = p_mesh_data.indices[i];
+		ERR_FAIL_COND_V_MSG(a >= (uint32_t)vertex_count || b >= (uint32_t)vertex_count || c >= (uint32_t)vertex_count, Ref<ArrayMesh>(), "Triangle mesh index out of range.");
+
+		indices_ptrw[i] = remap[a];
+		indices_ptrw[i + 1] = remap[b];
+		indices_ptrw[i + 2] = remap[c];
+
+		const Vector3 normal = Plane(positions[remap[a]], positions[remap[b]], positions[remap[c]]).normal;
+		normals[remap[a]] += normal;
+		normals[remap[b]] += normal;
+		normals[remap[c]] += normal;
+	}
+
+	PackedVector3Array vertices;
+	vertices.resize(positions.size());
+	Vector3 *vertices_ptrw = vertices.ptrw();
+
+	PackedVector3Array vertex_normals;
+	vertex_normals.resize(positions.size());
+	Vector3 *vertex_normals_ptrw = vertex_normals.ptrw();
+
+	for (uint32_t i = 0; i < positions.size(); i++) {
+		vertices_ptrw[i] = positions[i];
+		vertex_normals_ptrw[i] = normals[i].normalized();
+	}
+
+	Array mesh_array;
+	mesh_array.resize(Mesh::ARRAY_MAX);
+	mesh_array[Mesh::ARRAY_VERTEX] = vertices;
+	mesh_array[Mesh::ARRAY_NORMAL] = vertex_normals;
+	mesh_array[Mesh::ARRAY_INDEX] = indices;
+
+	Ref<ArrayMesh> array_mesh;
+	array_mesh.instantiate();
+	array_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, mesh_array);
+	return array_mesh;
+}
+
+// Builds the faces for a ConcavePolygonShape3D from the runtime's triangle mesh.
+// Safe to call from worker threads.
+static PackedVector3Array build_collision_faces(const OpenXRMetaSpatialEntityMeshExtensionWrapper::TriangleMesh &p_mesh_data) {
+	const uint32_t vertex_count = p_mesh_data.vertices.size();
+	const int index_count = p_mesh_data.indices.size();
+	ERR_FAIL_COND_V_MSG(index_count % 3 != 0, PackedVector3Array(), "Triangle mesh index count isn't a multiple of 3.");
+
+	PackedVector3Array faces;
+	faces.resize(index_count);
+	Vector3 *faces_ptrw = faces.ptrw();
+
+	for (int i = 0; i < index_count; i += 3) {
+		ERR_FAIL_COND_V_MSG(p_mesh_data.indices[i] >= vertex_count || p_mesh_data.indices[i + 1] >= vertex_count || p_mesh_data.indices[i + 2] >= vertex_count, PackedVector3Array(), "Triangle mesh index out of range.");
+
+		XrVector3f vertex[3] = {
+			p_mesh_data.vertices[p_mesh_data.indices[i]],
+			p_mesh_data.vertices[p_mesh_data.indices[i + 1]],
+			p_mesh_data.vertices[p_mesh_data.indices[i + 2]],
+		};
+		// Reverse the winding order.
+		faces_ptrw[i] = Vector3(vertex[2].x, vertex[2].y, vertex[2].z);
+		faces_ptrw[i + 1] = Vector3(vertex[1].x, vertex[1].y, vertex[1].z);
+		faces_ptrw[i + 2] = Vector3(vertex[0].x, vertex[0].y, vertex[0].z);
+	}
+
+	return faces;
 }
 
 String OpenXRFbSpatialEntity::_to_string() const {
-	return String("[OpenXRFbSpatialEntity ") + uuid + String("]");
+	return String("[OpenXRFbSpatialEntity ") + get_uuid() + String("]");
 }
 
 StringName OpenXRFbSpatialEntity::get_uuid() const {
-	return uuid;
+	if (has_uuid && uuid_name.is_empty()) {
+		uuid_name = OpenXRUtilities::uuid_to_string_name(uuid);
+	}
+	return uuid_name;
 }
 
 void OpenXRFbSpatialEntity::set_custom_data(const Dictionary &p_custom_data) {
@@ -137,12 +276,18 @@ Array OpenXRFbSpatialEntity::get_supported_components() const {
 }
 
 bool OpenXRFbSpatialEntity::is_component_supported(ComponentType p_component) const {
+	if (is_cached()) {
+		return p_component != COMPONENT_TYPE_UNKNOWN && (cached_data.components & (1 << p_component));
+	}
 	ERR_FAIL_COND_V_MSG(space == XR_NULL_HANDLE, false, "Underlying spatial entity doesn't exist (yet) or has been destroyed.");
 	ERR_FAIL_COND_V(p_component == COMPONENT_TYPE_UNKNOWN, false);
 	return get_supported_components().has(p_component);
 }
 
 bool OpenXRFbSpatialEntity::is_component_enabled(ComponentType p_component) const {
+	if (is_cached()) {
+		return p_component != COMPONENT_TYPE_UNKNOWN && (cached_data.components & (1 << p_component));
+	}
 	ERR_FAIL_COND_V_MSG(space == XR_NULL_HANDLE, false, "Underlying spatial entity doesn't exist (yet) or has been destroyed.");
 	ERR_FAIL_COND_V(p_component == COMPONENT_TYPE_UNKNOWN, false);
 	return OpenXRFbSpatialEntityExtensionWrapper::get_singleton()->is_component_enabled(space, to_openxr_component_type(p_component));
@@ -161,9 +306,45 @@ void OpenXRFbSpatialEntity::_on_set_component_enabled_completed(XrResult p_resul
 	memdelete(userdata);
 }
 
+void OpenXRFbSpatialEntity::parse_semantic_labels() const {
+	if (semantic_labels_parsed) {
+		return;
+	}
+
+	if (is_cached()) {
+		semantic_labels = cached_data.semantic_labels;
+		semantic_label_mask = OpenXRFbSceneExtensionWrapper::get_semantic_label_mask(semantic_labels);
+	} else {
+		ERR_FAIL_COND_MSG(space == XR_NULL_HANDLE, "Underlying spatial entity doesn't exist (yet) or has been destroyed.");
+
+		// Only keep the result if the component was enabled, since it may be enabled later.
+		if (!OpenXRFbSceneExtensionWrapper::get_singleton()->get_semantic_labels(space, semantic_labels, semantic_label_mask)) {
+			return;
+		}
+	}
+
+	primary_semantic_label = semantic_labels.is_empty() ? -1 : OpenXRFbSceneExtensionWrapper::find_semantic_label(semantic_labels[0]);
+	semantic_labels_parsed = true;
+}
+
 PackedStringArray OpenXRFbSpatialEntity::get_semantic_labels() const {
-	ERR_FAIL_COND_V_MSG(space == XR_NULL_HANDLE, PackedStringArray(), "Underlying spatial entity doesn't exist (yet) or has been destroyed.");
-	return OpenXRFbSceneExtensionWrapper::get_singleton()->get_semantic_labels(space);
+	parse_semantic_labels();
+	return semantic_labels;
+}
+
+BitField<OpenXRFbSpatialEntity::SemanticLabelFlags> OpenXRFbSpatialEntity::get_semantic_label_mask() const {
+	parse_semantic_labels();
+	return semantic_label_mask;
+}
+
+bool OpenXRFbSpatialEntity::has_semantic_label(BitField<SemanticLabelFlags> p_label_mask) const {
+	parse_semantic_labels();
+	return (semantic_label_mask & uint32_t(int64_t(p_label_mask))) != 0;
+}
+
+int OpenXRFbSpatialEntity::get_primary_semantic_label() const {
+	parse_semantic_labels();
+	return primary_semantic_label;
 }
 
 Dictionary OpenXRFbSpatialEntity::get_room_layout() const {
@@ -202,23 +383,32 @@ Array OpenXRFbSpatialEntity::get_contained_uuids() const {
 }
 
 Rect2 OpenXRFbSpatialEntity::get_bounding_box_2d() const {
+	if (is_cached()) {
+		return cached_data.bounding_box_2d;
+	}
 	ERR_FAIL_COND_V_MSG(space == XR_NULL_HANDLE, Rect2(), "Underlying spatial entity doesn't exist (yet) or has been destroyed.");
 	return OpenXRFbSceneExtensionWrapper::get_singleton()->get_bounding_box_2d(space);
 }
 
 AABB OpenXRFbSpatialEntity::get_bounding_box_3d() const {
+	if (is_cached()) {
+		return cached_data.bounding_box_3d;
+	}
 	ERR_FAIL_COND_V_MSG(space == XR_NULL_HANDLE, AABB(), "Underlying spatial entity doesn't exist (yet) or has been destroyed.");
 	return OpenXRFbSceneExtensionWrapper::get_singleton()->get_bounding_box_3d(space);
 }
 
 PackedVector2Array OpenXRFbSpatialEntity::get_boundary_2d() const {
+	if (is_cached()) {
+		return cached_data.boundary_2d;
+	}
 	ERR_FAIL_COND_V_MSG(space == XR_NULL_HANDLE, PackedVector2Array(), "Underlying spatial entity doesn't exist (yet) or has been destroyed.");
 	return OpenXRFbSceneExtensionWrapper::get_singleton()->get_boundary_2d(space);
 }
 
 void OpenXRFbSpatialEntity::track() {
 	ERR_FAIL_COND_MSG(space == XR_NULL_HANDLE, "Underlying spatial entity doesn't exist (yet) or has been destroyed.");
-	ERR_FAIL_COND_MSG(!is_component_enabled(COMPONENT_TYPE_LOCATABLE), vformat("Cannot track spatial entity %s because COMPONENT_TYPE_LOCATABLE isn't enabled.", uuid));
+	ERR_FAIL_COND_MSG(!is_component_enabled(COMPONENT_TYPE_LOCATABLE), vformat("Cannot track spatial entity %s because COMPONENT_TYPE_LOCATABLE isn't enabled.", get_uuid()));
 	OpenXRFbSpatialEntityExtensionWrapper::get_singleton()->track_entity(uuid, space);
 }
 
@@ -232,9 +422,26 @@ bool OpenXRFbSpatialEntity::is_tracked() const {
 	return OpenXRFbSpatialEntityExtensionWrapper::get_singleton()->is_entity_tracked(uuid);
 }
 
-Array OpenXRFbSpatialEntity::get_triangle_mesh() const {
+bool OpenXRFbSpatialEntity::get_triangle_mesh_data(Vector<XrVector3f> &r_vertices, Vector<uint32_t> &r_indices) const {
+	if (is_cached()) {
+		r_vertices = cached_data.mesh_vertices;
+		r_indices = cached_data.mesh_indices;
+		return !r_indices.is_empty();
+	}
+
 	OpenXRMetaSpatialEntityMeshExtensionWrapper::TriangleMesh mesh_data;
 	if (!OpenXRMetaSpatialEntityMeshExtensionWrapper::get_singleton()->get_triangle_mesh(space, mesh_data)) {
+		return false;
+	}
+
+	r_vertices = mesh_data.vertices;
+	r_indices = mesh_data.indices;
+	return true;
+}
+
+Array OpenXRFbSpatialEntity::get_triangle_mesh() const {
+	OpenXRMetaSpatialEntityMeshExtensionWrapper::TriangleMesh mesh_data;
+	if (!get_triangle_mesh_data(mesh_data.vertices, mesh_data.indices)) {
 		return Array();
 	}
 
@@ -262,21 +469,20 @@ Array OpenXRFbSpatialEntity::get_triangle_mesh() const {
 }
 
 MeshInstance3D *OpenXRFbSpatialEntity::create_mesh_instance() const {
-	ERR_FAIL_COND_V_MSG(space == XR_NULL_HANDLE, nullptr, "Underlying spatial entity doesn't exist (yet) or has been destroyed.");
+	ERR_FAIL_COND_V_MSG(space == XR_NULL_HANDLE && !cached, nullptr, "Underlying spatial entity doesn't exist (yet) or has been destroyed.");
 
 	MeshInstance3D *mesh_instance = nullptr;
 
 	if (is_component_enabled(COMPONENT_TYPE_TRIANGLE_MESH)) {
-		Ref<SurfaceTool> surface_tool;
-		surface_tool.instantiate();
-
-		surface_tool->create_from_arrays(get_triangle_mesh(), Mesh::PRIMITIVE_TRIANGLES);
-		surface_tool->generate_normals();
-		surface_tool->generate_tangents();
+		OpenXRMetaSpatialEntityMeshExtensionWrapper::TriangleMesh mesh_data;
+		if (!get_triangle_mesh_data(mesh_data.vertices, mesh_data.indices)) {
+			return nullptr;
+		}
 
-		Ref<ArrayMesh> array_mesh;
-		array_mesh.instantiate();
-		array_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, surface_tool->commit_to_arrays());
+		Ref<ArrayMesh> array_mesh = build_triangle_mesh(mesh_data);
+		if (array_mesh.is_null()) {
+			return nullptr;
+		}
 
 		mesh_instance = memnew(MeshInstance3D);
 		mesh_instance->set_mesh(array_mesh);
@@ -311,26 +517,17 @@ MeshInstance3D *OpenXRFbSpatialEntity::create_mesh_instance() const {
 }
 
 Node3D *OpenXRFbSpatialEntity::create_collision_shape() const {
-	ERR_FAIL_COND_V_MSG(space == XR_NULL_HANDLE, nullptr, "Underlying spatial entity doesn't exist (yet) or has been destroyed.");
+	ERR_FAIL_COND_V_MSG(space == XR_NULL_HANDLE && !cached, nullptr, "Underlying spatial entity doesn't exist (yet) or has been destroyed.");
 
 	if (is_component_enabled(COMPONENT_TYPE_TRIANGLE_MESH)) {
 		OpenXRMetaSpatialEntityMeshExtensionWrapper::TriangleMesh mesh_data;
-		if (!OpenXRMetaSpatialEntityMeshExtensionWrapper::get_singleton()->get_triangle_mesh(space, mesh_data)) {
+		if (!get_triangle_mesh_data(mesh_data.vertices, mesh_data.indices)) {
 			return nullptr;
 		}
 
-		PackedVector3Array faces;
-		faces.resize(mesh_data.indices.size());
-		for (int i = 0; i < mesh_data.indices.size(); i += 3) {
-			XrVector3f vertex[3] = {
-				mesh_data.vertices[mesh_data.indices[i]],
-				mesh_data.vertices[mesh_data.indices[i + 1]],
-				mesh_data.vertices[mesh_data.indices[i + 2]],
-			};
-			// Reverse the winding order.
-			faces[i] = Vector3(vertex[2].x, vertex[2].y, vertex[2].z);
-			faces[i + 1] = Vector3(vertex[1].x, vertex[1].y, vertex[1].z);
-			faces[i + 2] = Vector3(vertex[0].x, vertex[0].y, vertex[0].z);
+		PackedVector3Array faces = build_collision_faces(mesh_data);
+		if (faces.is_empty()) {
+			return nullptr;
 		}
 
 		Ref<ConcavePolygonShape3D> polygon_shape;
@@ -378,6 +575,102 @@ Node3D *OpenXRFbSpatialEntity::create_collision_shape() const {
 	return nullptr;
 }
 
+void OpenXRFbSpatialEntity::create_geometry_async(bool p_mesh_instance, bool p_collision_shape) {
+	ERR_FAIL_COND_MSG(space == XR_NULL_HANDLE && !cached, "Underlying spatial entity doesn't exist (yet) or has been destroyed.");
+	ERR_FAIL_COND_MSG(geometry_task_owner.is_valid(), vformat("Already creating geometry for spatial entity %s.", get_uuid()));
+
+	// Keep ourselves alive until the results have been handed back.
+	geometry_task_owner = Ref<OpenXRFbSpatialEntity>(this);
+	geometry_task_mesh_instance = p_mesh_instance;
+	geometry_task_collision_shape = p_collision_shape;
+	geometry_task_triangle_mesh = is_component_enabled(COMPONENT_TYPE_TRIANGLE_MESH);
+	geometry_task_cached = is_cached();
+
+	if (geometry_task_triangle_mesh) {
+		geometry_task_id = WorkerThreadPool::get_singleton()->add_task(callable_mp(this, &OpenXRFbSpatialEntity::_create_geometry_task), false, "Create spatial entity geometry");
+	} else {
+		// Bounding boxes are cheap to build, but the results are still delivered asynchronously.
+		callable_mp(this, &OpenXRFbSpatialEntity::_finish_geometry_task).call_deferred();
+	}
+}
+
+bool OpenXRFbSpatialEntity::is_creating_geometry() const {
+	return geometry_task_owner.is_valid();
+}
+
+void OpenXRFbSpatialEntity::_create_geometry_task() {
+	OpenXRMetaSpatialEntityMeshExtensionWrapper::TriangleMesh mesh_data;
+	bool has_mesh_data;
+	if (geometry_task_cached) {
+		mesh_data.vertices = cached_data.mesh_vertices;
+		mesh_data.indices = cached_data.mesh_indices;
+		has_mesh_data = true;
+	} else {
+		has_mesh_data = OpenXRMetaSpatialEntityMeshExtensionWrapper::get_singleton()->fetch_triangle_mesh(space, mesh_data);
+	}
+
+	if (has_mesh_data) {
+		if (geometry_task_mesh_instance) {
+			geometry_task_mesh = build_triangle_mesh(mesh_data);
+		}
+		if (geometry_task_collision_shape) {
+			geometry_task_faces = build_collision_faces(mesh_data);
+		}
+	}
+
+	// Nodes and physics shapes are created on the main thread.
+	callable_mp(this, &OpenXRFbSpatialEntity::_finish_geometry_task).call_deferred();
+}
+
+void OpenXRFbSpatialEntity::wait_for_geometry_task() {
+	if (geometry_task_id < 0) {
+		return;
+	}
+
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(geometry_task_id);
+	geometry_task_id = -1;
+}
+
+void OpenXRFbSpatialEntity::_finish_geometry_task() {
+	wait_for_geometry_task();
+
+	MeshInstance3D *mesh_instance = nullptr;
+	Node3D *collision_shape = nullptr;
+
+	if (geometry_task_triangle_mesh) {
+		if (geometry_task_mesh.is_valid()) {
+			mesh_instance = memnew(MeshInstance3D);
+			mesh_instance->set_mesh(geometry_task_mesh);
+		}
+
+		if (!geometry_task_faces.is_empty()) {
+			Ref<ConcavePolygonShape3D> polygon_shape;
+			polygon_shape.instantiate();
+			polygon_shape->set_faces(geometry_task_faces);
+
+			CollisionShape3D *collision_shape_node = memnew(CollisionShape3D);
+			collision_shape_node->set_shape(polygon_shape);
+			collision_shape = collision_shape_node;
+		}
+	} else if (space != XR_NULL_HANDLE || cached) {
+		if (geometry_task_mesh_instance) {
+			mesh_instance = create_mesh_instance();
+		}
+		if (geometry_task_collision_shape) {
+			collision_shape = create_collision_shape();
+		}
+	}
+
+	geometry_task_mesh.unref();
+	geometry_task_faces = PackedVector3Array();
+
+	// Release the task's reference only after the signal has been emitted.
+	Ref<OpenXRFbSpatialEntity> self = geometry_task_owner;
+	geometry_task_owner.unref();
+
+	emit_signal("openxr_fb_spatial_entity_geometry_created", mesh_instance, collision_shape);
+}
+
 Ref<OpenXRFbSpatialEntity> OpenXRFbSpatialEntity::create_spatial_anchor(const Transform3D &p_transform) {
 	Ref<OpenXRFbSpatialEntity> *userdata = memnew(Ref<OpenXRFbSpatialEntity>());
 	(*userdata).instantiate();
@@ -394,7 +687,8 @@ void OpenXRFbSpatialEntity::_on_spatial_anchor_created(XrResult p_result, XrSpac
 	bool success = XR_SUCCEEDED(p_result);
 	if (success) {
 		(*userdata)->space = p_space;
-		(*userdata)->uuid = OpenXRUtilities::uuid_to_string_name(*p_uuid);
+		(*userdata)->uuid = *p_uuid;
+		(*userdata)->has_uuid = true;
 	}
 	(*userdata)->emit_signal("openxr_fb_spatial_entity_created", success);
 	memdelete(userdata);
@@ -474,6 +768,9 @@ void OpenXRFbSpatialEntity::_on_share_with_users(XrResult p_result, void *p_user
 
 void OpenXRFbSpatialEntity::destroy() {
 	ERR_FAIL_COND_MSG(space == XR_NULL_HANDLE, "Underlying spatial entity doesn't exist (yet) or has been destroyed.");
+	// The worker may still be reading the space.
+	wait_for_geometry_task();
+
 	OpenXRFbSpatialEntityExtensionWrapper *spatial_entity_extension_wrapper = OpenXRFbSpatialEntityExtensionWrapper::get_singleton();
 	if (spatial_entity_extension_wrapper) {
 		spatial_entity_extension_wrapper->untrack_entity(uuid);
@@ -589,7 +886,70 @@ XrSpace OpenXRFbSpatialEntity::get_space() {
 	return space;
 }
 
+void OpenXRFbSpatialEntity::attach_space(XrSpace p_space) {
+	ERR_FAIL_COND_MSG(space != XR_NULL_HANDLE, vformat("Spatial entity %s already has a space.", get_uuid()));
+	space = p_space;
+}
+
+bool OpenXRFbSpatialEntity::capture_scene_data(SceneCache::EntityData &r_data) const {
+	ERR_FAIL_COND_V_MSG(space == XR_NULL_HANDLE, false, "Underlying spatial entity doesn't exist (yet) or has been destroyed.");
+
+	r_data = SceneCache::EntityData();
+
+	static const ComponentType scene_components[] = {
+		COMPONENT_TYPE_BOUNDED_2D,
+		COMPONENT_TYPE_BOUNDED_3D,
+		COMPONENT_TYPE_SEMANTIC_LABELS,
+		COMPONENT_TYPE_TRIANGLE_MESH,
+	};
+	for (ComponentType component : scene_components) {
+		if (is_component_enabled(component)) {
+			r_data.components |= 1 << component;
+		}
+	}
+
+	if (r_data.components & (1 << COMPONENT_TYPE_SEMANTIC_LABELS)) {
+		r_data.semantic_labels = get_semantic_labels();
+	}
+	if (r_data.components & (1 << COMPONENT_TYPE_BOUNDED_2D)) {
+		r_data.bounding_box_2d = get_bounding_box_2d();
+		r_data.boundary_2d = get_boundary_2d();
+	}
+	if (r_data.components & (1 << COMPONENT_TYPE_BOUNDED_3D)) {
+		r_data.bounding_box_3d = get_bounding_box_3d();
+	}
+
+	return true;
+}
+
+void OpenXRFbSpatialEntity::fetch_scene_mesh_data(SceneCache::EntityData &r_data) const {
+	if (!(r_data.components & (1 << COMPONENT_TYPE_TRIANGLE_MESH))) {
+		return;
+	}
+
+	if (is_cached()) {
+		r_data.mesh_vertices = cached_data.mesh_vertices;
+		r_data.mesh_indices = cached_data.mesh_indices;
+		return;
+	}
+
+	// The component was already checked by capture_scene_data().
+	OpenXRMetaSpatialEntityMeshExtensionWrapper::TriangleMesh mesh_data;
+	if (OpenXRMetaSpatialEntityMeshExtensionWrapper::get_singleton()->fetch_triangle_mesh(space, mesh_data)) {
+		r_data.mesh_vertices = mesh_data.vertices;
+		r_data.mesh_indices = mesh_data.indices;
+	}
+}
+
 OpenXRFbSpatialEntity::OpenXRFbSpatialEntity(XrSpace p_space, const XrUuidEXT &p_uuid) {
 	space = p_space;
-	uuid = OpenXRUtilities::uuid_to_string_name(p_uuid);
+	uuid = p_uuid;
+	has_uuid = true;
+}
+
+OpenXRFbSpatialEntity::OpenXRFbSpatialEntity(const XrUuidEXT &p_uuid, const SceneCache::EntityData &p_cached_data) {
+	uuid = p_uuid;
+	has_uuid = true;
+	cached = true;
+	cached_data = p_cached_data;
 }
@@ -32,6 +32,7 @@
 #include <godot_cpp/templates/local_vector.hpp>
 
 #include "extensions/openxr_fb_spatial_entity_query_extension_wrapper.h"
+#include "util.h"
 
 using namespace godot;
 
@@ -40,6 +41,8 @@ void OpenXRFbSpatialEntityQuery::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_max_results"), &OpenXRFbSpatialEntityQuery::get_max_results);
 	ClassDB::bind_method(D_METHOD("set_timeout", "seconds"), &OpenXRFbSpatialEntityQuery::set_timeout);
 	ClassDB::bind_method(D_METHOD("get_timeout"), &OpenXRFbSpatialEntityQuery::get_timeout);
+	ClassDB::bind_method(D_METHOD("set_stream_results", "enable"), &OpenXRFbSpatialEntityQuery::set_stream_results);
+	ClassDB::bind_method(D_METHOD("get_stream_results"), &OpenXRFbSpatialEntityQuery::get_stream_results);
 	ClassDB::bind_method(D_METHOD("query_all"), &OpenXRFbSpatialEntityQuery::query_all);
 	ClassDB::bind_method(D_METHOD("query_by_uuid", "uuids", "location"), &OpenXRFbSpatialEntityQuery::query_by_uuid, DEFVAL(OpenXRFbSpatialEntity::STORAGE_LOCAL));
 	ClassDB::bind_method(D_METHOD("query_by_component", "component", "location"), &OpenXRFbSpatialEntityQuery::query_by_component, DEFVAL(OpenXRFbSpatialEntity::STORAGE_LOCAL));
@@ -48,15 +51,18 @@ void OpenXRFbSpatialEntityQuery::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_uuids"), &OpenXRFbSpatialEntityQuery::get_uuids);
 	ClassDB::bind_method(D_METHOD("get_component_type"), &OpenXRFbSpatialEntityQuery::get_component_type);
 	ClassDB::bind_method(D_METHOD("execute"), &OpenXRFbSpatialEntityQuery::execute);
+	ClassDB::bind_method(D_METHOD("is_successful"), &OpenXRFbSpatialEntityQuery::is_successful);
 
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_results", PROPERTY_HINT_NONE, ""), "set_max_results", "get_max_results");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "timeout", PROPERTY_HINT_RANGE, "0.001,4096,0.001,or_greater,exp,suffix:s"), "set_timeout", "get_timeout");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "stream_results", PROPERTY_HINT_NONE, ""), "set_stream_results", "get_stream_results");
 
 	BIND_ENUM_CONSTANT(QUERY_ALL);
 	BIND_ENUM_CONSTANT(QUERY_BY_UUID);
 	BIND_ENUM_CONSTANT(QUERY_BY_COMPONENT);
 
 	ADD_SIGNAL(MethodInfo("openxr_fb_spatial_entity_query_completed", PropertyInfo(Variant::Type::ARRAY, "results")));
+	ADD_SIGNAL(MethodInfo("openxr_fb_spatial_entity_query_results_available", PropertyInfo(Variant::Type::ARRAY, "results")));
 }
 
 void OpenXRFbSpatialEntityQuery::set_max_results(uint32_t p_max_results) {
@@ -71,6 +77,15 @@ void OpenXRFbSpatialEntityQuery::set_timeout(float p_timeout) {
 	timeout = p_timeout;
 }
 
+void OpenXRFbSpatialEntityQuery::set_stream_results(bool p_stream_results) {
+	ERR_FAIL_COND_MSG(executed, "Cannot change streaming after the query has been executed.");
+	stream_results = p_stream_results;
+}
+
+bool OpenXRFbSpatialEntityQuery::get_stream_results() const {
+	return stream_results;
+}
+
 void OpenXRFbSpatialEntityQuery::query_all() {
 	query_type = QUERY_ALL;
 	// Reset data used for other query types.
@@ -115,6 +130,10 @@ OpenXRFbSpatialEntity::ComponentType OpenXRFbSpatialEntityQuery::get_component_t
 	return component_type;
 }
 
+bool OpenXRFbSpatialEntityQuery::is_successful() const {
+	return successful;
+}
+
 Error OpenXRFbSpatialEntityQuery::execute() {
 	ERR_FAIL_COND_V(executed, ERR_ALREADY_IN_USE);
 	executed = true;
@@ -149,7 +168,7 @@ bool OpenXRFbSpatialEntityQuery::_execute_query_all() {
 	};
 
 	Ref<OpenXRFbSpatialEntityQuery> *userdata = memnew(Ref<OpenXRFbSpatialEntityQuery>(this));
-	return OpenXRFbSpatialEntityQueryExtensionWrapper::get_singleton()->query_spatial_entities((XrSpaceQueryInfoBaseHeaderFB *)&query, &OpenXRFbSpatialEntityQuery::_results_callback, userdata);
+	return OpenXRFbSpatialEntityQueryExtensionWrapper::get_singleton()->query_spatial_entities((XrSpaceQueryInfoBaseHeaderFB *)&query, &OpenXRFbSpatialEntityQuery::_results_callback, userdata, stream_results ? &OpenXRFbSpatialEntityQuery::_results_page_callback : nullptr);
 }
 
 bool OpenXRFbSpatialEntityQuery::_execute_query_by_uuid() {
@@ -162,9 +181,7 @@ bool OpenXRFbSpatialEntityQuery::_execute_query_by_uuid() {
 	LocalVector<XrUuidEXT> uuid_array;
 	uuid_array.resize(uuids.size());
 	for (int i = 0; i < uuids.size(); i++) {
-		PackedByteArray uuid_data = String(uuids[i]).replace("-", "").hex_decode();
-		ERR_CONTINUE_MSG(uuid_data.size() != 16, vformat("Invalid UUID: %s", uuids[i]));
-		memcpy(uuid_array[i].data, uuid_data.ptr(), 16);
+		ERR_CONTINUE_MSG(!OpenXRUtilities::string_to_uuid(uuids[i], uuid_array[i]), vformat("Invalid UUID: %s", uuids[i]));
 	}
 
 	XrSpaceUuidFilterInfoFB filter = {
@@ -185,7 +202,7 @@ bool OpenXRFbSpatialEntityQuery::_execute_query_by_uuid() {
 	};
 
 	Ref<OpenXRFbSpatialEntityQuery> *userdata = memnew(Ref<OpenXRFbSpatialEntityQuery>(this));
-	return OpenXRFbSpatialEntityQueryExtensionWrapper::get_singleton()->query_spatial_entities((XrSpaceQueryInfoBaseHeaderFB *)&query, &OpenXRFbSpatialEntityQuery::_results_callback, userdata);
+	return OpenXRFbSpatialEntityQueryExtensionWrapper::get_singleton()->query_spatial_entities((XrSpaceQueryInfoBaseHeaderFB *)&query, &OpenXRFbSpatialEntityQuery::_results_callback, userdata, stream_results ? &OpenXRFbSpatialEntityQuery::_results_page_callback : nullptr);
 }
 
 bool OpenXRFbSpatialEntityQuery::_execute_query_by_component() {
@@ -212,11 +229,21 @@ bool OpenXRFbSpatialEntityQuery::_execute_query_by_component() {
 	};
 
 	Ref<OpenXRFbSpatialEntityQuery> *userdata = memnew(Ref<OpenXRFbSpatialEntityQuery>(this));
-	return OpenXRFbSpatialEntityQueryExtensionWrapper::get_singleton()->query_spatial_entities((XrSpaceQueryInfoBaseHeaderFB *)&query, &OpenXRFbSpatialEntityQuery::_results_callback, userdata);
+	return OpenXRFbSpatialEntityQueryExtensionWrapper::get_singleton()->query_spatial_entities((XrSpaceQueryInfoBaseHeaderFB *)&query, &OpenXRFbSpatialEntityQuery::_results_callback, userdata, stream_results ? &OpenXRFbSpatialEntityQuery::_results_page_callback : nullptr);
 }
 
-void OpenXRFbSpatialEntityQuery::_results_callback(const Vector<XrSpaceQueryResultFB> &p_results, void *p_userdata) {
+void OpenXRFbSpatialEntityQuery::_results_callback(XrResult p_result, const Vector<XrSpaceQueryResultFB> &p_results, void *p_userdata) {
 	Ref<OpenXRFbSpatialEntityQuery> *userdata = (Ref<OpenXRFbSpatialEntityQuery> *)p_userdata;
+	(*userdata)->successful = XR_SUCCEEDED(p_result);
+
+	if ((*userdata)->stream_results) {
+		// The entities were already created as each page arrived.
+		Array results = (*userdata)->streamed_results;
+		(*userdata)->streamed_results = Array();
+		(*userdata)->emit_signal("openxr_fb_spatial_entity_query_completed", results);
+		memdelete(userdata);
+		return;
+	}
 
 	Array results;
 	results.resize(p_results.size());
@@ -229,3 +256,17 @@ void OpenXRFbSpatialEntityQuery::_results_callback(const Vector<XrSpaceQueryResu
 
 	memdelete(userdata);
 }
+
+void OpenXRFbSpatialEntityQuery::_results_page_callback(const XrSpaceQueryResultFB *p_results, uint32_t p_count, void *p_userdata) {
+	Ref<OpenXRFbSpatialEntityQuery> *userdata = (Ref<OpenXRFbSpatialEntityQuery> *)p_userdata;
+
+	Array results;
+	results.resize(p_count);
+	for (uint32_t i = 0; i < p_count; i++) {
+		Ref<OpenXRFbSpatialEntity> entity = Ref<OpenXRFbSpatialEntity>(memnew(OpenXRFbSpatialEntity(p_results[i].space, p_results[i].uuid)));
+		results[i] = entity;
+	}
+	(*userdata)->streamed_results.append_array(results);
+
+	(*userdata)->emit_signal("openxr_fb_spatial_entity_query_results_available", results);
+}
@@ -32,12 +32,47 @@
 #include "extensions/openxr_fb_passthrough_extension_wrapper.h"
 
 #include <godot_cpp/classes/image.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 
+#include <cstring>
+
 using namespace godot;
 
+// Below this size, the rows are copied on the calling thread.
+static const int PARALLEL_POPULATE_MIN_BYTES = 64 * 1024;
+
+static inline uint64_t hash_mix_64(uint64_t p_value) {
+	p_value ^= p_value >> 33;
+	p_value *= 0xff51afd7ed558ccdULL;
+	p_value ^= p_value >> 33;
+	p_value *= 0xc4ceb9fe1a85ec53ULL;
+	p_value ^= p_value >> 33;
+	return p_value;
+}
+
+// 64-bit FNV-1a over mixed 8-byte words, so the image data is hashed in a single pass.
+static uint64_t hash_color_lut_data(const uint8_t *p_data, size_t p_size, uint64_t p_seed) {
+	uint64_t hash = 0xcbf29ce484222325ULL ^ hash_mix_64(p_seed);
+	size_t offset = 0;
+	for (; offset + 8 <= p_size; offset += 8) {
+		uint64_t word;
+		memcpy(&word, p_data + offset, 8);
+		hash = (hash ^ hash_mix_64(word)) * 0x100000001b3ULL;
+	}
+
+	uint64_t tail = 0;
+	memcpy(&tail, p_data + offset, p_size - offset);
+	hash = (hash ^ hash_mix_64(tail ^ p_size)) * 0x100000001b3ULL;
+	return hash_mix_64(hash);
+}
+
 void OpenXRMetaPassthroughColorLut::_bind_methods() {
 	ClassDB::bind_static_method("OpenXRMetaPassthroughColorLut", D_METHOD("create_from_image", "image", "channels"), &OpenXRMetaPassthroughColorLut::create_from_image);
+	ClassDB::bind_static_method("OpenXRMetaPassthroughColorLut", D_METHOD("create_from_image_async", "image", "channels"), &OpenXRMetaPassthroughColorLut::create_from_image_async);
+	ClassDB::bind_method(D_METHOD("is_creating"), &OpenXRMetaPassthroughColorLut::is_creating);
+
+	ADD_SIGNAL(MethodInfo("openxr_meta_passthrough_color_lut_created", PropertyInfo(Variant::Type::BOOL, "success")));
 
 	BIND_ENUM_CONSTANT(COLOR_LUT_CHANNELS_RGB);
 	BIND_ENUM_CONSTANT(COLOR_LUT_CHANNELS_RGBA);
@@ -56,19 +91,64 @@ Ref<OpenXRMetaPassthroughColorLut> OpenXRMetaPassthroughColorLut::create_from_im
 	return passthrough_color_lut;
 }
 
+Ref<OpenXRMetaPassthroughColorLut> OpenXRMetaPassthroughColorLut::create_from_image_async(Ref<Image> p_image, ColorLutChannels p_channels) {
+	Ref<OpenXRMetaPassthroughColorLut> passthrough_color_lut;
+	passthrough_color_lut.instantiate();
+	if (!passthrough_color_lut->begin_populate(p_image, p_channels)) {
+		return Ref<OpenXRMetaPassthroughColorLut>();
+	}
+
+	// Keep the color LUT alive until the handle has been created.
+	passthrough_color_lut->populate_task_owner = passthrough_color_lut;
+
+	// The image is converted and hashed on a worker thread too.
+	passthrough_color_lut->populate_task_prepare_id = WorkerThreadPool::get_singleton()->add_task(callable_mp(passthrough_color_lut.ptr(), &OpenXRMetaPassthroughColorLut::_prepare_populate_task), false, "Prepare passthrough color LUT");
+
+	return passthrough_color_lut;
+}
+
+bool OpenXRMetaPassthroughColorLut::is_creating() const {
+	return populate_task_owner.is_valid();
+}
+
 void OpenXRMetaPassthroughColorLut::populate_buffer(const Ref<Image> &p_image, ColorLutChannels p_channels) {
+	if (!begin_populate(p_image, p_channels)) {
+		return;
+	}
+
+	if (!prepare_populate() || !start_populate()) {
+		return;
+	}
+
+	if (buffer.size() < PARALLEL_POPULATE_MIN_BYTES) {
+		for (int y = 0; y < populate_task_rows; y++) {
+			_populate_row(y);
+		}
+	} else {
+		WorkerThreadPool *worker_thread_pool = WorkerThreadPool::get_singleton();
+		int64_t group_id = worker_thread_pool->add_group_task(callable_mp(this, &OpenXRMetaPassthroughColorLut::_populate_row), populate_task_rows, -1, true, "Populate passthrough color LUT");
+		worker_thread_pool->wait_for_group_task_completion(group_id);
+	}
+
+	end_populate();
+}
+
+bool OpenXRMetaPassthroughColorLut::begin_populate(const Ref<Image> &p_image, ColorLutChannels p_channels) {
+	ERR_FAIL_COND_V(p_image.is_null(), false);
+	ERR_FAIL_COND_V_MSG(populate_task_owner.is_valid(), false, "Color LUT is already being created.");
+
 	int height = p_image->get_height();
 	int width = p_image->get_width();
 
 	if (height != width) { // Rectangular image
 		if ((height & (height - 1)) != 0) {
 			UtilityFunctions::print("Color LUT cell resolution must be a power of 2, current resolution: ", height);
-			return;
+			return false;
 		}
 
 		if (width != (height * height)) {
 			UtilityFunctions::print("Color LUT image is incorrect size");
-			return;
+			return false;
 		}
 
 		image_cell_resolution = height;
@@ -85,48 +165,128 @@ void OpenXRMetaPassthroughColorLut::populate_buffer(const Ref<Image> &p_image, C
 			} break;
 			default: {
 				UtilityFunctions::print("Square color LUT image must be of total resolution 8x8, 64x64, or 512x512");
-				return;
+				return false;
 			} break;
 		}
 	}
 
 	channels = p_channels;
-	switch (p_channels) {
-		case COLOR_LUT_CHANNELS_RGB: {
-			if (p_image->get_format() != Image::FORMAT_RGB8) {
-				p_image->convert(Image::FORMAT_RGB8);
-			}
-		} break;
-		case COLOR_LUT_CHANNELS_RGBA: {
-			if (p_image->get_format() != Image::FORMAT_RGBA8) {
-				p_image->convert(Image::FORMAT_RGBA8);
-			}
-		} break;
+
+	// Only take a copy-on-write reference to the data here, converting and hashing it can
+	// be left to a worker thread.
+	populate_task_image_data = p_image->get_data();
+	populate_task_image_format = p_image->get_format();
+	populate_task_image_mipmaps = p_image->has_mipmaps();
+	populate_task_image_width = width;
+	populate_task_rows = height;
+
+	return true;
+}
+
+bool OpenXRMetaPassthroughColorLut::prepare_populate() {
+	const Image::Format format = channels == COLOR_LUT_CHANNELS_RGBA ? Image::FORMAT_RGBA8 : Image::FORMAT_RGB8;
+	if (populate_task_image_format != format) {
+		Ref<Image> image = Image::create_from_data(populate_task_image_width, populate_task_rows, populate_task_image_mipmaps, populate_task_image_format, populate_task_image_data);
+		image->convert(format);
+		populate_task_image_data = image->get_data();
+		populate_task_image_format = image->get_format();
+	}
+
+	// Only the top mipmap level is used.
+	const size_t image_size = size_t(populate_task_image_width) * populate_task_rows * channels;
+	if (populate_task_image_format != format || size_t(populate_task_image_data.size()) < image_size) {
+		ERR_PRINT("Unable to convert the color LUT image.");
+		populate_task_image_data = PackedByteArray();
+		return false;
 	}
 
-	PackedByteArray image_data = p_image->get_data();
-	const uint8_t *image_ptr = image_data.ptr();
+	// Identical images with the same channels share a color LUT.
+	const uint64_t seed = (uint64_t(channels) << 48) ^ (uint64_t(populate_task_image_width) << 24) ^ uint64_t(populate_task_rows);
+	content_hash = hash_color_lut_data(populate_task_image_data.ptr(), image_size, seed);
+	return true;
+}
 
-	int res_sq = pow(image_cell_resolution, 2);
-	int res_sqrt = sqrt(image_cell_resolution);
+bool OpenXRMetaPassthroughColorLut::start_populate() {
+	// Only populate color LUTs that aren't cached already.
+	color_lut_handle = OpenXRFbPassthroughExtensionWrapper::get_singleton()->color_lut_acquire(content_hash);
+	if (color_lut_handle.is_valid()) {
+		populate_task_image_data = PackedByteArray();
+		return false;
+	}
 
-	int buffer_size = pow(image_cell_resolution, 3) * p_channels;
-	buffer.resize(buffer_size);
-	uint8_t *color_lut_buffer_ptr = buffer.ptrw();
+	buffer.resize(image_cell_resolution * image_cell_resolution * image_cell_resolution * channels);
 
-	for (int y = 0; y < height; y++) {
-		int y_val = res_sqrt * res_sq * (y / image_cell_resolution) + image_cell_resolution * (y % image_cell_resolution);
-		for (int x = 0; x < width; x++) {
-			const uint8_t *pixel = image_ptr + (y * width * p_channels) + (x * p_channels);
-			int x_val = res_sq * (x / image_cell_resolution) + (x % image_cell_resolution);
-			int start_index = (x_val + y_val) * p_channels;
+	// Resolve the pointers once, so the rows can be written from any thread.
+	populate_task_src = populate_task_image_data.ptr();
+	populate_task_dst = buffer.ptrw();
 
-			for (int i = 0; i < p_channels; i++) {
-				color_lut_buffer_ptr[start_index + i] = pixel[i];
-			}
-		}
+	return true;
+}
+
+void OpenXRMetaPassthroughColorLut::_prepare_populate_task() {
+	populate_task_prepared = prepare_populate();
+	callable_mp(this, &OpenXRMetaPassthroughColorLut::_on_populate_prepared).call_deferred();
+}
+
+void OpenXRMetaPassthroughColorLut::_on_populate_prepared() {
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(populate_task_prepare_id);
+	populate_task_prepare_id = -1;
+
+	if (!populate_task_prepared || !start_populate()) {
+		// Either failed, or identical to a cached color LUT.
+		_finish_populate_task();
+		return;
 	}
 
-	color_lut_handle = OpenXRFbPassthroughExtensionWrapper::get_singleton()->color_lut_create(channels, image_cell_resolution, buffer);
-	;
+	populate_task_rows_left = populate_task_rows;
+	populate_task_id = WorkerThreadPool::get_singleton()->add_group_task(callable_mp(this, &OpenXRMetaPassthroughColorLut::_populate_row_task), populate_task_rows, -1, false, "Populate passthrough color LUT");
+}
+
+void OpenXRMetaPassthroughColorLut::_populate_row(uint32_t p_row) {
+	// The image is a grid of cells, each one a slice of the LUT along blue, with red
+	// along x and green along y. So each row of a cell is a contiguous run of the LUT.
+	const int res = image_cell_resolution;
+	const int cells_per_row = populate_task_image_width / res;
+	const size_t run_size = size_t(res) * channels;
+
+	const uint8_t *src = populate_task_src + size_t(p_row) * populate_task_image_width * channels;
+	const int green = p_row % res;
+	const int first_blue = (p_row / res) * cells_per_row;
+
+	for (int cell = 0; cell < cells_per_row; cell++) {
+		const size_t dst_offset = (size_t(first_blue + cell) * res + green) * run_size;
+		memcpy(populate_task_dst + dst_offset, src + cell * run_size, run_size);
+	}
+}
+
+void OpenXRMetaPassthroughColorLut::_populate_row_task(uint32_t p_row) {
+	_populate_row(p_row);
+
+	// The last row hands the buffer back to the main thread.
+	if (--populate_task_rows_left == 0) {
+		callable_mp(this, &OpenXRMetaPassthroughColorLut::_finish_populate_task).call_deferred();
+	}
+}
+
+void OpenXRMetaPassthroughColorLut::_finish_populate_task() {
+	if (populate_task_id >= 0) {
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(populate_task_id);
+		populate_task_id = -1;
+
+		end_populate();
+	}
+
+	// Release the task's reference only after the signal has been emitted.
+	Ref<OpenXRMetaPassthroughColorLut> self = populate_task_owner;
+	populate_task_owner.unref();
+
+	emit_signal("openxr_meta_passthrough_color_lut_created", color_lut_handle.is_valid());
+}
+
+void OpenXRMetaPassthroughColorLut::end_populate() {
+	populate_task_image_data = PackedByteArray();
+	populate_task_src = nullptr;
+	populate_task_dst = nullptr;
+
+	color_lut_handle = OpenXRFbPassthroughExtensionWrapper::get_singleton()->color_lut_create(channels, image_cell_resolution, buffer, content_hash);
 }
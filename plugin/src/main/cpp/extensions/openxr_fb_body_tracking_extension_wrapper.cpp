@@ -31,6 +31,7 @@
 
 #include <godot_cpp/classes/object.hpp>
 #include <godot_cpp/classes/open_xrapi_extension.hpp>
+#include <godot_cpp/classes/time.hpp>
 #include <godot_cpp/classes/xr_server.hpp>
 #include <godot_cpp/templates/local_vector.hpp>
 
@@ -142,6 +143,36 @@ static const JointMapEntry joint_table[] = {
 #endif
 };
 
+static constexpr uint32_t joint_table_size = sizeof(joint_table) / sizeof(joint_table[0]);
+
+/// Body tracking capture file format:
+///
+/// Header: magic (4 bytes), version (uint32), joint count (uint32).
+/// Frame: display time (int64), is active (uint32), confidence (float),
+/// then for each joint the location flags (uint64) followed by the pose as
+/// position x, y, z and orientation x, y, z, w (7 floats).
+///
+/// Values are stored in host byte order, which is little-endian on every
+/// platform that supports body tracking, so captures can be moved between
+/// the headset and the editor.
+static constexpr char capture_magic[4] = { 'F', 'B', 'B', 'T' };
+static constexpr uint32_t capture_version = 1;
+static constexpr uint32_t capture_header_size = 12;
+static constexpr uint32_t capture_frame_header_size = 16;
+static constexpr uint32_t capture_joint_size = 36;
+
+#ifdef META_HEADERS_ENABLED
+static constexpr uint32_t max_joint_count = XR_FULL_BODY_JOINT_COUNT_META;
+#else
+static constexpr uint32_t max_joint_count = XR_BODY_JOINT_COUNT_FB;
+#endif
+
+/// Smoothing factor of a first-order low-pass filter with the given cutoff frequency (Hz).
+static inline real_t one_euro_alpha(real_t p_cutoff, real_t p_delta) {
+	const real_t tau = 1.0 / (Math_TAU * p_cutoff);
+	return 1.0 / (1.0 + tau / p_delta);
+}
+
 OpenXRFbBodyTrackingExtensionWrapper *OpenXRFbBodyTrackingExtensionWrapper::singleton = nullptr;
 
 OpenXRFbBodyTrackingExtensionWrapper *OpenXRFbBodyTrackingExtensionWrapper::get_singleton() {
@@ -167,6 +198,21 @@ OpenXRFbBodyTrackingExtensionWrapper::OpenXRFbBodyTrackingExtensionWrapper() :
 	request_extensions[XR_META_BODY_TRACKING_CALIBRATION_EXTENSION_NAME] = &meta_body_tracking_calibration_ext;
 #endif // META_HEADERS_ENABLED
 
+	// Unpack the joint correction rotations into the conversion buffers once.
+	static_assert(joint_table_size <= JOINT_BUFFER_SIZE, "Joint table does not fit in the joint conversion buffers.");
+	for (uint32_t i = 0; i < joint_table_size; i++) {
+		const JointMapEntry &entry = joint_table[i];
+		joint_buffers.correction_x[i] = entry.rotation.x;
+		joint_buffers.correction_y[i] = entry.rotation.y;
+		joint_buffers.correction_z[i] = entry.rotation.z;
+		joint_buffers.correction_w[i] = entry.rotation.w;
+
+		// Full body joints are always at the end of the table.
+		if (entry.fb_joint < XR_BODY_JOINT_COUNT_FB) {
+			default_joint_set_entry_count = i + 1;
+		}
+	}
+
 	singleton = this;
 }
 
@@ -178,6 +224,28 @@ OpenXRFbBodyTrackingExtensionWrapper::~OpenXRFbBodyTrackingExtensionWrapper() {
 void OpenXRFbBodyTrackingExtensionWrapper::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_full_body_tracking_supported"), &OpenXRFbBodyTrackingExtensionWrapper::is_full_body_tracking_supported);
 
+	ClassDB::bind_method(D_METHOD("set_joint_filter_enabled", "enabled"), &OpenXRFbBodyTrackingExtensionWrapper::set_joint_filter_enabled);
+	ClassDB::bind_method(D_METHOD("is_joint_filter_enabled"), &OpenXRFbBodyTrackingExtensionWrapper::is_joint_filter_enabled);
+	ClassDB::bind_method(D_METHOD("set_joint_filter_min_cutoff", "min_cutoff"), &OpenXRFbBodyTrackingExtensionWrapper::set_joint_filter_min_cutoff);
+	ClassDB::bind_method(D_METHOD("get_joint_filter_min_cutoff"), &OpenXRFbBodyTrackingExtensionWrapper::get_joint_filter_min_cutoff);
+	ClassDB::bind_method(D_METHOD("set_joint_filter_beta", "beta"), &OpenXRFbBodyTrackingExtensionWrapper::set_joint_filter_beta);
+	ClassDB::bind_method(D_METHOD("get_joint_filter_beta"), &OpenXRFbBodyTrackingExtensionWrapper::get_joint_filter_beta);
+	ClassDB::bind_method(D_METHOD("set_joint_filter_derivative_cutoff", "derivative_cutoff"), &OpenXRFbBodyTrackingExtensionWrapper::set_joint_filter_derivative_cutoff);
+	ClassDB::bind_method(D_METHOD("get_joint_filter_derivative_cutoff"), &OpenXRFbBodyTrackingExtensionWrapper::get_joint_filter_derivative_cutoff);
+	ClassDB::bind_method(D_METHOD("get_joint_linear_velocity", "joint"), &OpenXRFbBodyTrackingExtensionWrapper::get_joint_linear_velocity);
+	ClassDB::bind_method(D_METHOD("get_joint_angular_velocity", "joint"), &OpenXRFbBodyTrackingExtensionWrapper::get_joint_angular_velocity);
+
+	ClassDB::bind_method(D_METHOD("start_recording", "path"), &OpenXRFbBodyTrackingExtensionWrapper::start_recording);
+	ClassDB::bind_method(D_METHOD("stop_recording"), &OpenXRFbBodyTrackingExtensionWrapper::stop_recording);
+	ClassDB::bind_method(D_METHOD("is_recording"), &OpenXRFbBodyTrackingExtensionWrapper::is_recording);
+	ClassDB::bind_method(D_METHOD("start_replay", "path", "loop"), &OpenXRFbBodyTrackingExtensionWrapper::start_replay, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("stop_replay"), &OpenXRFbBodyTrackingExtensionWrapper::stop_replay);
+	ClassDB::bind_method(D_METHOD("is_replaying"), &OpenXRFbBodyTrackingExtensionWrapper::is_replaying);
+	ClassDB::bind_method(D_METHOD("process_replay_frame"), &OpenXRFbBodyTrackingExtensionWrapper::process_replay_frame);
+
+	ClassDB::bind_method(D_METHOD("get_process_time_histogram"), &OpenXRFbBodyTrackingExtensionWrapper::get_process_time_histogram);
+	ClassDB::bind_method(D_METHOD("reset_process_time_histogram"), &OpenXRFbBodyTrackingExtensionWrapper::reset_process_time_histogram);
+
 // @todo GH Issue 304: Remove check for meta headers when feature becomes part of OpenXR spec.
 #ifdef META_HEADERS_ENABLED
 	ClassDB::bind_method(D_METHOD("is_body_tracking_fidelity_supported"), &OpenXRFbBodyTrackingExtensionWrapper::is_body_tracking_fidelity_supported);
@@ -278,6 +346,8 @@ void OpenXRFbBodyTrackingExtensionWrapper::_on_instance_created(uint64_t p_insta
 }
 
 void OpenXRFbBodyTrackingExtensionWrapper::_on_instance_destroyed() {
+	stop_recording();
+	stop_replay();
 	cleanup();
 }
 
@@ -305,15 +375,19 @@ void OpenXRFbBodyTrackingExtensionWrapper::_on_session_created(uint64_t instance
 
 	// Construct the XRBodyTracker if necessary
 	if (xr_body_tracker.is_null()) {
-		xr_body_tracker.instantiate();
-		xr_body_tracker->set_tracker_name("/user/body_tracker");
+		create_xr_body_tracker(meta_body_tracking_full_body_ext && is_full_body_tracking_supported());
+	}
+}
 
-		BitField<XRBodyTracker::BodyFlags> body_flags = XRBodyTracker::BODY_FLAG_UPPER_BODY_SUPPORTED | XRBodyTracker::BODY_FLAG_HANDS_SUPPORTED;
-		if (meta_body_tracking_full_body_ext && is_full_body_tracking_supported()) {
-			body_flags.set_flag(XRBodyTracker::BODY_FLAG_LOWER_BODY_SUPPORTED);
-		}
-		xr_body_tracker->set_body_flags(body_flags);
+void OpenXRFbBodyTrackingExtensionWrapper::create_xr_body_tracker(bool p_lower_body_supported) {
+	xr_body_tracker.instantiate();
+	xr_body_tracker->set_tracker_name("/user/body_tracker");
+
+	BitField<XRBodyTracker::BodyFlags> body_flags = XRBodyTracker::BODY_FLAG_UPPER_BODY_SUPPORTED | XRBodyTracker::BODY_FLAG_HANDS_SUPPORTED;
+	if (p_lower_body_supported) {
+		body_flags.set_flag(XRBodyTracker::BODY_FLAG_LOWER_BODY_SUPPORTED);
 	}
+	xr_body_tracker->set_body_flags(body_flags);
 }
 
 void OpenXRFbBodyTrackingExtensionWrapper::_on_session_destroyed() {
@@ -337,9 +411,17 @@ void OpenXRFbBodyTrackingExtensionWrapper::_on_session_destroyed() {
 		}
 	}
 	xr_body_tracker_registered = false;
+
+	reset_joint_filters();
 }
 
 void OpenXRFbBodyTrackingExtensionWrapper::_on_process() {
+	// Replayed captures are driven by their recorded timeline.
+	if (is_replaying()) {
+		process_replay_frame();
+		return;
+	}
+
 	// Skip if not enabled, or no body-tracker handle
 	if (!is_enabled() || !body_tracker) {
 		return;
@@ -351,12 +433,18 @@ void OpenXRFbBodyTrackingExtensionWrapper::_on_process() {
 		return;
 	}
 
+	const uint64_t start_usec = Time::get_singleton()->get_ticks_usec();
+	process_body_joints(display_time);
+	record_process_time(Time::get_singleton()->get_ticks_usec() - start_usec);
+}
+
+void OpenXRFbBodyTrackingExtensionWrapper::process_body_joints(XrTime p_display_time) {
 	// Construct the expression info struct.
 	XrBodyJointsLocateInfoFB locate_info = {
 		XR_TYPE_BODY_JOINTS_LOCATE_INFO_FB, // type
 		nullptr, // next
 		(XrSpace)get_openxr_api()->get_play_space(), // baseSpace
-		display_time // time
+		p_display_time // time
 	};
 
 	// Construct locations struct next chain.
@@ -376,15 +464,16 @@ void OpenXRFbBodyTrackingExtensionWrapper::_on_process() {
 
     // Construct the locations struct.
     uint32_t fb_joint_count = XR_BODY_JOINT_COUNT_FB;
-    bool is_full_body_supported = is_full_body_tracking_supported();
 #ifdef META_HEADERS_ENABLED
-    if (meta_body_tracking_full_body_ext && is_full_body_supported) {
+    if (meta_body_tracking_full_body_ext && is_full_body_tracking_supported()) {
         fb_joint_count = XR_FULL_BODY_JOINT_COUNT_META;
     }
-    XrBodyJointLocationFB fb_locations[XR_FULL_BODY_JOINT_COUNT_META];
-#else
-    XrBodyJointLocationFB fb_locations[XR_BODY_JOINT_COUNT_FB];
 #endif
+	if (is_replaying()) {
+		fb_joint_count = MIN(replay_joint_count, max_joint_count);
+	}
+	const bool is_full_body_supported = fb_joint_count > XR_BODY_JOINT_COUNT_FB;
+	XrBodyJointLocationFB fb_locations[max_joint_count];
 	XrBodyJointLocationsFB locations = {
 		XR_TYPE_BODY_JOINT_LOCATIONS_FB, // type
 		next_pointer, // next
@@ -394,46 +483,26 @@ void OpenXRFbBodyTrackingExtensionWrapper::_on_process() {
 		fb_locations // jointLocations
 	};
 
-	// Read the weights
-	XrResult result = xrLocateBodyJointsFB(body_tracker, &locate_info, &locations);
-	ERR_FAIL_COND_MSG(XR_FAILED(result), vformat("Failed to get body joint locations: ", get_openxr_api()->get_error_string(result)));
+	// Read the weights, from the capture when one is being replayed.
+	if (replaying) {
+		locate_replay_body_joints(locations);
+	} else {
+		XrResult result = xrLocateBodyJointsFB(body_tracker, &locate_info, &locations);
+		ERR_FAIL_COND_MSG(XR_FAILED(result), vformat("Failed to get body joint locations: ", get_openxr_api()->get_error_string(result)));
+	}
+
+	// Capture the raw runtime data if requested
+	if (record_file.is_valid()) {
+		record_frame(p_display_time, locations);
+	}
 
 	// Set the tracking active flag
 	xr_body_tracker->set_has_tracking_data(locations.isActive);
 
-	// Process all joints
-	for (const JointMapEntry &entry : joint_table) {
-		// Skip full body joints if extension is not supported.
-		if (!is_full_body_supported && entry.fb_joint >= XR_BODY_JOINT_COUNT_FB) {
-			break;
-		}
-
-		// Process the joint pose
-		const XrBodyJointLocationFB &location = fb_locations[entry.fb_joint];
-		const XrPosef &pose = location.pose;
-		Transform3D transform;
-		BitField<XRBodyTracker::JointFlags> flags(0);
-
-		// Analyze the available joint data
-		if (location.locationFlags & XR_SPACE_LOCATION_ORIENTATION_VALID_BIT) {
-			flags.set_flag(XRBodyTracker::JOINT_FLAG_ORIENTATION_VALID);
-			transform.basis = Basis(Quaternion(pose.orientation.x, pose.orientation.y, pose.orientation.z, pose.orientation.w) * entry.rotation);
-		}
-		if (location.locationFlags & XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT) {
-			flags.set_flag(XRBodyTracker::JOINT_FLAG_ORIENTATION_TRACKED);
-		}
-		if (location.locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT) {
-			flags.set_flag(XRBodyTracker::JOINT_FLAG_POSITION_VALID);
-			transform.origin = Vector3(pose.position.x, pose.position.y, pose.position.z);
-		}
-		if (location.locationFlags & XR_SPACE_LOCATION_POSITION_TRACKED_BIT) {
-			flags.set_flag(XRBodyTracker::JOINT_FLAG_POSITION_TRACKED);
-		}
-
-		// Set the joint information
-		xr_body_tracker->set_joint_flags(entry.xr_joint, flags);
-		xr_body_tracker->set_joint_transform(entry.xr_joint, transform);
-	}
+	// Convert all joints into the joint buffers. Filter history is only
+	// accumulated while the body is actively tracked.
+	const uint32_t entry_count = is_full_body_supported ? joint_table_size : default_joint_set_entry_count;
+	convert_joint_locations(fb_locations, entry_count, locations.isActive ? p_display_time : 0);
 
 	// If the location data is good then we need to apply some corrections
 	// before handing the data back to Godot. These include:
@@ -450,16 +519,19 @@ void OpenXRFbBodyTrackingExtensionWrapper::_on_process() {
 		// (Remaining, however, parallel to the XRorigin / Global XZ plane; root's basis rotated around Y to fit)
 
 		// Get the hips transform
-		Transform3D hips = xr_body_tracker->get_joint_transform(XRBodyTracker::JOINT_HIPS);
+		const Transform3D &hips = joint_transforms[XRBodyTracker::JOINT_HIPS];
 		Vector3 root_y = Vector3(0.0, 1.0, 0.0);
 		Vector3 hips_left = hips.basis.get_column(Vector3::AXIS_X);
 		Vector3 root_x = (hips_left.slide(Vector3(0.0, 1.0, 0.0))).normalized();
 		Vector3 root_z = root_x.cross(root_y);
-		Vector3 root_o = xr_body_tracker->get_joint_transform(XRBodyTracker::JOINT_ROOT).origin;
+		Vector3 root_o = joint_transforms[XRBodyTracker::JOINT_ROOT].origin;
 		Transform3D root = Transform3D(root_x, root_y, root_z, root_o).orthonormalized();
-		xr_body_tracker->set_joint_transform(XRBodyTracker::JOINT_ROOT, root);
+		joint_transforms[XRBodyTracker::JOINT_ROOT] = root;
 		// Set tracker pose, velocities, confidence.
-		xr_body_tracker->set_pose("default", root, Vector3(), Vector3(), XRPose::XR_TRACKING_CONFIDENCE_HIGH);
+		// The root follows the hips heading, so it only rotates around Y.
+		const Vector3 root_linear_velocity = joint_filter_states[XRBodyTracker::JOINT_ROOT].linear_velocity;
+		const Vector3 root_angular_velocity = Vector3(0.0, joint_filter_states[XRBodyTracker::JOINT_HIPS].angular_velocity.y, 0.0);
+		xr_body_tracker->set_pose("default", root, root_linear_velocity, root_angular_velocity, XRPose::XR_TRACKING_CONFIDENCE_HIGH);
 
 		// Distance in meters to push the shoulder joints back from the
 		// clavicle-position to be in-line with the upper arm joints as
@@ -467,18 +539,19 @@ void OpenXRFbBodyTrackingExtensionWrapper::_on_process() {
 		constexpr float shoulder_z_offset = -0.07;
 
 		// Deduce the shoulder offset from the upper chest transform
-		Transform3D upper_chest = xr_body_tracker->get_joint_transform(XRBodyTracker::JOINT_UPPER_CHEST);
+		const Transform3D &upper_chest = joint_transforms[XRBodyTracker::JOINT_UPPER_CHEST];
 		Vector3 shoulder_offset = upper_chest.basis.get_column(Vector3::AXIS_Z) * shoulder_z_offset;
 
-		// Correct the left shoulder
-		Transform3D left_shoulder = xr_body_tracker->get_joint_transform(XRBodyTracker::JOINT_LEFT_SHOULDER);
-		left_shoulder.origin += shoulder_offset;
-		xr_body_tracker->set_joint_transform(XRBodyTracker::JOINT_LEFT_SHOULDER, left_shoulder);
+		// Correct the left and right shoulders
+		joint_transforms[XRBodyTracker::JOINT_LEFT_SHOULDER].origin += shoulder_offset;
+		joint_transforms[XRBodyTracker::JOINT_RIGHT_SHOULDER].origin += shoulder_offset;
+	}
 
-		// Correct the right shoulder
-		Transform3D right_shoulder = xr_body_tracker->get_joint_transform(XRBodyTracker::JOINT_RIGHT_SHOULDER);
-		right_shoulder.origin += shoulder_offset;
-		xr_body_tracker->set_joint_transform(XRBodyTracker::JOINT_RIGHT_SHOULDER, right_shoulder);
+	// Publish the converted joints, touching each tracker joint exactly once.
+	for (uint32_t i = 0; i < entry_count; i++) {
+		const XRBodyTracker::Joint xr_joint = joint_table[i].xr_joint;
+		xr_body_tracker->set_joint_flags(xr_joint, BitField<XRBodyTracker::JointFlags>(joint_flags[xr_joint]));
+		xr_body_tracker->set_joint_transform(xr_joint, joint_transforms[xr_joint]);
 	}
 
 	// Register the XRBodyTracker if necessary
@@ -491,6 +564,410 @@ void OpenXRFbBodyTrackingExtensionWrapper::_on_process() {
 	}
 }
 
+void OpenXRFbBodyTrackingExtensionWrapper::convert_joint_locations(const XrBodyJointLocationFB *p_locations, uint32_t p_entry_count, XrTime p_time) {
+	JointConversionBuffers &buffers = joint_buffers;
+
+	// Gather the runtime joint locations into table order.
+	for (uint32_t i = 0; i < p_entry_count; i++) {
+		const XrBodyJointLocationFB &location = p_locations[joint_table[i].fb_joint];
+		buffers.location_flags[i] = uint32_t(location.locationFlags);
+		buffers.position_x[i] = location.pose.position.x;
+		buffers.position_y[i] = location.pose.position.y;
+		buffers.position_z[i] = location.pose.position.z;
+		buffers.orientation_x[i] = location.pose.orientation.x;
+		buffers.orientation_y[i] = location.pose.orientation.y;
+		buffers.orientation_z[i] = location.pose.orientation.z;
+		buffers.orientation_w[i] = location.pose.orientation.w;
+	}
+
+	// Apply the correction rotations (orientation * correction) to all joints
+	// in a single branch-free pass the compiler can vectorize.
+	for (uint32_t i = 0; i < p_entry_count; i++) {
+		const real_t x = buffers.orientation_x[i];
+		const real_t y = buffers.orientation_y[i];
+		const real_t z = buffers.orientation_z[i];
+		const real_t w = buffers.orientation_w[i];
+		const real_t cx = buffers.correction_x[i];
+		const real_t cy = buffers.correction_y[i];
+		const real_t cz = buffers.correction_z[i];
+		const real_t cw = buffers.correction_w[i];
+		buffers.orientation_x[i] = w * cx + x * cw + y * cz - z * cy;
+		buffers.orientation_y[i] = w * cy + y * cw + z * cx - x * cz;
+		buffers.orientation_z[i] = w * cz + z * cw + x * cy - y * cx;
+		buffers.orientation_w[i] = w * cw - x * cx - y * cy - z * cz;
+	}
+
+	// Update the joint history, velocities and filtered poses.
+	if (p_time != 0) {
+		filter_joints(p_entry_count, p_time);
+	} else {
+		reset_joint_filters();
+	}
+
+	// Scatter the results into the Godot joint slots.
+	for (uint32_t i = 0; i < p_entry_count; i++) {
+		const XRBodyTracker::Joint xr_joint = joint_table[i].xr_joint;
+		const uint32_t location_flags = buffers.location_flags[i];
+		Transform3D &transform = joint_transforms[xr_joint];
+		int64_t flags = 0;
+
+		// Analyze the available joint data
+		if (location_flags & XR_SPACE_LOCATION_ORIENTATION_VALID_BIT) {
+			flags |= XRBodyTracker::JOINT_FLAG_ORIENTATION_VALID;
+			transform.basis = Basis(Quaternion(buffers.orientation_x[i], buffers.orientation_y[i], buffers.orientation_z[i], buffers.orientation_w[i]));
+		} else {
+			transform.basis = Basis();
+		}
+		if (location_flags & XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT) {
+			flags |= XRBodyTracker::JOINT_FLAG_ORIENTATION_TRACKED;
+		}
+		if (location_flags & XR_SPACE_LOCATION_POSITION_VALID_BIT) {
+			flags |= XRBodyTracker::JOINT_FLAG_POSITION_VALID;
+			transform.origin = Vector3(buffers.position_x[i], buffers.position_y[i], buffers.position_z[i]);
+		} else {
+			transform.origin = Vector3();
+		}
+		if (location_flags & XR_SPACE_LOCATION_POSITION_TRACKED_BIT) {
+			flags |= XRBodyTracker::JOINT_FLAG_POSITION_TRACKED;
+		}
+
+		joint_flags[xr_joint] = flags;
+	}
+}
+
+void OpenXRFbBodyTrackingExtensionWrapper::filter_joints(uint32_t p_entry_count, XrTime p_time) {
+	JointConversionBuffers &buffers = joint_buffers;
+
+	const real_t delta = (last_filter_time != 0 && p_time > last_filter_time) ? real_t(p_time - last_filter_time) * 1e-9 : 0.0;
+	last_filter_time = p_time;
+
+	const real_t derivative_alpha = delta > 0.0 ? one_euro_alpha(joint_filter_derivative_cutoff, delta) : 1.0;
+	constexpr uint32_t pose_valid_bits = XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_VALID_BIT;
+
+	for (uint32_t i = 0; i < p_entry_count; i++) {
+		JointFilterState &state = joint_filter_states[joint_table[i].xr_joint];
+
+		// Invalid poses break the history.
+		if ((buffers.location_flags[i] & pose_valid_bits) != pose_valid_bits) {
+			state = JointFilterState();
+			continue;
+		}
+
+		const Vector3 position = Vector3(buffers.position_x[i], buffers.position_y[i], buffers.position_z[i]);
+		const Quaternion orientation = Quaternion(buffers.orientation_x[i], buffers.orientation_y[i], buffers.orientation_z[i], buffers.orientation_w[i]);
+
+		if (state.history.count == 0 || delta <= 0.0 || !joint_filter_enabled) {
+			state.filtered_position = position;
+			state.filtered_orientation = orientation;
+			state.filtered_linear_speed = Vector3();
+			state.filtered_angular_speed = 0.0;
+		} else {
+			// One-Euro filter: the cutoff frequency rises with the (smoothed)
+			// speed, trading jitter reduction at rest for low lag in motion.
+			const Vector3 linear_speed = (position - state.filtered_position) / delta;
+			state.filtered_linear_speed = state.filtered_linear_speed.lerp(linear_speed, derivative_alpha);
+			const real_t position_cutoff = joint_filter_min_cutoff + joint_filter_beta * state.filtered_linear_speed.length();
+			state.filtered_position = state.filtered_position.lerp(position, one_euro_alpha(position_cutoff, delta));
+
+			const real_t angular_speed = rotation_delta(state.filtered_orientation, orientation).length() / delta;
+			state.filtered_angular_speed = Math::lerp(state.filtered_angular_speed, angular_speed, derivative_alpha);
+			const real_t orientation_cutoff = joint_filter_min_cutoff + joint_filter_beta * state.filtered_angular_speed;
+			state.filtered_orientation = state.filtered_orientation.slerp(orientation, one_euro_alpha(orientation_cutoff, delta)).normalized();
+		}
+
+		// Finite-difference velocity over the recent filtered poses.
+		state.history.push(state.filtered_position, state.filtered_orientation, p_time);
+		state.history.get_velocities(state.linear_velocity, state.angular_velocity);
+
+		// Write the filtered pose back for conversion.
+		buffers.position_x[i] = state.filtered_position.x;
+		buffers.position_y[i] = state.filtered_position.y;
+		buffers.position_z[i] = state.filtered_position.z;
+		buffers.orientation_x[i] = state.filtered_orientation.x;
+		buffers.orientation_y[i] = state.filtered_orientation.y;
+		buffers.orientation_z[i] = state.filtered_orientation.z;
+		buffers.orientation_w[i] = state.filtered_orientation.w;
+	}
+}
+
+void OpenXRFbBodyTrackingExtensionWrapper::reset_joint_filters() {
+	for (JointFilterState &state : joint_filter_states) {
+		state = JointFilterState();
+	}
+	last_filter_time = 0;
+}
+
+void OpenXRFbBodyTrackingExtensionWrapper::set_joint_filter_enabled(bool p_enabled) {
+	joint_filter_enabled = p_enabled;
+}
+
+bool OpenXRFbBodyTrackingExtensionWrapper::is_joint_filter_enabled() const {
+	return joint_filter_enabled;
+}
+
+void OpenXRFbBodyTrackingExtensionWrapper::set_joint_filter_min_cutoff(float p_min_cutoff) {
+	ERR_FAIL_COND_MSG(p_min_cutoff <= 0.0, "Joint filter minimum cutoff must be greater than zero");
+	joint_filter_min_cutoff = p_min_cutoff;
+}
+
+float OpenXRFbBodyTrackingExtensionWrapper::get_joint_filter_min_cutoff() const {
+	return joint_filter_min_cutoff;
+}
+
+void OpenXRFbBodyTrackingExtensionWrapper::set_joint_filter_beta(float p_beta) {
+	ERR_FAIL_COND_MSG(p_beta < 0.0, "Joint filter beta must not be negative");
+	joint_filter_beta = p_beta;
+}
+
+float OpenXRFbBodyTrackingExtensionWrapper::get_joint_filter_beta() const {
+	return joint_filter_beta;
+}
+
+void OpenXRFbBodyTrackingExtensionWrapper::set_joint_filter_derivative_cutoff(float p_derivative_cutoff) {
+	ERR_FAIL_COND_MSG(p_derivative_cutoff <= 0.0, "Joint filter derivative cutoff must be greater than zero");
+	joint_filter_derivative_cutoff = p_derivative_cutoff;
+}
+
+float OpenXRFbBodyTrackingExtensionWrapper::get_joint_filter_derivative_cutoff() const {
+	return joint_filter_derivative_cutoff;
+}
+
+Vector3 OpenXRFbBodyTrackingExtensionWrapper::get_joint_linear_velocity(XRBodyTracker::Joint p_joint) const {
+	ERR_FAIL_INDEX_V(p_joint, XRBodyTracker::JOINT_MAX, Vector3());
+	return joint_filter_states[p_joint].linear_velocity;
+}
+
+Vector3 OpenXRFbBodyTrackingExtensionWrapper::get_joint_angular_velocity(XRBodyTracker::Joint p_joint) const {
+	ERR_FAIL_INDEX_V(p_joint, XRBodyTracker::JOINT_MAX, Vector3());
+	return joint_filter_states[p_joint].angular_velocity;
+}
+
+void OpenXRFbBodyTrackingExtensionWrapper::record_process_time(uint64_t p_usec) {
+	// Bucket 0 holds sub-microsecond frames, bucket i holds [2^(i-1), 2^i) microseconds.
+	uint32_t bucket = 0;
+	while (p_usec > 0 && bucket < PROCESS_TIME_HISTOGRAM_SIZE - 1) {
+		p_usec >>= 1;
+		bucket++;
+	}
+	process_time_histogram[bucket]++;
+}
+
+PackedInt64Array OpenXRFbBodyTrackingExtensionWrapper::get_process_time_histogram() const {
+	PackedInt64Array histogram;
+	histogram.resize(PROCESS_TIME_HISTOGRAM_SIZE);
+	int64_t *histogram_ptr = histogram.ptrw();
+	for (uint32_t i = 0; i < PROCESS_TIME_HISTOGRAM_SIZE; i++) {
+		histogram_ptr[i] = int64_t(process_time_histogram[i]);
+	}
+	return histogram;
+}
+
+void OpenXRFbBodyTrackingExtensionWrapper::reset_process_time_histogram() {
+	for (uint64_t &count : process_time_histogram) {
+		count = 0;
+	}
+}
+
+Error OpenXRFbBodyTrackingExtensionWrapper::start_recording(const String &p_path) {
+	ERR_FAIL_COND_V_MSG(is_replaying(), ERR_BUSY, "Cannot record body tracking while a capture is being replayed");
+	stop_recording();
+
+	Error error = OK;
+	record_file = FileAccess::open(p_path, FileAccess::WRITE);
+	if (record_file.is_null()) {
+		error = FileAccess::get_open_error();
+		ERR_FAIL_V_MSG(error, vformat("Failed to open body tracking capture for writing: %s", p_path));
+	}
+
+	// The joint count is fixed at the start of the capture.
+	uint32_t joint_count = XR_BODY_JOINT_COUNT_FB;
+#ifdef META_HEADERS_ENABLED
+	if (meta_body_tracking_full_body_ext && is_full_body_tracking_supported()) {
+		joint_count = XR_FULL_BODY_JOINT_COUNT_META;
+	}
+#endif
+
+	PackedByteArray header;
+	header.resize(capture_header_size);
+	uint8_t *header_ptr = header.ptrw();
+	memcpy(header_ptr, capture_magic, 4);
+	memcpy(header_ptr + 4, &capture_version, 4);
+	memcpy(header_ptr + 8, &joint_count, 4);
+	record_file->store_buffer(header);
+
+	record_joint_count = joint_count;
+	record_frame_buffer.resize(capture_frame_header_size + joint_count * capture_joint_size);
+
+	return OK;
+}
+
+void OpenXRFbBodyTrackingExtensionWrapper::stop_recording() {
+	if (record_file.is_valid()) {
+		record_file->close();
+		record_file.unref();
+	}
+	record_frame_buffer.clear();
+}
+
+bool OpenXRFbBodyTrackingExtensionWrapper::is_recording() const {
+	return record_file.is_valid();
+}
+
+void OpenXRFbBodyTrackingExtensionWrapper::record_frame(XrTime p_time, const XrBodyJointLocationsFB &p_locations) {
+	if (p_locations.jointCount != record_joint_count) {
+		// Stop rather than failing on every tracked frame.
+		const uint32_t joint_count = record_joint_count;
+		stop_recording();
+		ERR_FAIL_MSG(vformat("Body tracking joint count changed from %d to %d, stopping the recording", joint_count, p_locations.jointCount));
+	}
+
+	// Serialize into the preallocated frame buffer and write it in one go.
+	uint8_t *ptr = record_frame_buffer.ptrw();
+	const int64_t time = p_time;
+	const uint32_t is_active = p_locations.isActive;
+	const float confidence = p_locations.confidence;
+	memcpy(ptr, &time, 8);
+	memcpy(ptr + 8, &is_active, 4);
+	memcpy(ptr + 12, &confidence, 4);
+	ptr += capture_frame_header_size;
+
+	for (uint32_t i = 0; i < record_joint_count; i++) {
+		const XrBodyJointLocationFB &location = p_locations.jointLocations[i];
+		const uint64_t location_flags = location.locationFlags;
+		const float pose[7] = {
+			location.pose.position.x,
+			location.pose.position.y,
+			location.pose.position.z,
+			location.pose.orientation.x,
+			location.pose.orientation.y,
+			location.pose.orientation.z,
+			location.pose.orientation.w,
+		};
+		memcpy(ptr, &location_flags, 8);
+		memcpy(ptr + 8, pose, sizeof(pose));
+		ptr += capture_joint_size;
+	}
+
+	record_file->store_buffer(record_frame_buffer);
+}
+
+Error OpenXRFbBodyTrackingExtensionWrapper::start_replay(const String &p_path, bool p_loop) {
+	ERR_FAIL_COND_V_MSG(is_recording(), ERR_BUSY, "Cannot replay a body tracking capture while recording");
+	stop_replay();
+
+	ERR_FAIL_COND_V_MSG(!FileAccess::file_exists(p_path), ERR_FILE_NOT_FOUND, vformat("Body tracking capture not found: %s", p_path));
+	const PackedByteArray data = FileAccess::get_file_as_bytes(p_path);
+	ERR_FAIL_COND_V_MSG(uint64_t(data.size()) < capture_header_size, ERR_FILE_CORRUPT, "Body tracking capture is truncated");
+
+	// Validate the header.
+	const uint8_t *ptr = data.ptr();
+	uint32_t version = 0;
+	uint32_t joint_count = 0;
+	memcpy(&version, ptr + 4, 4);
+	memcpy(&joint_count, ptr + 8, 4);
+	ERR_FAIL_COND_V_MSG(memcmp(ptr, capture_magic, 4) != 0, ERR_FILE_UNRECOGNIZED, "File is not a body tracking capture");
+	ERR_FAIL_COND_V_MSG(version != capture_version, ERR_FILE_UNRECOGNIZED, vformat("Unsupported body tracking capture version: %d", version));
+	ERR_FAIL_COND_V_MSG(joint_count < XR_BODY_JOINT_COUNT_FB || joint_count > max_joint_count, ERR_FILE_CORRUPT, vformat("Unsupported body tracking capture joint count: %d", joint_count));
+
+	const uint64_t frame_size = capture_frame_header_size + joint_count * capture_joint_size;
+	const uint64_t frame_count = (uint64_t(data.size()) - capture_header_size) / frame_size;
+	ERR_FAIL_COND_V_MSG(frame_count == 0, ERR_FILE_CORRUPT, "Body tracking capture contains no frames");
+
+	// Unpack all frames up front so replay does no file access or allocation.
+	replay_frames.resize(frame_count);
+	replay_joints.resize(frame_count * joint_count);
+	ptr += capture_header_size;
+	for (uint64_t frame = 0; frame < frame_count; frame++) {
+		ReplayFrame &replay_frame = replay_frames[frame];
+		int64_t time = 0;
+		uint32_t is_active = 0;
+		memcpy(&time, ptr, 8);
+		memcpy(&is_active, ptr + 8, 4);
+		memcpy(&replay_frame.confidence, ptr + 12, 4);
+		replay_frame.time = time;
+		replay_frame.is_active = is_active != 0;
+		ptr += capture_frame_header_size;
+
+		for (uint32_t i = 0; i < joint_count; i++) {
+			XrBodyJointLocationFB &location = replay_joints[frame * joint_count + i];
+			uint64_t location_flags = 0;
+			float pose[7];
+			memcpy(&location_flags, ptr, 8);
+			memcpy(pose, ptr + 8, sizeof(pose));
+			location.locationFlags = location_flags;
+			location.pose.position = { pose[0], pose[1], pose[2] };
+			location.pose.orientation = { pose[3], pose[4], pose[5], pose[6] };
+			ptr += capture_joint_size;
+		}
+	}
+
+	replay_joint_count = joint_count;
+	replay_frame_index = 0;
+	replay_loop = p_loop;
+
+	replaying = true;
+
+	reset_joint_filters();
+	return OK;
+}
+
+void OpenXRFbBodyTrackingExtensionWrapper::stop_replay() {
+	if (!replaying) {
+		return;
+	}
+
+	replaying = false;
+
+	replay_frames.clear();
+	replay_joints.clear();
+	replay_joint_count = 0;
+	replay_frame_index = 0;
+
+	reset_joint_filters();
+}
+
+bool OpenXRFbBodyTrackingExtensionWrapper::is_replaying() const {
+	return replaying;
+}
+
+bool OpenXRFbBodyTrackingExtensionWrapper::process_replay_frame() {
+	ERR_FAIL_COND_V_MSG(!is_replaying(), false, "No body tracking capture is being replayed");
+
+	// Replay works without an OpenXR session, so make sure there is a tracker to publish to.
+	if (xr_body_tracker.is_null()) {
+		create_xr_body_tracker(replay_joint_count > XR_BODY_JOINT_COUNT_FB);
+	}
+
+	const uint64_t start_usec = Time::get_singleton()->get_ticks_usec();
+	process_body_joints(replay_frames[replay_frame_index].time);
+	record_process_time(Time::get_singleton()->get_ticks_usec() - start_usec);
+
+	// Advance to the next frame.
+	replay_frame_index++;
+	if (replay_frame_index >= replay_frames.size()) {
+		if (!replay_loop) {
+			stop_replay();
+			return false;
+		}
+
+		// Time jumps backwards, so restart the joint history.
+		replay_frame_index = 0;
+		reset_joint_filters();
+	}
+
+	return true;
+}
+
+void OpenXRFbBodyTrackingExtensionWrapper::locate_replay_body_joints(XrBodyJointLocationsFB &r_locations) const {
+	const ReplayFrame &replay_frame = replay_frames[replay_frame_index];
+	const XrBodyJointLocationFB *joints = replay_joints.ptr() + replay_frame_index * replay_joint_count;
+	const uint32_t joint_count = MIN(r_locations.jointCount, replay_joint_count);
+
+	r_locations.isActive = replay_frame.is_active;
+	r_locations.confidence = replay_frame.confidence;
+	memcpy(r_locations.jointLocations, joints, joint_count * sizeof(XrBodyJointLocationFB));
+}
+
 bool OpenXRFbBodyTrackingExtensionWrapper::is_enabled() const {
 	return fb_body_tracking_ext && system_body_tracking_properties.supportsBodyTracking;
 }
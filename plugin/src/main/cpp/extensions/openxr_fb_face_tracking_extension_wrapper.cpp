@@ -36,11 +36,185 @@
 
 using namespace godot;
 
-// Calculate the average of two floating point values
-static inline constexpr float average(float a, float b) {
-	return (a + b) * 0.5f;
+/// Sparse Meta to Godot blend shape remap matrix, as a list of non-zero
+/// terms. Blended shapes are expanded into their source expressions, and
+/// shapes not measured by XR_FB_face_tracking2 have no terms (always zero).
+static constexpr FaceExpressionMapper::Term face_remap_terms[] = {
+	// Base Shapes
+	{ XRFaceTracker::FT_EYE_LOOK_OUT_RIGHT, XR_FACE_EXPRESSION2_EYES_LOOK_RIGHT_R_FB, 1.0f },
+	{ XRFaceTracker::FT_EYE_LOOK_IN_RIGHT, XR_FACE_EXPRESSION2_EYES_LOOK_LEFT_R_FB, 1.0f },
+	{ XRFaceTracker::FT_EYE_LOOK_UP_RIGHT, XR_FACE_EXPRESSION2_EYES_LOOK_UP_R_FB, 1.0f },
+	{ XRFaceTracker::FT_EYE_LOOK_DOWN_RIGHT, XR_FACE_EXPRESSION2_EYES_LOOK_DOWN_R_FB, 1.0f },
+	{ XRFaceTracker::FT_EYE_LOOK_OUT_LEFT, XR_FACE_EXPRESSION2_EYES_LOOK_LEFT_L_FB, 1.0f },
+	{ XRFaceTracker::FT_EYE_LOOK_IN_LEFT, XR_FACE_EXPRESSION2_EYES_LOOK_RIGHT_L_FB, 1.0f },
+	{ XRFaceTracker::FT_EYE_LOOK_UP_LEFT, XR_FACE_EXPRESSION2_EYES_LOOK_UP_L_FB, 1.0f },
+	{ XRFaceTracker::FT_EYE_LOOK_DOWN_LEFT, XR_FACE_EXPRESSION2_EYES_LOOK_DOWN_L_FB, 1.0f },
+	{ XRFaceTracker::FT_EYE_CLOSED_RIGHT, XR_FACE_EXPRESSION2_EYES_CLOSED_R_FB, 1.0f },
+	{ XRFaceTracker::FT_EYE_CLOSED_LEFT, XR_FACE_EXPRESSION2_EYES_CLOSED_L_FB, 1.0f },
+	{ XRFaceTracker::FT_EYE_SQUINT_RIGHT, XR_FACE_EXPRESSION2_LID_TIGHTENER_R_FB, 1.0f },
+	{ XRFaceTracker::FT_EYE_SQUINT_LEFT, XR_FACE_EXPRESSION2_LID_TIGHTENER_L_FB, 1.0f },
+	{ XRFaceTracker::FT_EYE_WIDE_RIGHT, XR_FACE_EXPRESSION2_UPPER_LID_RAISER_R_FB, 1.0f },
+	{ XRFaceTracker::FT_EYE_WIDE_LEFT, XR_FACE_EXPRESSION2_UPPER_LID_RAISER_L_FB, 1.0f },
+	{ XRFaceTracker::FT_BROW_LOWERER_RIGHT, XR_FACE_EXPRESSION2_BROW_LOWERER_R_FB, 1.0f },
+	{ XRFaceTracker::FT_BROW_LOWERER_LEFT, XR_FACE_EXPRESSION2_BROW_LOWERER_L_FB, 1.0f },
+	{ XRFaceTracker::FT_BROW_INNER_UP_RIGHT, XR_FACE_EXPRESSION2_INNER_BROW_RAISER_R_FB, 1.0f },
+	{ XRFaceTracker::FT_BROW_INNER_UP_LEFT, XR_FACE_EXPRESSION2_INNER_BROW_RAISER_L_FB, 1.0f },
+	{ XRFaceTracker::FT_BROW_OUTER_UP_RIGHT, XR_FACE_EXPRESSION2_OUTER_BROW_RAISER_R_FB, 1.0f },
+	{ XRFaceTracker::FT_BROW_OUTER_UP_LEFT, XR_FACE_EXPRESSION2_OUTER_BROW_RAISER_L_FB, 1.0f },
+	{ XRFaceTracker::FT_NOSE_SNEER_RIGHT, XR_FACE_EXPRESSION2_NOSE_WRINKLER_R_FB, 1.0f },
+	{ XRFaceTracker::FT_NOSE_SNEER_LEFT, XR_FACE_EXPRESSION2_NOSE_WRINKLER_L_FB, 1.0f },
+	{ XRFaceTracker::FT_CHEEK_SQUINT_RIGHT, XR_FACE_EXPRESSION2_CHEEK_RAISER_R_FB, 1.0f },
+	{ XRFaceTracker::FT_CHEEK_SQUINT_LEFT, XR_FACE_EXPRESSION2_CHEEK_RAISER_L_FB, 1.0f },
+	{ XRFaceTracker::FT_CHEEK_PUFF_RIGHT, XR_FACE_EXPRESSION2_CHEEK_PUFF_R_FB, 1.0f },
+	{ XRFaceTracker::FT_CHEEK_PUFF_LEFT, XR_FACE_EXPRESSION2_CHEEK_PUFF_L_FB, 1.0f },
+	{ XRFaceTracker::FT_CHEEK_SUCK_RIGHT, XR_FACE_EXPRESSION2_CHEEK_SUCK_R_FB, 1.0f },
+	{ XRFaceTracker::FT_CHEEK_SUCK_LEFT, XR_FACE_EXPRESSION2_CHEEK_SUCK_L_FB, 1.0f },
+	{ XRFaceTracker::FT_JAW_OPEN, XR_FACE_EXPRESSION2_JAW_DROP_FB, 1.0f },
+	{ XRFaceTracker::FT_MOUTH_CLOSED, XR_FACE_EXPRESSION2_LIPS_TOWARD_FB, 1.0f },
+	{ XRFaceTracker::FT_JAW_RIGHT, XR_FACE_EXPRESSION2_JAW_SIDEWAYS_RIGHT_FB, 1.0f },
+	{ XRFaceTracker::FT_JAW_LEFT, XR_FACE_EXPRESSION2_JAW_SIDEWAYS_LEFT_FB, 1.0f },
+	{ XRFaceTracker::FT_JAW_FORWARD, XR_FACE_EXPRESSION2_JAW_THRUST_FB, 1.0f },
+	{ XRFaceTracker::FT_LIP_SUCK_UPPER_RIGHT, XR_FACE_EXPRESSION2_LIP_SUCK_RT_FB, 1.0f },
+	{ XRFaceTracker::FT_LIP_SUCK_UPPER_LEFT, XR_FACE_EXPRESSION2_LIP_SUCK_LT_FB, 1.0f },
+	{ XRFaceTracker::FT_LIP_SUCK_LOWER_RIGHT, XR_FACE_EXPRESSION2_LIP_SUCK_RB_FB, 1.0f },
+	{ XRFaceTracker::FT_LIP_SUCK_LOWER_LEFT, XR_FACE_EXPRESSION2_LIP_SUCK_LB_FB, 1.0f },
+	{ XRFaceTracker::FT_LIP_FUNNEL_UPPER_RIGHT, XR_FACE_EXPRESSION2_LIP_FUNNELER_RT_FB, 1.0f },
+	{ XRFaceTracker::FT_LIP_FUNNEL_UPPER_LEFT, XR_FACE_EXPRESSION2_LIP_FUNNELER_LT_FB, 1.0f },
+	{ XRFaceTracker::FT_LIP_FUNNEL_LOWER_RIGHT, XR_FACE_EXPRESSION2_LIP_FUNNELER_RB_FB, 1.0f },
+	{ XRFaceTracker::FT_LIP_FUNNEL_LOWER_LEFT, XR_FACE_EXPRESSION2_LIP_FUNNELER_LB_FB, 1.0f },
+	{ XRFaceTracker::FT_LIP_PUCKER_UPPER_RIGHT, XR_FACE_EXPRESSION2_LIP_PUCKER_R_FB, 1.0f },
+	{ XRFaceTracker::FT_LIP_PUCKER_UPPER_LEFT, XR_FACE_EXPRESSION2_LIP_PUCKER_L_FB, 1.0f },
+	{ XRFaceTracker::FT_LIP_PUCKER_LOWER_RIGHT, XR_FACE_EXPRESSION2_LIP_PUCKER_R_FB, 1.0f },
+	{ XRFaceTracker::FT_LIP_PUCKER_LOWER_LEFT, XR_FACE_EXPRESSION2_LIP_PUCKER_L_FB, 1.0f },
+	{ XRFaceTracker::FT_MOUTH_UPPER_UP_RIGHT, XR_FACE_EXPRESSION2_UPPER_LIP_RAISER_R_FB, 1.0f },
+	{ XRFaceTracker::FT_MOUTH_UPPER_UP_LEFT, XR_FACE_EXPRESSION2_UPPER_LIP_RAISER_L_FB, 1.0f },
+	{ XRFaceTracker::FT_MOUTH_LOWER_DOWN_RIGHT, XR_FACE_EXPRESSION2_LOWER_LIP_DEPRESSOR_R_FB, 1.0f },
+	{ XRFaceTracker::FT_MOUTH_LOWER_DOWN_LEFT, XR_FACE_EXPRESSION2_LOWER_LIP_DEPRESSOR_L_FB, 1.0f },
+	{ XRFaceTracker::FT_MOUTH_CORNER_PULL_RIGHT, XR_FACE_EXPRESSION2_LIP_CORNER_PULLER_R_FB, 1.0f },
+	{ XRFaceTracker::FT_MOUTH_CORNER_PULL_LEFT, XR_FACE_EXPRESSION2_LIP_CORNER_PULLER_L_FB, 1.0f },
+	{ XRFaceTracker::FT_MOUTH_FROWN_RIGHT, XR_FACE_EXPRESSION2_LIP_CORNER_DEPRESSOR_R_FB, 1.0f },
+	{ XRFaceTracker::FT_MOUTH_FROWN_LEFT, XR_FACE_EXPRESSION2_LIP_CORNER_DEPRESSOR_L_FB, 1.0f },
+	{ XRFaceTracker::FT_MOUTH_STRETCH_RIGHT, XR_FACE_EXPRESSION2_LIP_STRETCHER_R_FB, 1.0f },
+	{ XRFaceTracker::FT_MOUTH_STRETCH_LEFT, XR_FACE_EXPRESSION2_LIP_STRETCHER_L_FB, 1.0f },
+	{ XRFaceTracker::FT_MOUTH_DIMPLE_RIGHT, XR_FACE_EXPRESSION2_DIMPLER_R_FB, 1.0f },
+	{ XRFaceTracker::FT_MOUTH_DIMPLE_LEFT, XR_FACE_EXPRESSION2_DIMPLER_L_FB, 1.0f },
+	{ XRFaceTracker::FT_MOUTH_RAISER_UPPER, XR_FACE_EXPRESSION2_CHIN_RAISER_T_FB, 1.0f },
+	{ XRFaceTracker::FT_MOUTH_RAISER_LOWER, XR_FACE_EXPRESSION2_CHIN_RAISER_B_FB, 1.0f },
+	{ XRFaceTracker::FT_MOUTH_PRESS_RIGHT, XR_FACE_EXPRESSION2_LIP_PRESSOR_R_FB, 1.0f },
+	{ XRFaceTracker::FT_MOUTH_PRESS_LEFT, XR_FACE_EXPRESSION2_LIP_PRESSOR_L_FB, 1.0f },
+	{ XRFaceTracker::FT_MOUTH_TIGHTENER_RIGHT, XR_FACE_EXPRESSION2_LIP_TIGHTENER_R_FB, 1.0f },
+	{ XRFaceTracker::FT_MOUTH_TIGHTENER_LEFT, XR_FACE_EXPRESSION2_LIP_TIGHTENER_L_FB, 1.0f },
+	{ XRFaceTracker::FT_TONGUE_OUT, XR_FACE_EXPRESSION2_TONGUE_OUT_FB, 1.0f },
+	{ XRFaceTracker::FT_TONGUE_FLAT, XR_FACE_EXPRESSION2_TONGUE_RETREAT_FB, 1.0f },
+
+	// Blended Shapes
+	{ XRFaceTracker::FT_EYE_CLOSED, XR_FACE_EXPRESSION2_EYES_CLOSED_R_FB, 0.5f },
+	{ XRFaceTracker::FT_EYE_CLOSED, XR_FACE_EXPRESSION2_EYES_CLOSED_L_FB, 0.5f },
+	{ XRFaceTracker::FT_EYE_WIDE, XR_FACE_EXPRESSION2_UPPER_LID_RAISER_R_FB, 0.5f },
+	{ XRFaceTracker::FT_EYE_WIDE, XR_FACE_EXPRESSION2_UPPER_LID_RAISER_L_FB, 0.5f },
+	{ XRFaceTracker::FT_EYE_SQUINT, XR_FACE_EXPRESSION2_LID_TIGHTENER_R_FB, 0.5f },
+	{ XRFaceTracker::FT_EYE_SQUINT, XR_FACE_EXPRESSION2_LID_TIGHTENER_L_FB, 0.5f },
+	{ XRFaceTracker::FT_BROW_DOWN_RIGHT, XR_FACE_EXPRESSION2_BROW_LOWERER_R_FB, 1.0f },
+	{ XRFaceTracker::FT_BROW_DOWN_LEFT, XR_FACE_EXPRESSION2_BROW_LOWERER_L_FB, 1.0f },
+	{ XRFaceTracker::FT_BROW_DOWN, XR_FACE_EXPRESSION2_BROW_LOWERER_R_FB, 0.5f },
+	{ XRFaceTracker::FT_BROW_DOWN, XR_FACE_EXPRESSION2_BROW_LOWERER_L_FB, 0.5f },
+	{ XRFaceTracker::FT_BROW_UP_RIGHT, XR_FACE_EXPRESSION2_INNER_BROW_RAISER_R_FB, 0.5f },
+	{ XRFaceTracker::FT_BROW_UP_RIGHT, XR_FACE_EXPRESSION2_OUTER_BROW_RAISER_R_FB, 0.5f },
+	{ XRFaceTracker::FT_BROW_UP_LEFT, XR_FACE_EXPRESSION2_INNER_BROW_RAISER_L_FB, 0.5f },
+	{ XRFaceTracker::FT_BROW_UP_LEFT, XR_FACE_EXPRESSION2_OUTER_BROW_RAISER_L_FB, 0.5f },
+	{ XRFaceTracker::FT_BROW_UP, XR_FACE_EXPRESSION2_INNER_BROW_RAISER_R_FB, 0.25f },
+	{ XRFaceTracker::FT_BROW_UP, XR_FACE_EXPRESSION2_OUTER_BROW_RAISER_R_FB, 0.25f },
+	{ XRFaceTracker::FT_BROW_UP, XR_FACE_EXPRESSION2_INNER_BROW_RAISER_L_FB, 0.25f },
+	{ XRFaceTracker::FT_BROW_UP, XR_FACE_EXPRESSION2_OUTER_BROW_RAISER_L_FB, 0.25f },
+	{ XRFaceTracker::FT_NOSE_SNEER, XR_FACE_EXPRESSION2_NOSE_WRINKLER_R_FB, 0.5f },
+	{ XRFaceTracker::FT_NOSE_SNEER, XR_FACE_EXPRESSION2_NOSE_WRINKLER_L_FB, 0.5f },
+	{ XRFaceTracker::FT_CHEEK_PUFF, XR_FACE_EXPRESSION2_CHEEK_PUFF_R_FB, 0.5f },
+	{ XRFaceTracker::FT_CHEEK_PUFF, XR_FACE_EXPRESSION2_CHEEK_PUFF_L_FB, 0.5f },
+	{ XRFaceTracker::FT_CHEEK_SUCK, XR_FACE_EXPRESSION2_CHEEK_SUCK_R_FB, 0.5f },
+	{ XRFaceTracker::FT_CHEEK_SUCK, XR_FACE_EXPRESSION2_CHEEK_SUCK_L_FB, 0.5f },
+	{ XRFaceTracker::FT_CHEEK_SQUINT, XR_FACE_EXPRESSION2_CHEEK_RAISER_R_FB, 0.5f },
+	{ XRFaceTracker::FT_CHEEK_SQUINT, XR_FACE_EXPRESSION2_CHEEK_RAISER_L_FB, 0.5f },
+	{ XRFaceTracker::FT_LIP_SUCK_UPPER, XR_FACE_EXPRESSION2_LIP_SUCK_RT_FB, 0.5f },
+	{ XRFaceTracker::FT_LIP_SUCK_UPPER, XR_FACE_EXPRESSION2_LIP_SUCK_LT_FB, 0.5f },
+	{ XRFaceTracker::FT_LIP_SUCK_LOWER, XR_FACE_EXPRESSION2_LIP_SUCK_RB_FB, 0.5f },
+	{ XRFaceTracker::FT_LIP_SUCK_LOWER, XR_FACE_EXPRESSION2_LIP_SUCK_LB_FB, 0.5f },
+	{ XRFaceTracker::FT_LIP_SUCK, XR_FACE_EXPRESSION2_LIP_SUCK_RT_FB, 0.25f },
+	{ XRFaceTracker::FT_LIP_SUCK, XR_FACE_EXPRESSION2_LIP_SUCK_LT_FB, 0.25f },
+	{ XRFaceTracker::FT_LIP_SUCK, XR_FACE_EXPRESSION2_LIP_SUCK_RB_FB, 0.25f },
+	{ XRFaceTracker::FT_LIP_SUCK, XR_FACE_EXPRESSION2_LIP_SUCK_LB_FB, 0.25f },
+	{ XRFaceTracker::FT_LIP_FUNNEL_UPPER, XR_FACE_EXPRESSION2_LIP_FUNNELER_RT_FB, 0.5f },
+	{ XRFaceTracker::FT_LIP_FUNNEL_UPPER, XR_FACE_EXPRESSION2_LIP_FUNNELER_LT_FB, 0.5f },
+	{ XRFaceTracker::FT_LIP_FUNNEL_LOWER, XR_FACE_EXPRESSION2_LIP_FUNNELER_RB_FB, 0.5f },
+	{ XRFaceTracker::FT_LIP_FUNNEL_LOWER, XR_FACE_EXPRESSION2_LIP_FUNNELER_LB_FB, 0.5f },
+	{ XRFaceTracker::FT_LIP_FUNNEL, XR_FACE_EXPRESSION2_LIP_FUNNELER_RT_FB, 0.25f },
+	{ XRFaceTracker::FT_LIP_FUNNEL, XR_FACE_EXPRESSION2_LIP_FUNNELER_LT_FB, 0.25f },
+	{ XRFaceTracker::FT_LIP_FUNNEL, XR_FACE_EXPRESSION2_LIP_FUNNELER_RB_FB, 0.25f },
+	{ XRFaceTracker::FT_LIP_FUNNEL, XR_FACE_EXPRESSION2_LIP_FUNNELER_LB_FB, 0.25f },
+	{ XRFaceTracker::FT_LIP_PUCKER_UPPER, XR_FACE_EXPRESSION2_LIP_PUCKER_R_FB, 0.5f },
+	{ XRFaceTracker::FT_LIP_PUCKER_UPPER, XR_FACE_EXPRESSION2_LIP_PUCKER_L_FB, 0.5f },
+	{ XRFaceTracker::FT_LIP_PUCKER_LOWER, XR_FACE_EXPRESSION2_LIP_PUCKER_R_FB, 0.5f },
+	{ XRFaceTracker::FT_LIP_PUCKER_LOWER, XR_FACE_EXPRESSION2_LIP_PUCKER_L_FB, 0.5f },
+	{ XRFaceTracker::FT_LIP_PUCKER, XR_FACE_EXPRESSION2_LIP_PUCKER_R_FB, 0.5f },
+	{ XRFaceTracker::FT_LIP_PUCKER, XR_FACE_EXPRESSION2_LIP_PUCKER_L_FB, 0.5f },
+	{ XRFaceTracker::FT_MOUTH_UPPER_UP, XR_FACE_EXPRESSION2_UPPER_LIP_RAISER_R_FB, 0.5f },
+	{ XRFaceTracker::FT_MOUTH_UPPER_UP, XR_FACE_EXPRESSION2_UPPER_LIP_RAISER_L_FB, 0.5f },
+	{ XRFaceTracker::FT_MOUTH_LOWER_DOWN, XR_FACE_EXPRESSION2_LOWER_LIP_DEPRESSOR_R_FB, 0.5f },
+	{ XRFaceTracker::FT_MOUTH_LOWER_DOWN, XR_FACE_EXPRESSION2_LOWER_LIP_DEPRESSOR_L_FB, 0.5f },
+	{ XRFaceTracker::FT_MOUTH_OPEN, XR_FACE_EXPRESSION2_UPPER_LIP_RAISER_R_FB, 0.25f },
+	{ XRFaceTracker::FT_MOUTH_OPEN, XR_FACE_EXPRESSION2_UPPER_LIP_RAISER_L_FB, 0.25f },
+	{ XRFaceTracker::FT_MOUTH_OPEN, XR_FACE_EXPRESSION2_LOWER_LIP_DEPRESSOR_R_FB, 0.25f },
+	{ XRFaceTracker::FT_MOUTH_OPEN, XR_FACE_EXPRESSION2_LOWER_LIP_DEPRESSOR_L_FB, 0.25f },
+	{ XRFaceTracker::FT_MOUTH_RIGHT, XR_FACE_EXPRESSION2_MOUTH_RIGHT_FB, 1.0f },
+	{ XRFaceTracker::FT_MOUTH_LEFT, XR_FACE_EXPRESSION2_MOUTH_LEFT_FB, 1.0f },
+	{ XRFaceTracker::FT_MOUTH_SMILE_RIGHT, XR_FACE_EXPRESSION2_LIP_CORNER_PULLER_R_FB, 1.0f },
+	{ XRFaceTracker::FT_MOUTH_SMILE_LEFT, XR_FACE_EXPRESSION2_LIP_CORNER_PULLER_L_FB, 1.0f },
+	{ XRFaceTracker::FT_MOUTH_SMILE, XR_FACE_EXPRESSION2_LIP_CORNER_PULLER_R_FB, 0.5f },
+	{ XRFaceTracker::FT_MOUTH_SMILE, XR_FACE_EXPRESSION2_LIP_CORNER_PULLER_L_FB, 0.5f },
+	{ XRFaceTracker::FT_MOUTH_STRETCH, XR_FACE_EXPRESSION2_LIP_STRETCHER_R_FB, 0.5f },
+	{ XRFaceTracker::FT_MOUTH_STRETCH, XR_FACE_EXPRESSION2_LIP_STRETCHER_L_FB, 0.5f },
+	{ XRFaceTracker::FT_MOUTH_DIMPLE, XR_FACE_EXPRESSION2_DIMPLER_R_FB, 0.5f },
+	{ XRFaceTracker::FT_MOUTH_DIMPLE, XR_FACE_EXPRESSION2_DIMPLER_L_FB, 0.5f },
+	{ XRFaceTracker::FT_MOUTH_TIGHTENER, XR_FACE_EXPRESSION2_LIP_TIGHTENER_R_FB, 0.5f },
+	{ XRFaceTracker::FT_MOUTH_TIGHTENER, XR_FACE_EXPRESSION2_LIP_TIGHTENER_L_FB, 0.5f },
+	{ XRFaceTracker::FT_MOUTH_PRESS, XR_FACE_EXPRESSION2_LIP_PRESSOR_R_FB, 0.5f },
+	{ XRFaceTracker::FT_MOUTH_PRESS, XR_FACE_EXPRESSION2_LIP_PRESSOR_L_FB, 0.5f },
+};
+
+/// Confidence region of a Meta face expression.
+static constexpr uint8_t get_face_expression_region(uint8_t p_expression) {
+	switch (p_expression) {
+		case XR_FACE_EXPRESSION2_BROW_LOWERER_L_FB:
+		case XR_FACE_EXPRESSION2_BROW_LOWERER_R_FB:
+		case XR_FACE_EXPRESSION2_CHEEK_RAISER_L_FB:
+		case XR_FACE_EXPRESSION2_CHEEK_RAISER_R_FB:
+		case XR_FACE_EXPRESSION2_EYES_CLOSED_L_FB:
+		case XR_FACE_EXPRESSION2_EYES_CLOSED_R_FB:
+		case XR_FACE_EXPRESSION2_EYES_LOOK_DOWN_L_FB:
+		case XR_FACE_EXPRESSION2_EYES_LOOK_DOWN_R_FB:
+		case XR_FACE_EXPRESSION2_EYES_LOOK_LEFT_L_FB:
+		case XR_FACE_EXPRESSION2_EYES_LOOK_LEFT_R_FB:
+		case XR_FACE_EXPRESSION2_EYES_LOOK_RIGHT_L_FB:
+		case XR_FACE_EXPRESSION2_EYES_LOOK_RIGHT_R_FB:
+		case XR_FACE_EXPRESSION2_EYES_LOOK_UP_L_FB:
+		case XR_FACE_EXPRESSION2_EYES_LOOK_UP_R_FB:
+		case XR_FACE_EXPRESSION2_INNER_BROW_RAISER_L_FB:
+		case XR_FACE_EXPRESSION2_INNER_BROW_RAISER_R_FB:
+		case XR_FACE_EXPRESSION2_LID_TIGHTENER_L_FB:
+		case XR_FACE_EXPRESSION2_LID_TIGHTENER_R_FB:
+		case XR_FACE_EXPRESSION2_OUTER_BROW_RAISER_L_FB:
+		case XR_FACE_EXPRESSION2_OUTER_BROW_RAISER_R_FB:
+		case XR_FACE_EXPRESSION2_UPPER_LID_RAISER_L_FB:
+		case XR_FACE_EXPRESSION2_UPPER_LID_RAISER_R_FB:
+			return uint8_t(XR_FACE_CONFIDENCE2_UPPER_FACE_FB);
+		default:
+			return uint8_t(XR_FACE_CONFIDENCE2_LOWER_FACE_FB);
+	}
 }
 
+static_assert(FaceExpressionMapper::terms_fit(face_remap_terms, get_face_expression_region), "Too many face remap terms for a single blend shape.");
+
+static constexpr FaceExpressionMapper::Mapping face_remap_mapping = FaceExpressionMapper::build_mapping(face_remap_terms, get_face_expression_region);
+
 OpenXRFbFaceTrackingExtensionWrapper *OpenXRFbFaceTrackingExtensionWrapper::singleton = nullptr;
 
 OpenXRFbFaceTrackingExtensionWrapper *OpenXRFbFaceTrackingExtensionWrapper::get_singleton() {
@@ -64,6 +238,8 @@ OpenXRFbFaceTrackingExtensionWrapper::~OpenXRFbFaceTrackingExtensionWrapper() {
 }
 
 void OpenXRFbFaceTrackingExtensionWrapper::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_confidence_threshold", "threshold"), &OpenXRFbFaceTrackingExtensionWrapper::set_confidence_threshold);
+	ClassDB::bind_method(D_METHOD("get_confidence_threshold"), &OpenXRFbFaceTrackingExtensionWrapper::get_confidence_threshold);
 }
 
 void OpenXRFbFaceTrackingExtensionWrapper::cleanup() {
@@ -154,6 +330,9 @@ void OpenXRFbFaceTrackingExtensionWrapper::_on_session_destroyed() {
 		}
 	}
 	xr_face_tracker_registered = false;
+
+	// Forget the held weights.
+	face_mapper.reset();
 }
 
 void OpenXRFbFaceTrackingExtensionWrapper::_on_process() {
@@ -184,170 +363,36 @@ void OpenXRFbFaceTrackingExtensionWrapper::_on_process() {
 		XR_FACE_EXPRESSION2_COUNT_FB, // weightCount
 		fb_weights, // weights
 		XR_FACE_CONFIDENCE2_COUNT_FB, // confidenceCount
-		fb_confidences // confidences
+		fb_confidences, // confidences
+		XR_FALSE, // isValid
+		XR_FALSE, // isEyeFollowingBlendshapesValid
+		XR_FACE_TRACKING_DATA_SOURCE2_VISUAL_FB, // dataSource
+		0 // time
 	};
 
 	// Read the weights
 	XrResult result = xrGetFaceExpressionWeights2FB(face_tracker2, &expression_info2, &face_expression_weights2);
 	if (XR_FAILED(result)) {
 		UtilityFunctions::print("Failed to get face expression weights: ", result);
+		return;
 	}
 
-	// Map Meta weights to Godot weights.
-	float xr_weights[XRFaceTracker::FT_MAX] = {};
-
-	// Base Shapes
-	xr_weights[XRFaceTracker::FT_EYE_LOOK_OUT_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_EYES_LOOK_RIGHT_R_FB];
-	xr_weights[XRFaceTracker::FT_EYE_LOOK_IN_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_EYES_LOOK_LEFT_R_FB];
-	xr_weights[XRFaceTracker::FT_EYE_LOOK_UP_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_EYES_LOOK_UP_R_FB];
-	xr_weights[XRFaceTracker::FT_EYE_LOOK_DOWN_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_EYES_LOOK_DOWN_R_FB];
-	xr_weights[XRFaceTracker::FT_EYE_LOOK_OUT_LEFT] = fb_weights[XR_FACE_EXPRESSION2_EYES_LOOK_LEFT_L_FB];
-	xr_weights[XRFaceTracker::FT_EYE_LOOK_IN_LEFT] = fb_weights[XR_FACE_EXPRESSION2_EYES_LOOK_RIGHT_L_FB];
-	xr_weights[XRFaceTracker::FT_EYE_LOOK_UP_LEFT] = fb_weights[XR_FACE_EXPRESSION2_EYES_LOOK_UP_L_FB];
-	xr_weights[XRFaceTracker::FT_EYE_LOOK_DOWN_LEFT] = fb_weights[XR_FACE_EXPRESSION2_EYES_LOOK_DOWN_L_FB];
-	xr_weights[XRFaceTracker::FT_EYE_CLOSED_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_EYES_CLOSED_R_FB];
-	xr_weights[XRFaceTracker::FT_EYE_CLOSED_LEFT] = fb_weights[XR_FACE_EXPRESSION2_EYES_CLOSED_L_FB];
-	xr_weights[XRFaceTracker::FT_EYE_SQUINT_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_LID_TIGHTENER_R_FB];
-	xr_weights[XRFaceTracker::FT_EYE_SQUINT_LEFT] = fb_weights[XR_FACE_EXPRESSION2_LID_TIGHTENER_L_FB];
-	xr_weights[XRFaceTracker::FT_EYE_WIDE_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_UPPER_LID_RAISER_R_FB];
-	xr_weights[XRFaceTracker::FT_EYE_WIDE_LEFT] = fb_weights[XR_FACE_EXPRESSION2_UPPER_LID_RAISER_L_FB];
-	xr_weights[XRFaceTracker::FT_EYE_DILATION_RIGHT] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_EYE_DILATION_LEFT] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_EYE_CONSTRICT_RIGHT] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_EYE_CONSTRICT_LEFT] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_BROW_PINCH_RIGHT] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_BROW_PINCH_LEFT] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_BROW_LOWERER_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_BROW_LOWERER_R_FB];
-	xr_weights[XRFaceTracker::FT_BROW_LOWERER_LEFT] = fb_weights[XR_FACE_EXPRESSION2_BROW_LOWERER_L_FB];
-	xr_weights[XRFaceTracker::FT_BROW_INNER_UP_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_INNER_BROW_RAISER_R_FB];
-	xr_weights[XRFaceTracker::FT_BROW_INNER_UP_LEFT] = fb_weights[XR_FACE_EXPRESSION2_INNER_BROW_RAISER_L_FB];
-	xr_weights[XRFaceTracker::FT_BROW_OUTER_UP_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_OUTER_BROW_RAISER_R_FB];
-	xr_weights[XRFaceTracker::FT_BROW_OUTER_UP_LEFT] = fb_weights[XR_FACE_EXPRESSION2_OUTER_BROW_RAISER_L_FB];
-	xr_weights[XRFaceTracker::FT_NOSE_SNEER_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_NOSE_WRINKLER_R_FB];
-	xr_weights[XRFaceTracker::FT_NOSE_SNEER_LEFT] = fb_weights[XR_FACE_EXPRESSION2_NOSE_WRINKLER_L_FB];
-	xr_weights[XRFaceTracker::FT_NASAL_DILATION_RIGHT] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_NASAL_DILATION_LEFT] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_NASAL_CONSTRICT_RIGHT] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_NASAL_CONSTRICT_LEFT] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_CHEEK_SQUINT_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_CHEEK_RAISER_R_FB];
-	xr_weights[XRFaceTracker::FT_CHEEK_SQUINT_LEFT] = fb_weights[XR_FACE_EXPRESSION2_CHEEK_RAISER_L_FB];
-	xr_weights[XRFaceTracker::FT_CHEEK_PUFF_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_CHEEK_PUFF_R_FB];
-	xr_weights[XRFaceTracker::FT_CHEEK_PUFF_LEFT] = fb_weights[XR_FACE_EXPRESSION2_CHEEK_PUFF_L_FB];
-	xr_weights[XRFaceTracker::FT_CHEEK_SUCK_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_CHEEK_SUCK_R_FB];
-	xr_weights[XRFaceTracker::FT_CHEEK_SUCK_LEFT] = fb_weights[XR_FACE_EXPRESSION2_CHEEK_SUCK_L_FB];
-	xr_weights[XRFaceTracker::FT_JAW_OPEN] = fb_weights[XR_FACE_EXPRESSION2_JAW_DROP_FB];
-	xr_weights[XRFaceTracker::FT_MOUTH_CLOSED] = fb_weights[XR_FACE_EXPRESSION2_LIPS_TOWARD_FB];
-	xr_weights[XRFaceTracker::FT_JAW_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_JAW_SIDEWAYS_RIGHT_FB];
-	xr_weights[XRFaceTracker::FT_JAW_LEFT] = fb_weights[XR_FACE_EXPRESSION2_JAW_SIDEWAYS_LEFT_FB];
-	xr_weights[XRFaceTracker::FT_JAW_FORWARD] = fb_weights[XR_FACE_EXPRESSION2_JAW_THRUST_FB];
-	xr_weights[XRFaceTracker::FT_JAW_BACKWARD] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_JAW_CLENCH] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_JAW_MANDIBLE_RAISE] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_LIP_SUCK_UPPER_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_LIP_SUCK_RT_FB];
-	xr_weights[XRFaceTracker::FT_LIP_SUCK_UPPER_LEFT] = fb_weights[XR_FACE_EXPRESSION2_LIP_SUCK_LT_FB];
-	xr_weights[XRFaceTracker::FT_LIP_SUCK_LOWER_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_LIP_SUCK_RB_FB];
-	xr_weights[XRFaceTracker::FT_LIP_SUCK_LOWER_LEFT] = fb_weights[XR_FACE_EXPRESSION2_LIP_SUCK_LB_FB];
-	xr_weights[XRFaceTracker::FT_LIP_SUCK_CORNER_RIGHT] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_LIP_SUCK_CORNER_LEFT] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_LIP_FUNNEL_UPPER_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_LIP_FUNNELER_RT_FB];
-	xr_weights[XRFaceTracker::FT_LIP_FUNNEL_UPPER_LEFT] = fb_weights[XR_FACE_EXPRESSION2_LIP_FUNNELER_LT_FB];
-	xr_weights[XRFaceTracker::FT_LIP_FUNNEL_LOWER_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_LIP_FUNNELER_RB_FB];
-	xr_weights[XRFaceTracker::FT_LIP_FUNNEL_LOWER_LEFT] = fb_weights[XR_FACE_EXPRESSION2_LIP_FUNNELER_LB_FB];
-	xr_weights[XRFaceTracker::FT_LIP_PUCKER_UPPER_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_LIP_PUCKER_R_FB];
-	xr_weights[XRFaceTracker::FT_LIP_PUCKER_UPPER_LEFT] = fb_weights[XR_FACE_EXPRESSION2_LIP_PUCKER_L_FB];
-	xr_weights[XRFaceTracker::FT_LIP_PUCKER_LOWER_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_LIP_PUCKER_R_FB];
-	xr_weights[XRFaceTracker::FT_LIP_PUCKER_LOWER_LEFT] = fb_weights[XR_FACE_EXPRESSION2_LIP_PUCKER_L_FB];
-	xr_weights[XRFaceTracker::FT_MOUTH_UPPER_UP_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_UPPER_LIP_RAISER_R_FB];
-	xr_weights[XRFaceTracker::FT_MOUTH_UPPER_UP_LEFT] = fb_weights[XR_FACE_EXPRESSION2_UPPER_LIP_RAISER_L_FB];
-	xr_weights[XRFaceTracker::FT_MOUTH_LOWER_DOWN_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_LOWER_LIP_DEPRESSOR_R_FB];
-	xr_weights[XRFaceTracker::FT_MOUTH_LOWER_DOWN_LEFT] = fb_weights[XR_FACE_EXPRESSION2_LOWER_LIP_DEPRESSOR_L_FB];
-	xr_weights[XRFaceTracker::FT_MOUTH_UPPER_DEEPEN_RIGHT] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_UPPER_DEEPEN_LEFT] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_UPPER_RIGHT] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_UPPER_LEFT] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_LOWER_RIGHT] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_LOWER_LEFT] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_CORNER_PULL_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_LIP_CORNER_PULLER_R_FB];
-	xr_weights[XRFaceTracker::FT_MOUTH_CORNER_PULL_LEFT] = fb_weights[XR_FACE_EXPRESSION2_LIP_CORNER_PULLER_L_FB];
-	xr_weights[XRFaceTracker::FT_MOUTH_CORNER_SLANT_RIGHT] = 0.0f;
-	xr_weights[XRFaceTracker::FT_MOUTH_CORNER_SLANT_LEFT] = 0.0f;
-	xr_weights[XRFaceTracker::FT_MOUTH_FROWN_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_LIP_CORNER_DEPRESSOR_R_FB];
-	xr_weights[XRFaceTracker::FT_MOUTH_FROWN_LEFT] = fb_weights[XR_FACE_EXPRESSION2_LIP_CORNER_DEPRESSOR_L_FB];
-	xr_weights[XRFaceTracker::FT_MOUTH_STRETCH_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_LIP_STRETCHER_R_FB];
-	xr_weights[XRFaceTracker::FT_MOUTH_STRETCH_LEFT] = fb_weights[XR_FACE_EXPRESSION2_LIP_STRETCHER_L_FB];
-	xr_weights[XRFaceTracker::FT_MOUTH_DIMPLE_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_DIMPLER_R_FB];
-	xr_weights[XRFaceTracker::FT_MOUTH_DIMPLE_LEFT] = fb_weights[XR_FACE_EXPRESSION2_DIMPLER_L_FB];
-	xr_weights[XRFaceTracker::FT_MOUTH_RAISER_UPPER] = fb_weights[XR_FACE_EXPRESSION2_CHIN_RAISER_T_FB];
-	xr_weights[XRFaceTracker::FT_MOUTH_RAISER_LOWER] = fb_weights[XR_FACE_EXPRESSION2_CHIN_RAISER_B_FB];
-	xr_weights[XRFaceTracker::FT_MOUTH_PRESS_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_LIP_PRESSOR_R_FB];
-	xr_weights[XRFaceTracker::FT_MOUTH_PRESS_LEFT] = fb_weights[XR_FACE_EXPRESSION2_LIP_PRESSOR_L_FB];
-	xr_weights[XRFaceTracker::FT_MOUTH_TIGHTENER_RIGHT] = fb_weights[XR_FACE_EXPRESSION2_LIP_TIGHTENER_R_FB];
-	xr_weights[XRFaceTracker::FT_MOUTH_TIGHTENER_LEFT] = fb_weights[XR_FACE_EXPRESSION2_LIP_TIGHTENER_L_FB];
-	xr_weights[XRFaceTracker::FT_TONGUE_OUT] = fb_weights[XR_FACE_EXPRESSION2_TONGUE_OUT_FB];
-	xr_weights[XRFaceTracker::FT_TONGUE_UP] = 0.0f;
-	xr_weights[XRFaceTracker::FT_TONGUE_DOWN] = 0.0f;
-	xr_weights[XRFaceTracker::FT_TONGUE_RIGHT] = 0.0f;
-	xr_weights[XRFaceTracker::FT_TONGUE_LEFT] = 0.0f;
-	xr_weights[XRFaceTracker::FT_TONGUE_ROLL] = 0.0f;
-	xr_weights[XRFaceTracker::FT_TONGUE_BLEND_DOWN] = 0.0f;
-	xr_weights[XRFaceTracker::FT_TONGUE_CURL_UP] = 0.0f;
-	xr_weights[XRFaceTracker::FT_TONGUE_SQUISH] = 0.0f;
-	xr_weights[XRFaceTracker::FT_TONGUE_FLAT] = fb_weights[XR_FACE_EXPRESSION2_TONGUE_RETREAT_FB];
-	xr_weights[XRFaceTracker::FT_TONGUE_TWIST_RIGHT] = 0.0f;
-	xr_weights[XRFaceTracker::FT_TONGUE_TWIST_LEFT] = 0.0f;
-	xr_weights[XRFaceTracker::FT_SOFT_PALATE_CLOSE] = 0.0f;
-	xr_weights[XRFaceTracker::FT_THROAT_SWALLOW] = 0.0f;
-	xr_weights[XRFaceTracker::FT_NECK_FLEX_RIGHT] = 0.0f;
-	xr_weights[XRFaceTracker::FT_NECK_FLEX_LEFT] = 0.0f;
+	// Only regions the runtime is confident about are updated, the others
+	// hold their last good values.
+	bool region_valid[XR_FACE_CONFIDENCE2_COUNT_FB];
+	bool any_region_valid = false;
+	for (int i = 0; i < XR_FACE_CONFIDENCE2_COUNT_FB; i++) {
+		region_valid[i] = face_expression_weights2.isValid && fb_confidences[i] >= confidence_threshold;
+		any_region_valid = any_region_valid || region_valid[i];
+	}
+	if (!any_region_valid) {
+		return;
+	}
 
-	// Blended Shapes
-	xr_weights[XRFaceTracker::FT_EYE_CLOSED] = average(xr_weights[XRFaceTracker::FT_EYE_CLOSED_RIGHT], xr_weights[XRFaceTracker::FT_EYE_CLOSED_LEFT]);
-	xr_weights[XRFaceTracker::FT_EYE_WIDE] = average(xr_weights[XRFaceTracker::FT_EYE_WIDE_RIGHT], xr_weights[XRFaceTracker::FT_EYE_WIDE_LEFT]);
-	xr_weights[XRFaceTracker::FT_EYE_SQUINT] = average(xr_weights[XRFaceTracker::FT_EYE_SQUINT_RIGHT], xr_weights[XRFaceTracker::FT_EYE_SQUINT_LEFT]);
-	xr_weights[XRFaceTracker::FT_EYE_DILATION] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_EYE_CONSTRICT] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_BROW_DOWN_RIGHT] = fb_weights[XR_FACE_EXPRESSION_BROW_LOWERER_R_FB];
-	xr_weights[XRFaceTracker::FT_BROW_DOWN_LEFT] = fb_weights[XR_FACE_EXPRESSION_BROW_LOWERER_L_FB];
-	xr_weights[XRFaceTracker::FT_BROW_DOWN] = average(xr_weights[XRFaceTracker::FT_BROW_DOWN_RIGHT], xr_weights[XRFaceTracker::FT_BROW_DOWN_LEFT]);
-	xr_weights[XRFaceTracker::FT_BROW_UP_RIGHT] = average(xr_weights[XRFaceTracker::FT_BROW_INNER_UP_RIGHT], xr_weights[XRFaceTracker::FT_BROW_OUTER_UP_RIGHT]);
-	xr_weights[XRFaceTracker::FT_BROW_UP_LEFT] = average(xr_weights[XRFaceTracker::FT_BROW_INNER_UP_LEFT], xr_weights[XRFaceTracker::FT_BROW_OUTER_UP_LEFT]);
-	xr_weights[XRFaceTracker::FT_BROW_UP] = average(xr_weights[XRFaceTracker::FT_BROW_UP_RIGHT], xr_weights[XRFaceTracker::FT_BROW_UP_LEFT]);
-	xr_weights[XRFaceTracker::FT_NOSE_SNEER] = average(xr_weights[XRFaceTracker::FT_NOSE_SNEER_RIGHT], xr_weights[XRFaceTracker::FT_NOSE_SNEER_LEFT]);
-	xr_weights[XRFaceTracker::FT_NASAL_DILATION] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_NASAL_CONSTRICT] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_CHEEK_PUFF] = average(xr_weights[XRFaceTracker::FT_CHEEK_PUFF_RIGHT], xr_weights[XRFaceTracker::FT_CHEEK_PUFF_LEFT]);
-	xr_weights[XRFaceTracker::FT_CHEEK_SUCK] = average(xr_weights[XRFaceTracker::FT_CHEEK_SUCK_RIGHT], xr_weights[XRFaceTracker::FT_CHEEK_SUCK_LEFT]);
-	xr_weights[XRFaceTracker::FT_CHEEK_SQUINT] = average(xr_weights[XRFaceTracker::FT_CHEEK_SQUINT_RIGHT], xr_weights[XRFaceTracker::FT_CHEEK_SQUINT_LEFT]);
-	xr_weights[XRFaceTracker::FT_LIP_SUCK_UPPER] = average(xr_weights[XRFaceTracker::FT_LIP_SUCK_UPPER_RIGHT], xr_weights[XRFaceTracker::FT_LIP_SUCK_UPPER_LEFT]);
-	xr_weights[XRFaceTracker::FT_LIP_SUCK_LOWER] = average(xr_weights[XRFaceTracker::FT_LIP_SUCK_LOWER_RIGHT], xr_weights[XRFaceTracker::FT_LIP_SUCK_LOWER_LEFT]);
-	xr_weights[XRFaceTracker::FT_LIP_SUCK] = average(xr_weights[XRFaceTracker::FT_LIP_SUCK_UPPER], xr_weights[XRFaceTracker::FT_LIP_SUCK_LOWER]);
-	xr_weights[XRFaceTracker::FT_LIP_FUNNEL_UPPER] = average(xr_weights[XRFaceTracker::FT_LIP_FUNNEL_UPPER_RIGHT], xr_weights[XRFaceTracker::FT_LIP_FUNNEL_UPPER_LEFT]);
-	xr_weights[XRFaceTracker::FT_LIP_FUNNEL_LOWER] = average(xr_weights[XRFaceTracker::FT_LIP_FUNNEL_LOWER_RIGHT], xr_weights[XRFaceTracker::FT_LIP_FUNNEL_LOWER_LEFT]);
-	xr_weights[XRFaceTracker::FT_LIP_FUNNEL] = average(xr_weights[XRFaceTracker::FT_LIP_FUNNEL_UPPER], xr_weights[XRFaceTracker::FT_LIP_FUNNEL_LOWER]);
-	xr_weights[XRFaceTracker::FT_LIP_PUCKER_UPPER] = average(xr_weights[XRFaceTracker::FT_LIP_PUCKER_UPPER_RIGHT], xr_weights[XRFaceTracker::FT_LIP_PUCKER_UPPER_LEFT]);
-	xr_weights[XRFaceTracker::FT_LIP_PUCKER_LOWER] = average(xr_weights[XRFaceTracker::FT_LIP_PUCKER_LOWER_RIGHT], xr_weights[XRFaceTracker::FT_LIP_PUCKER_LOWER_LEFT]);
-	xr_weights[XRFaceTracker::FT_LIP_PUCKER] = average(xr_weights[XRFaceTracker::FT_LIP_PUCKER_UPPER], xr_weights[XRFaceTracker::FT_LIP_PUCKER_LOWER]);
-	xr_weights[XRFaceTracker::FT_MOUTH_UPPER_UP] = average(xr_weights[XRFaceTracker::FT_MOUTH_UPPER_UP_RIGHT], xr_weights[XRFaceTracker::FT_MOUTH_UPPER_UP_LEFT]);
-	xr_weights[XRFaceTracker::FT_MOUTH_LOWER_DOWN] = average(xr_weights[XRFaceTracker::FT_MOUTH_LOWER_DOWN_RIGHT], xr_weights[XRFaceTracker::FT_MOUTH_LOWER_DOWN_LEFT]);
-	xr_weights[XRFaceTracker::FT_MOUTH_OPEN] = average(xr_weights[XRFaceTracker::FT_MOUTH_UPPER_UP], xr_weights[XRFaceTracker::FT_MOUTH_LOWER_DOWN]);
-	xr_weights[XRFaceTracker::FT_MOUTH_RIGHT] = fb_weights[XR_FACE_EXPRESSION_MOUTH_RIGHT_FB];
-	xr_weights[XRFaceTracker::FT_MOUTH_LEFT] = fb_weights[XR_FACE_EXPRESSION_MOUTH_LEFT_FB];
-	xr_weights[XRFaceTracker::FT_MOUTH_SMILE_RIGHT] = fb_weights[XR_FACE_EXPRESSION_LIP_CORNER_PULLER_R_FB];
-	xr_weights[XRFaceTracker::FT_MOUTH_SMILE_LEFT] = fb_weights[XR_FACE_EXPRESSION_LIP_CORNER_PULLER_L_FB];
-	xr_weights[XRFaceTracker::FT_MOUTH_SMILE] = average(xr_weights[XRFaceTracker::FT_MOUTH_SMILE_RIGHT], xr_weights[XRFaceTracker::FT_MOUTH_SMILE_LEFT]);
-	xr_weights[XRFaceTracker::FT_MOUTH_SAD_RIGHT] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_SAD_LEFT] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_SAD] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_STRETCH] = average(xr_weights[XRFaceTracker::FT_MOUTH_STRETCH_RIGHT], xr_weights[XRFaceTracker::FT_MOUTH_STRETCH_LEFT]);
-	xr_weights[XRFaceTracker::FT_MOUTH_DIMPLE] = average(xr_weights[XRFaceTracker::FT_MOUTH_DIMPLE_RIGHT], xr_weights[XRFaceTracker::FT_MOUTH_DIMPLE_LEFT]);
-	xr_weights[XRFaceTracker::FT_MOUTH_TIGHTENER] = average(xr_weights[XRFaceTracker::FT_MOUTH_TIGHTENER_RIGHT], xr_weights[XRFaceTracker::FT_MOUTH_TIGHTENER_LEFT]);
-	xr_weights[XRFaceTracker::FT_MOUTH_PRESS] = average(xr_weights[XRFaceTracker::FT_MOUTH_PRESS_RIGHT], xr_weights[XRFaceTracker::FT_MOUTH_PRESS_LEFT]);
-
-	// Populate the XRFaceTracker
-	PackedFloat32Array xr_weights_array;
-	xr_weights_array.resize(XRFaceTracker::FT_MAX);
-	memcpy(xr_weights_array.ptrw(), xr_weights, sizeof(xr_weights));
-	xr_face_tracker->set_blend_shapes(xr_weights_array);
+	// Map Meta weights to Godot weights, and only publish them if they changed.
+	if (face_mapper.update(face_remap_mapping, fb_weights, region_valid)) {
+		face_mapper.publish(xr_face_tracker);
+	}
 
 	// Register the XRFaceTracker if necessary
 	if (!xr_face_tracker_registered) {
@@ -363,6 +408,15 @@ bool OpenXRFbFaceTrackingExtensionWrapper::is_enabled() const {
 	return fb_face_tracking2_ext && (system_face_tracking_properties2.supportsVisualFaceTracking || system_face_tracking_properties2.supportsAudioFaceTracking);
 }
 
+void OpenXRFbFaceTrackingExtensionWrapper::set_confidence_threshold(float p_threshold) {
+	ERR_FAIL_COND_MSG(p_threshold < 0.0 || p_threshold > 1.0, "Face tracking confidence threshold must be between 0 and 1.");
+	confidence_threshold = p_threshold;
+}
+
+float OpenXRFbFaceTrackingExtensionWrapper::get_confidence_threshold() const {
+	return confidence_threshold;
+}
+
 bool OpenXRFbFaceTrackingExtensionWrapper::initialize_fb_face_tracking2_extension(const XrInstance p_instance) {
 	GDEXTENSION_INIT_XR_FUNC_V(xrCreateFaceTracker2FB);
 	GDEXTENSION_INIT_XR_FUNC_V(xrDestroyFaceTracker2FB);
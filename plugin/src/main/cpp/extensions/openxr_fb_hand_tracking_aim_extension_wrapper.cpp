@@ -29,11 +29,27 @@
 
 #include "extensions/openxr_fb_hand_tracking_aim_extension_wrapper.h"
 
+#include <godot_cpp/classes/open_xrapi_extension.hpp>
 #include <godot_cpp/classes/project_settings.hpp>
 #include <godot_cpp/classes/xr_pose.hpp>
 
 using namespace godot;
 
+static const char *aim_input_names[] = {
+	"index_pinch",
+	"middle_pinch",
+	"ring_pinch",
+	"little_pinch",
+	"index_pinch_strength",
+	"middle_pinch_strength",
+	"ring_pinch_strength",
+	"little_pinch_strength",
+	"dominant_hand",
+	"menu_gesture",
+	"menu_pressed",
+	"system_gesture",
+};
+
 OpenXRFbHandTrackingAimExtensionWrapper *OpenXRFbHandTrackingAimExtensionWrapper::singleton = nullptr;
 
 OpenXRFbHandTrackingAimExtensionWrapper *OpenXRFbHandTrackingAimExtensionWrapper::get_singleton() {
@@ -48,6 +64,13 @@ OpenXRFbHandTrackingAimExtensionWrapper::OpenXRFbHandTrackingAimExtensionWrapper
 	ERR_FAIL_COND_MSG(singleton != nullptr, "An OpenXRFbHandTrackingAimExtensionWrapper singleton already exists.");
 
 	request_extensions[XR_FB_HAND_TRACKING_AIM_EXTENSION_NAME] = &fb_hand_tracking_aim_ext;
+
+	static_assert(sizeof(aim_input_names) / sizeof(aim_input_names[0]) == AIM_INPUT_MAX, "Every aim input needs a name.");
+	default_pose_name = StringName("default");
+	for (int i = 0; i < AIM_INPUT_MAX; i++) {
+		input_names[i] = StringName(aim_input_names[i]);
+	}
+
 	singleton = this;
 }
 
@@ -69,6 +92,9 @@ void OpenXRFbHandTrackingAimExtensionWrapper::cleanup() {
 			}
 			trackers[i].unref();
 		}
+
+		inputs_published[i] = false;
+		aim_history[i].clear();
 	}
 
 	fb_hand_tracking_aim_ext = false;
@@ -112,6 +138,12 @@ void OpenXRFbHandTrackingAimExtensionWrapper::_on_state_ready() {
 	trackers[Hand::HAND_RIGHT]->set_tracker_name(TRACKER_NAME_RIGHT);
 	trackers[Hand::HAND_RIGHT]->set_tracker_desc("FB Aim tracker Right");
 	xr_server->add_tracker(trackers[Hand::HAND_RIGHT]);
+
+	// New trackers need all their inputs.
+	for (int i = 0; i < Hand::HAND_MAX; i++) {
+		inputs_published[i] = false;
+		aim_history[i].clear();
+	}
 }
 
 void OpenXRFbHandTrackingAimExtensionWrapper::_on_instance_destroyed() {
@@ -144,6 +176,8 @@ void OpenXRFbHandTrackingAimExtensionWrapper::_on_process() {
 		return;
 	}
 
+	const XrTime display_time = get_openxr_api().is_valid() ? get_openxr_api()->get_predicted_display_time() : 0;
+
 	for (int i = 0; i < Hand::HAND_MAX; i++) {
 		if (!trackers[i].is_valid()) {
 			continue;
@@ -162,27 +196,56 @@ void OpenXRFbHandTrackingAimExtensionWrapper::_on_process() {
 		XRPose::TrackingConfidence confidence = XRPose::TrackingConfidence::XR_TRACKING_CONFIDENCE_LOW;
 		if (!(aim_state[i].status & XR_HAND_TRACKING_AIM_VALID_BIT_FB)) {
 			confidence = XRPose::TrackingConfidence::XR_TRACKING_CONFIDENCE_NONE;
+			aim_history[i].clear();
+		} else {
+			update_aim_velocity(i, transform, display_time, linear_velocity, angular_velocity);
 		}
 
-		trackers[i]->set_pose("default", transform, linear_velocity, angular_velocity, confidence);
-		trackers[i]->set_input("index_pinch", (bool)(aim_state[i].status & XR_HAND_TRACKING_AIM_INDEX_PINCHING_BIT_FB));
-		trackers[i]->set_input("middle_pinch", (bool)(aim_state[i].status & XR_HAND_TRACKING_AIM_MIDDLE_PINCHING_BIT_FB));
-		trackers[i]->set_input("ring_pinch", (bool)(aim_state[i].status & XR_HAND_TRACKING_AIM_RING_PINCHING_BIT_FB));
-		trackers[i]->set_input("little_pinch", (bool)(aim_state[i].status & XR_HAND_TRACKING_AIM_LITTLE_PINCHING_BIT_FB));
-		trackers[i]->set_input("index_pinch_strength", aim_state[i].pinchStrengthIndex);
-		trackers[i]->set_input("middle_pinch_strength", aim_state[i].pinchStrengthMiddle);
-		trackers[i]->set_input("ring_pinch_strength", aim_state[i].pinchStrengthRing);
-		trackers[i]->set_input("little_pinch_strength", aim_state[i].pinchStrengthLittle);
-		trackers[i]->set_input("dominant_hand", (bool)(aim_state[i].status & XR_HAND_TRACKING_AIM_DOMINANT_HAND_BIT_FB));
+		trackers[i]->set_pose(default_pose_name, transform, linear_velocity, angular_velocity, confidence);
+		set_input(i, AIM_INPUT_INDEX_PINCH, (bool)(aim_state[i].status & XR_HAND_TRACKING_AIM_INDEX_PINCHING_BIT_FB));
+		set_input(i, AIM_INPUT_MIDDLE_PINCH, (bool)(aim_state[i].status & XR_HAND_TRACKING_AIM_MIDDLE_PINCHING_BIT_FB));
+		set_input(i, AIM_INPUT_RING_PINCH, (bool)(aim_state[i].status & XR_HAND_TRACKING_AIM_RING_PINCHING_BIT_FB));
+		set_input(i, AIM_INPUT_LITTLE_PINCH, (bool)(aim_state[i].status & XR_HAND_TRACKING_AIM_LITTLE_PINCHING_BIT_FB));
+		set_input(i, AIM_INPUT_INDEX_PINCH_STRENGTH, aim_state[i].pinchStrengthIndex);
+		set_input(i, AIM_INPUT_MIDDLE_PINCH_STRENGTH, aim_state[i].pinchStrengthMiddle);
+		set_input(i, AIM_INPUT_RING_PINCH_STRENGTH, aim_state[i].pinchStrengthRing);
+		set_input(i, AIM_INPUT_LITTLE_PINCH_STRENGTH, aim_state[i].pinchStrengthLittle);
+		set_input(i, AIM_INPUT_DOMINANT_HAND, (bool)(aim_state[i].status & XR_HAND_TRACKING_AIM_DOMINANT_HAND_BIT_FB));
 
 		if (i == Hand::HAND_LEFT) {
-			trackers[i]->set_input("menu_gesture", (bool)(aim_state[i].status & XR_HAND_TRACKING_AIM_SYSTEM_GESTURE_BIT_FB));
-			trackers[i]->set_input("menu_pressed", (bool)(aim_state[i].status & XR_HAND_TRACKING_AIM_MENU_PRESSED_BIT_FB));
+			set_input(i, AIM_INPUT_MENU_GESTURE, (bool)(aim_state[i].status & XR_HAND_TRACKING_AIM_SYSTEM_GESTURE_BIT_FB));
+			set_input(i, AIM_INPUT_MENU_PRESSED, (bool)(aim_state[i].status & XR_HAND_TRACKING_AIM_MENU_PRESSED_BIT_FB));
 		} else if (i == Hand::HAND_RIGHT) {
-			trackers[i]->set_input("system_gesture", (bool)(aim_state[i].status & XR_HAND_TRACKING_AIM_SYSTEM_GESTURE_BIT_FB));
+			set_input(i, AIM_INPUT_SYSTEM_GESTURE, (bool)(aim_state[i].status & XR_HAND_TRACKING_AIM_SYSTEM_GESTURE_BIT_FB));
 		}
+		inputs_published[i] = true;
 
 		// Clear status for the next frame.
 		aim_state[i].status = 0;
 	}
 }
+
+void OpenXRFbHandTrackingAimExtensionWrapper::set_input(int p_hand, AimInput p_input, bool p_value) {
+	const float value = p_value ? 1.0 : 0.0;
+	if (inputs_published[p_hand] && input_values[p_hand][p_input] == value) {
+		return;
+	}
+
+	input_values[p_hand][p_input] = value;
+	trackers[p_hand]->set_input(input_names[p_input], p_value);
+}
+
+void OpenXRFbHandTrackingAimExtensionWrapper::set_input(int p_hand, AimInput p_input, float p_value) {
+	if (inputs_published[p_hand] && input_values[p_hand][p_input] == p_value) {
+		return;
+	}
+
+	input_values[p_hand][p_input] = p_value;
+	trackers[p_hand]->set_input(input_names[p_input], p_value);
+}
+
+void OpenXRFbHandTrackingAimExtensionWrapper::update_aim_velocity(int p_hand, const Transform3D &p_transform, XrTime p_time, Vector3 &r_linear_velocity, Vector3 &r_angular_velocity) {
+	PoseHistory &history = aim_history[p_hand];
+	history.push(p_transform.origin, p_transform.basis.get_rotation_quaternion(), p_time);
+	history.get_velocities(r_linear_velocity, r_angular_velocity);
+}
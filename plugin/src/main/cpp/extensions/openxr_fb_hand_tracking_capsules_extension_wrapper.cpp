@@ -29,6 +29,7 @@
 
 #include "extensions/openxr_fb_hand_tracking_capsules_extension_wrapper.h"
 
+#include <godot_cpp/classes/capsule_shape3d.hpp>
 #include <godot_cpp/classes/project_settings.hpp>
 
 using namespace godot;
@@ -61,10 +62,16 @@ void OpenXRFbHandTrackingCapsulesExtensionWrapper::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_hand_capsule_height", "hand_index", "capsule_index"), &OpenXRFbHandTrackingCapsulesExtensionWrapper::get_hand_capsule_height);
 	ClassDB::bind_method(D_METHOD("get_hand_capsule_radius", "hand_index", "capsule_index"), &OpenXRFbHandTrackingCapsulesExtensionWrapper::get_hand_capsule_radius);
 	ClassDB::bind_method(D_METHOD("get_hand_capsule_joint", "hand_index", "capsule_index"), &OpenXRFbHandTrackingCapsulesExtensionWrapper::get_hand_capsule_joint);
+	ClassDB::bind_method(D_METHOD("get_hand_capsules", "hand_index"), &OpenXRFbHandTrackingCapsulesExtensionWrapper::get_hand_capsules);
+	ClassDB::bind_method(D_METHOD("update_hand_capsule_shapes", "hand_index", "shapes"), &OpenXRFbHandTrackingCapsulesExtensionWrapper::update_hand_capsule_shapes);
 }
 
 void OpenXRFbHandTrackingCapsulesExtensionWrapper::cleanup() {
 	fb_hand_tracking_capsules_ext = false;
+
+	for (int i = 0; i < HAND_MAX; i++) {
+		capsule_cache[i] = CapsuleCache();
+	}
 }
 
 godot::Dictionary OpenXRFbHandTrackingCapsulesExtensionWrapper::_get_requested_extensions() {
@@ -94,34 +101,53 @@ uint64_t OpenXRFbHandTrackingCapsulesExtensionWrapper::_set_hand_joint_locations
 	return reinterpret_cast<uint64_t>(&capsules_state[p_hand_index]);
 }
 
-Transform3D OpenXRFbHandTrackingCapsulesExtensionWrapper::get_hand_capsule_transform(int p_hand_index, int p_capsule_index) const {
-	ERR_FAIL_INDEX_V_MSG(p_hand_index, HAND_MAX, Transform3D(), vformat("Invalid hand index %d", p_hand_index));
-	ERR_FAIL_INDEX_V_MSG(p_capsule_index, XR_FB_HAND_TRACKING_CAPSULE_COUNT, Transform3D(), vformat("Invalid capsule index %d", p_capsule_index));
-
+void OpenXRFbHandTrackingCapsulesExtensionWrapper::_on_process() {
 	if (!fb_hand_tracking_capsules_ext) {
-		return Transform3D();
+		return;
 	}
 
-	XrHandCapsuleFB capsule = capsules_state[p_hand_index].capsules[p_capsule_index];
+	for (int i = 0; i < HAND_MAX; i++) {
+		update_capsule_cache(i);
+	}
+}
+
+void OpenXRFbHandTrackingCapsulesExtensionWrapper::update_capsule_cache(int p_hand_index) {
+	const XrHandCapsuleFB *capsules = capsules_state[p_hand_index].capsules;
+	CapsuleCache &cache = capsule_cache[p_hand_index];
 
-	XrVector3f xr_p1 = capsule.points[0];
-	XrVector3f xr_p2 = capsule.points[1];
-	Vector3 p1 = Vector3(xr_p1.x, xr_p1.y, xr_p1.z);
-	Vector3 p2 = Vector3(xr_p2.x, xr_p2.y, xr_p2.z);
+	const Vector3 up_dir = Vector3(0, 1, 0);
+	const Vector3 right_dir = Vector3(1, 0, 0);
 
-	Vector3 up_dir = Vector3(0, 1, 0);
-	Vector3 right_dir = Vector3(1, 0, 0);
+	for (int i = 0; i < XR_HAND_TRACKING_CAPSULE_COUNT_FB; i++) {
+		const XrHandCapsuleFB &capsule = capsules[i];
 
-	Vector3 y_dir = (p2 - p1).normalized();
-	Vector3 x_dir = (y_dir.is_equal_approx(up_dir)) ? y_dir.cross(right_dir).normalized() : y_dir.cross(up_dir).normalized();
-	Vector3 z_dir = y_dir.cross(x_dir).normalized();
-	Basis basis = Basis(x_dir, y_dir, z_dir);
-	Vector3 center = (p1 + p2) * 0.5;
+		XrVector3f xr_p1 = capsule.points[0];
+		XrVector3f xr_p2 = capsule.points[1];
+		Vector3 p1 = Vector3(xr_p1.x, xr_p1.y, xr_p1.z);
+		Vector3 p2 = Vector3(xr_p2.x, xr_p2.y, xr_p2.z);
 
-	float height = p1.distance_to(p2) + (capsule.radius * 2.0);
-	Transform3D transform = Transform3D(basis, center);
+		Vector3 y_dir = (p2 - p1).normalized();
+		Vector3 x_dir = (y_dir.is_equal_approx(up_dir)) ? y_dir.cross(right_dir).normalized() : y_dir.cross(up_dir).normalized();
+		Vector3 z_dir = y_dir.cross(x_dir).normalized();
+		Basis basis = Basis(x_dir, y_dir, z_dir);
+		Vector3 center = (p1 + p2) * 0.5;
+
+		cache.transforms[i] = Transform3D(basis, center);
+		cache.heights[i] = p1.distance_to(p2) + (capsule.radius * 2.0);
+		cache.radii[i] = capsule.radius;
+		cache.joints[i] = HandJoint(capsule.joint);
+	}
+}
+
+Transform3D OpenXRFbHandTrackingCapsulesExtensionWrapper::get_hand_capsule_transform(int p_hand_index, int p_capsule_index) const {
+	ERR_FAIL_INDEX_V_MSG(p_hand_index, HAND_MAX, Transform3D(), vformat("Invalid hand index %d", p_hand_index));
+	ERR_FAIL_INDEX_V_MSG(p_capsule_index, XR_FB_HAND_TRACKING_CAPSULE_COUNT, Transform3D(), vformat("Invalid capsule index %d", p_capsule_index));
+
+	if (!fb_hand_tracking_capsules_ext) {
+		return Transform3D();
+	}
 
-	return Transform3D(basis, center);
+	return capsule_cache[p_hand_index].transforms[p_capsule_index];
 }
 
 float OpenXRFbHandTrackingCapsulesExtensionWrapper::get_hand_capsule_height(int p_hand_index, int p_capsule_index) const {
@@ -132,14 +158,7 @@ float OpenXRFbHandTrackingCapsulesExtensionWrapper::get_hand_capsule_height(int
 		return 0.0;
 	}
 
-	XrHandCapsuleFB capsule = capsules_state[p_hand_index].capsules[p_capsule_index];
-
-	XrVector3f xr_p1 = capsule.points[0];
-	XrVector3f xr_p2 = capsule.points[1];
-	Vector3 p1 = Vector3(xr_p1.x, xr_p1.y, xr_p1.z);
-	Vector3 p2 = Vector3(xr_p2.x, xr_p2.y, xr_p2.z);
-
-	return p1.distance_to(p2) + (capsule.radius * 2.0);
+	return capsule_cache[p_hand_index].heights[p_capsule_index];
 }
 
 float OpenXRFbHandTrackingCapsulesExtensionWrapper::get_hand_capsule_radius(int p_hand_index, int p_capsule_index) const {
@@ -150,8 +169,7 @@ float OpenXRFbHandTrackingCapsulesExtensionWrapper::get_hand_capsule_radius(int
 		return 0.0;
 	}
 
-	XrHandCapsuleFB capsule = capsules_state[p_hand_index].capsules[p_capsule_index];
-	return capsule.radius;
+	return capsule_cache[p_hand_index].radii[p_capsule_index];
 }
 
 XRHandTracker::HandJoint OpenXRFbHandTrackingCapsulesExtensionWrapper::get_hand_capsule_joint(int p_hand_index, int p_capsule_index) const {
@@ -162,6 +180,60 @@ XRHandTracker::HandJoint OpenXRFbHandTrackingCapsulesExtensionWrapper::get_hand_
 		return HandJoint(0);
 	}
 
-	XrHandCapsuleFB capsule = capsules_state[p_hand_index].capsules[p_capsule_index];
-	return HandJoint(capsule.joint);
+	return capsule_cache[p_hand_index].joints[p_capsule_index];
+}
+
+PackedFloat32Array OpenXRFbHandTrackingCapsulesExtensionWrapper::get_hand_capsules(int p_hand_index) const {
+	ERR_FAIL_INDEX_V_MSG(p_hand_index, HAND_MAX, PackedFloat32Array(), vformat("Invalid hand index %d", p_hand_index));
+
+	if (!fb_hand_tracking_capsules_ext) {
+		return PackedFloat32Array();
+	}
+
+	const CapsuleCache &cache = capsule_cache[p_hand_index];
+
+	PackedFloat32Array capsules;
+	capsules.resize(XR_HAND_TRACKING_CAPSULE_COUNT_FB * CAPSULE_DATA_STRIDE);
+	float *ptr = capsules.ptrw();
+	for (int i = 0; i < XR_HAND_TRACKING_CAPSULE_COUNT_FB; i++) {
+		const Vector3 &origin = cache.transforms[i].origin;
+		const Quaternion rotation = cache.transforms[i].basis.get_rotation_quaternion();
+		ptr[0] = origin.x;
+		ptr[1] = origin.y;
+		ptr[2] = origin.z;
+		ptr[3] = rotation.x;
+		ptr[4] = rotation.y;
+		ptr[5] = rotation.z;
+		ptr[6] = rotation.w;
+		ptr[7] = cache.heights[i];
+		ptr[8] = cache.radii[i];
+		ptr += CAPSULE_DATA_STRIDE;
+	}
+
+	return capsules;
+}
+
+void OpenXRFbHandTrackingCapsulesExtensionWrapper::update_hand_capsule_shapes(int p_hand_index, const TypedArray<CollisionShape3D> &p_shapes) {
+	ERR_FAIL_INDEX_MSG(p_hand_index, HAND_MAX, vformat("Invalid hand index %d", p_hand_index));
+
+	if (!fb_hand_tracking_capsules_ext) {
+		return;
+	}
+
+	const CapsuleCache &cache = capsule_cache[p_hand_index];
+	const int count = MIN(int(p_shapes.size()), XR_HAND_TRACKING_CAPSULE_COUNT_FB);
+	for (int i = 0; i < count; i++) {
+		CollisionShape3D *collision_shape = Object::cast_to<CollisionShape3D>(p_shapes[i]);
+		if (collision_shape == nullptr) {
+			continue;
+		}
+
+		collision_shape->set_transform(cache.transforms[i]);
+
+		Ref<CapsuleShape3D> capsule_shape = collision_shape->get_shape();
+		if (capsule_shape.is_valid()) {
+			capsule_shape->set_radius(cache.radii[i]);
+			capsule_shape->set_height(cache.heights[i]);
+		}
+	}
 }
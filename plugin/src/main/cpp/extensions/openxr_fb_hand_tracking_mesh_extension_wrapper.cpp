@@ -29,13 +29,65 @@
 
 #include "extensions/openxr_fb_hand_tracking_mesh_extension_wrapper.h"
 
+#include <godot_cpp/classes/file_access.hpp>
 #include <godot_cpp/classes/open_xrapi_extension.hpp>
 #include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
 #include <godot_cpp/classes/xr_hand_tracker.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 
 using namespace godot;
 
+// Hand mesh cache, holding the raw runtime mesh data of both hands.
+static const char *mesh_cache_path = "user://openxr_fb_hand_mesh.cache";
+static constexpr char mesh_cache_magic[4] = { 'F', 'B', 'H', 'M' };
+static constexpr uint32_t mesh_cache_version = 1;
+
+template <typename T>
+static void append_cache_data(PackedByteArray &r_data, const T *p_src, uint64_t p_count) {
+	const int64_t offset = r_data.size();
+	r_data.resize(offset + p_count * sizeof(T));
+	memcpy(r_data.ptrw() + offset, p_src, p_count * sizeof(T));
+}
+
+template <typename T>
+static bool read_cache_data(const PackedByteArray &p_data, uint64_t &r_offset, T *r_dst, uint64_t p_count) {
+	const uint64_t size = p_count * sizeof(T);
+	if (r_offset + size > uint64_t(p_data.size())) {
+		return false;
+	}
+	memcpy(r_dst, p_data.ptr() + r_offset, size);
+	r_offset += size;
+	return true;
+}
+
+template <typename T>
+static bool read_cache_array(const PackedByteArray &p_data, uint64_t &r_offset, LocalVector<T> &r_array, uint32_t p_count) {
+	r_array.resize(p_count);
+	return read_cache_data(p_data, r_offset, r_array.ptr(), p_count);
+}
+
+// Godot vectors match the OpenXR layout, unless built with double precision.
+static void copy_vectors(Vector3 *r_dst, const XrVector3f *p_src, uint32_t p_count) {
+	if constexpr (sizeof(Vector3) == sizeof(XrVector3f)) {
+		memcpy(r_dst, p_src, p_count * sizeof(XrVector3f));
+	} else {
+		for (uint32_t i = 0; i < p_count; i++) {
+			r_dst[i] = Vector3(p_src[i].x, p_src[i].y, p_src[i].z);
+		}
+	}
+}
+
+static void copy_vectors(Vector2 *r_dst, const XrVector2f *p_src, uint32_t p_count) {
+	if constexpr (sizeof(Vector2) == sizeof(XrVector2f)) {
+		memcpy(r_dst, p_src, p_count * sizeof(XrVector2f));
+	} else {
+		for (uint32_t i = 0; i < p_count; i++) {
+			r_dst[i] = Vector2(p_src[i].x, p_src[i].y);
+		}
+	}
+}
+
 OpenXRFbHandTrackingMeshExtensionWrapper *OpenXRFbHandTrackingMeshExtensionWrapper::singleton = nullptr;
 
 OpenXRFbHandTrackingMeshExtensionWrapper *OpenXRFbHandTrackingMeshExtensionWrapper::get_singleton() {
@@ -61,8 +113,12 @@ void OpenXRFbHandTrackingMeshExtensionWrapper::_bind_methods() {
 }
 
 void OpenXRFbHandTrackingMeshExtensionWrapper::cleanup() {
+	wait_for_fetch_task();
+
 	fb_hand_tracking_mesh_ext = false;
 	should_fetch_hand_mesh_data = false;
+	mesh_cache_checked = false;
+	mesh_cache_key = String();
 
 	for (int i = 0; i < Hand::HAND_MAX; i++) {
 		if (hand_mesh[i].is_valid()) {
@@ -74,6 +130,9 @@ void OpenXRFbHandTrackingMeshExtensionWrapper::cleanup() {
 		bone_data[i].joint_poses.clear();
 		bone_data[i].joint_radii.clear();
 		bone_data[i].joint_parents.clear();
+		cached_bone_data[i] = BoneData();
+		mesh_data[i].reset();
+		built_hand_mesh[i].unref();
 	}
 }
 
@@ -119,6 +178,13 @@ uint64_t OpenXRFbHandTrackingMeshExtensionWrapper::_set_hand_joint_locations_and
 }
 
 void OpenXRFbHandTrackingMeshExtensionWrapper::_on_process() {
+	if (fetch_state != FETCH_IDLE) {
+		if (!WorkerThreadPool::get_singleton()->is_task_completed(fetch_task_id)) {
+			return;
+		}
+		finish_fetch_task();
+	}
+
 	if (!should_fetch_hand_mesh_data) {
 		return;
 	}
@@ -127,6 +193,16 @@ void OpenXRFbHandTrackingMeshExtensionWrapper::_on_process() {
 		return;
 	}
 
+	// Try the on-disk cache first, so later sessions skip the runtime query.
+	if (!mesh_cache_checked) {
+		mesh_cache_checked = true;
+		mesh_cache_key = get_mesh_cache_key();
+		if (!mesh_cache_key.is_empty()) {
+			start_fetch_task(FETCH_LOADING_CACHE);
+			return;
+		}
+	}
+
 	XrHandTrackerEXT hand_trackers[Hand::HAND_MAX];
 	for (int i = 0; i < Hand::HAND_MAX; i++) {
 		hand_trackers[i] = reinterpret_cast<XrHandTrackerEXT>(get_openxr_api()->get_hand_tracker(i));
@@ -140,6 +216,36 @@ void OpenXRFbHandTrackingMeshExtensionWrapper::_on_process() {
 		fetch_hand_mesh_data(Hand(i));
 	}
 
+	start_fetch_task(FETCH_BUILDING_MESHES);
+}
+
+void OpenXRFbHandTrackingMeshExtensionWrapper::start_fetch_task(FetchState p_state) {
+	fetch_state = p_state;
+	if (p_state == FETCH_LOADING_CACHE) {
+		fetch_task_id = WorkerThreadPool::get_singleton()->add_task(callable_mp(this, &OpenXRFbHandTrackingMeshExtensionWrapper::_load_cache_task), false, "Load hand tracking mesh cache");
+	} else {
+		fetch_task_id = WorkerThreadPool::get_singleton()->add_task(callable_mp(this, &OpenXRFbHandTrackingMeshExtensionWrapper::_build_meshes_task), false, "Build hand tracking meshes");
+	}
+}
+
+void OpenXRFbHandTrackingMeshExtensionWrapper::finish_fetch_task() {
+	const FetchState state = fetch_state;
+	wait_for_fetch_task();
+
+	// On a cache miss, we query the runtime instead.
+	if (state == FETCH_LOADING_CACHE && !cache_loaded) {
+		return;
+	}
+
+	for (int i = 0; i < Hand::HAND_MAX; i++) {
+		if (state == FETCH_LOADING_CACHE) {
+			bone_data[i] = cached_bone_data[i];
+			cached_bone_data[i] = BoneData();
+		}
+		hand_mesh[i] = built_hand_mesh[i];
+		built_hand_mesh[i].unref();
+	}
+
 	for (const FetchCallback &fetch_callback : fetch_callbacks) {
 		fetch_callback.callable.call(hand_mesh[fetch_callback.hand]);
 	}
@@ -148,6 +254,45 @@ void OpenXRFbHandTrackingMeshExtensionWrapper::_on_process() {
 	should_fetch_hand_mesh_data = false;
 }
 
+void OpenXRFbHandTrackingMeshExtensionWrapper::wait_for_fetch_task() {
+	if (fetch_state == FETCH_IDLE) {
+		return;
+	}
+
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(fetch_task_id);
+	fetch_task_id = -1;
+	fetch_state = FETCH_IDLE;
+}
+
+void OpenXRFbHandTrackingMeshExtensionWrapper::_load_cache_task() {
+	cache_loaded = load_mesh_cache();
+	if (!cache_loaded) {
+		return;
+	}
+
+	for (int i = 0; i < Hand::HAND_MAX; i++) {
+		built_hand_mesh[i] = build_hand_mesh(mesh_data[i]);
+		mesh_data[i].reset();
+	}
+}
+
+void OpenXRFbHandTrackingMeshExtensionWrapper::_build_meshes_task() {
+	bool complete = true;
+	for (int i = 0; i < Hand::HAND_MAX; i++) {
+		built_hand_mesh[i] = build_hand_mesh(mesh_data[i]);
+		complete = complete && built_hand_mesh[i].is_valid();
+	}
+
+	// Only cache complete data, so a partial fetch is retried next session.
+	if (complete && !mesh_cache_key.is_empty()) {
+		save_mesh_cache();
+	}
+
+	for (int i = 0; i < Hand::HAND_MAX; i++) {
+		mesh_data[i].reset();
+	}
+}
+
 void OpenXRFbHandTrackingMeshExtensionWrapper::set_use_scale_override(Hand p_hand, bool p_use) {
 	hand_tracking_scale[p_hand].overrideHandScale = p_use;
 }
@@ -203,25 +348,20 @@ bool OpenXRFbHandTrackingMeshExtensionWrapper::fetch_hand_mesh_data(Hand p_hand)
 	bone_data[p_hand].joint_parents.resize(xr_hand_mesh.jointCapacityInput);
 	xr_hand_mesh.jointParents = bone_data[p_hand].joint_parents.ptr();
 
-	// mesh data will be used to construct ArrayMeshes and then be discarded
-	LocalVector<XrVector3f> vertex_positions;
-	vertex_positions.resize(xr_hand_mesh.vertexCapacityInput);
-	xr_hand_mesh.vertexPositions = vertex_positions.ptr();
-	LocalVector<XrVector3f> vertex_normals;
-	vertex_normals.resize(xr_hand_mesh.vertexCapacityInput);
-	xr_hand_mesh.vertexNormals = vertex_normals.ptr();
-	LocalVector<XrVector2f> vertex_uvs;
-	vertex_uvs.resize(xr_hand_mesh.vertexCapacityInput);
-	xr_hand_mesh.vertexUVs = vertex_uvs.ptr();
-	LocalVector<XrVector4sFB> vertex_blend_indices;
-	vertex_blend_indices.resize(xr_hand_mesh.vertexCapacityInput);
-	xr_hand_mesh.vertexBlendIndices = vertex_blend_indices.ptr();
-	LocalVector<XrVector4f> vertex_blend_weights;
-	vertex_blend_weights.resize(xr_hand_mesh.vertexCapacityInput);
-	xr_hand_mesh.vertexBlendWeights = vertex_blend_weights.ptr();
-	LocalVector<int16_t> indices;
-	indices.resize(xr_hand_mesh.indexCapacityInput);
-	xr_hand_mesh.indices = indices.ptr();
+	// mesh data will be used to construct ArrayMeshes on a worker thread and then be discarded
+	MeshData &data = mesh_data[p_hand];
+	data.vertex_positions.resize(xr_hand_mesh.vertexCapacityInput);
+	xr_hand_mesh.vertexPositions = data.vertex_positions.ptr();
+	data.vertex_normals.resize(xr_hand_mesh.vertexCapacityInput);
+	xr_hand_mesh.vertexNormals = data.vertex_normals.ptr();
+	data.vertex_uvs.resize(xr_hand_mesh.vertexCapacityInput);
+	xr_hand_mesh.vertexUVs = data.vertex_uvs.ptr();
+	data.vertex_blend_indices.resize(xr_hand_mesh.vertexCapacityInput);
+	xr_hand_mesh.vertexBlendIndices = data.vertex_blend_indices.ptr();
+	data.vertex_blend_weights.resize(xr_hand_mesh.vertexCapacityInput);
+	xr_hand_mesh.vertexBlendWeights = data.vertex_blend_weights.ptr();
+	data.indices.resize(xr_hand_mesh.indexCapacityInput);
+	xr_hand_mesh.indices = data.indices.ptr();
 
 	result = xrGetHandMeshFB(hand_tracker, &xr_hand_mesh);
 	if (XR_FAILED(result)) {
@@ -231,39 +371,56 @@ bool OpenXRFbHandTrackingMeshExtensionWrapper::fetch_hand_mesh_data(Hand p_hand)
 			should_fetch_hand_mesh_data = false;
 		}
 
+		data.reset();
 		return false;
 	}
 
-	// convert to clockwise winding order to cull correct face side
-	const int VERTICES_PER_TRIANGLE = 3;
-	for (int i = 0; i < xr_hand_mesh.indexCapacityInput; i += VERTICES_PER_TRIANGLE) {
-		SWAP(xr_hand_mesh.indices[i], xr_hand_mesh.indices[i + VERTICES_PER_TRIANGLE - 1]);
-	}
-
-	PackedVector3Array godot_vertex_positions = PackedVector3Array();
-	PackedVector3Array godot_vertex_normals = PackedVector3Array();
-	PackedVector2Array godot_vertex_uvs = PackedVector2Array();
-	PackedInt32Array godot_bone_indices = PackedInt32Array();
-	PackedFloat32Array godot_bone_weights = PackedFloat32Array();
-	for (int i = 0; i < xr_hand_mesh.vertexCapacityInput; i++) {
-		godot_vertex_positions.push_back(Vector3(xr_hand_mesh.vertexPositions[i].x, xr_hand_mesh.vertexPositions[i].y, xr_hand_mesh.vertexPositions[i].z));
-		godot_vertex_normals.push_back(Vector3(xr_hand_mesh.vertexNormals[i].x, xr_hand_mesh.vertexNormals[i].y, xr_hand_mesh.vertexNormals[i].z));
-		godot_vertex_uvs.push_back(Vector2(xr_hand_mesh.vertexUVs[i].x, xr_hand_mesh.vertexUVs[i].y));
+	return true;
+}
 
-		godot_bone_indices.push_back(xr_hand_mesh.vertexBlendIndices[i].x);
-		godot_bone_indices.push_back(xr_hand_mesh.vertexBlendIndices[i].y);
-		godot_bone_indices.push_back(xr_hand_mesh.vertexBlendIndices[i].z);
-		godot_bone_indices.push_back(xr_hand_mesh.vertexBlendIndices[i].w);
+Ref<ArrayMesh> OpenXRFbHandTrackingMeshExtensionWrapper::build_hand_mesh(const MeshData &p_mesh_data) {
+	const uint32_t vertex_count = p_mesh_data.vertex_positions.size();
+	const uint32_t index_count = p_mesh_data.indices.size();
+	if (vertex_count == 0 || index_count == 0) {
+		return Ref<ArrayMesh>();
+	}
 
-		godot_bone_weights.push_back(xr_hand_mesh.vertexBlendWeights[i].x);
-		godot_bone_weights.push_back(xr_hand_mesh.vertexBlendWeights[i].y);
-		godot_bone_weights.push_back(xr_hand_mesh.vertexBlendWeights[i].z);
-		godot_bone_weights.push_back(xr_hand_mesh.vertexBlendWeights[i].w);
+	// Everything is copied in bulk into pre-sized arrays.
+	PackedVector3Array godot_vertex_positions;
+	godot_vertex_positions.resize(vertex_count);
+	copy_vectors(godot_vertex_positions.ptrw(), p_mesh_data.vertex_positions.ptr(), vertex_count);
+
+	PackedVector3Array godot_vertex_normals;
+	godot_vertex_normals.resize(vertex_count);
+	copy_vectors(godot_vertex_normals.ptrw(), p_mesh_data.vertex_normals.ptr(), vertex_count);
+
+	PackedVector2Array godot_vertex_uvs;
+	godot_vertex_uvs.resize(vertex_count);
+	copy_vectors(godot_vertex_uvs.ptrw(), p_mesh_data.vertex_uvs.ptr(), vertex_count);
+
+	PackedInt32Array godot_bone_indices;
+	godot_bone_indices.resize(vertex_count * 4);
+	const int16_t *blend_indices = &p_mesh_data.vertex_blend_indices[0].x;
+	int32_t *bone_indices = godot_bone_indices.ptrw();
+	for (uint32_t i = 0; i < vertex_count * 4; i++) {
+		bone_indices[i] = blend_indices[i];
 	}
 
-	PackedInt32Array godot_indices = PackedInt32Array();
-	for (int i = 0; i < xr_hand_mesh.indexCapacityInput; i++) {
-		godot_indices.push_back(xr_hand_mesh.indices[i]);
+	static_assert(sizeof(XrVector4f) == 4 * sizeof(float), "XrVector4f is expected to be tightly packed.");
+	PackedFloat32Array godot_bone_weights;
+	godot_bone_weights.resize(vertex_count * 4);
+	memcpy(godot_bone_weights.ptrw(), p_mesh_data.vertex_blend_weights.ptr(), vertex_count * sizeof(XrVector4f));
+
+	// convert to clockwise winding order to cull correct face side
+	const uint32_t VERTICES_PER_TRIANGLE = 3;
+	PackedInt32Array godot_indices;
+	godot_indices.resize(index_count - index_count % VERTICES_PER_TRIANGLE);
+	const int16_t *src_indices = p_mesh_data.indices.ptr();
+	int32_t *dst_indices = godot_indices.ptrw();
+	for (int64_t i = 0; i < godot_indices.size(); i += VERTICES_PER_TRIANGLE) {
+		dst_indices[i] = src_indices[i + 2];
+		dst_indices[i + 1] = src_indices[i + 1];
+		dst_indices[i + 2] = src_indices[i];
 	}
 
 	Array arrays;
@@ -279,11 +436,120 @@ bool OpenXRFbHandTrackingMeshExtensionWrapper::fetch_hand_mesh_data(Hand p_hand)
 	array_mesh.instantiate();
 	array_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
 
-	hand_mesh[p_hand] = array_mesh;
+	return array_mesh;
+}
+
+String OpenXRFbHandTrackingMeshExtensionWrapper::get_mesh_cache_key() {
+	XrInstance instance = (XrInstance)get_openxr_api()->get_instance();
+
+	XrInstanceProperties instance_properties = {
+		XR_TYPE_INSTANCE_PROPERTIES, // type
+		nullptr, // next
+	};
+	XrResult result = xrGetInstanceProperties(instance, &instance_properties);
+	if (XR_FAILED(result)) {
+		return String();
+	}
+
+	XrSystemProperties system_properties = {
+		XR_TYPE_SYSTEM_PROPERTIES, // type
+		nullptr, // next
+	};
+	result = xrGetSystemProperties(instance, (XrSystemId)get_openxr_api()->get_system_id(), &system_properties);
+	if (XR_FAILED(result)) {
+		return String();
+	}
+
+	return vformat("%s|%d|%s|%d", String(instance_properties.runtimeName), (int64_t)instance_properties.runtimeVersion, String(system_properties.systemName), (int64_t)system_properties.vendorId);
+}
+
+bool OpenXRFbHandTrackingMeshExtensionWrapper::load_mesh_cache() {
+	if (!FileAccess::file_exists(mesh_cache_path)) {
+		return false;
+	}
+
+	const PackedByteArray data = FileAccess::get_file_as_bytes(mesh_cache_path);
+	const CharString key = mesh_cache_key.utf8();
+
+	uint64_t offset = 0;
+	char magic[4];
+	uint32_t version = 0;
+	uint32_t key_length = 0;
+	if (!read_cache_data(data, offset, magic, 4) || memcmp(magic, mesh_cache_magic, 4) != 0 ||
+			!read_cache_data(data, offset, &version, 1) || version != mesh_cache_version ||
+			!read_cache_data(data, offset, &key_length, 1) || key_length != uint32_t(key.length()) ||
+			offset + key_length > uint64_t(data.size()) || memcmp(data.ptr() + offset, key.get_data(), key_length) != 0) {
+		// Stale or foreign cache, it'll be replaced once the runtime data is fetched.
+		return false;
+	}
+	offset += key_length;
+
+	for (int i = 0; i < Hand::HAND_MAX; i++) {
+		uint32_t counts[3];
+		if (!read_cache_data(data, offset, counts, 3)) {
+			return false;
+		}
+
+		const uint32_t joint_count = counts[0];
+		const uint32_t vertex_count = counts[1];
+		const uint32_t index_count = counts[2];
+		if (joint_count < XRHandTracker::HAND_JOINT_MAX || vertex_count == 0 || index_count == 0) {
+			return false;
+		}
+
+		MeshData &mesh = mesh_data[i];
+		BoneData &bones = cached_bone_data[i];
+		if (!read_cache_array(data, offset, bones.joint_poses, joint_count) ||
+				!read_cache_array(data, offset, bones.joint_radii, joint_count) ||
+				!read_cache_array(data, offset, bones.joint_parents, joint_count) ||
+				!read_cache_array(data, offset, mesh.vertex_positions, vertex_count) ||
+				!read_cache_array(data, offset, mesh.vertex_normals, vertex_count) ||
+				!read_cache_array(data, offset, mesh.vertex_uvs, vertex_count) ||
+				!read_cache_array(data, offset, mesh.vertex_blend_indices, vertex_count) ||
+				!read_cache_array(data, offset, mesh.vertex_blend_weights, vertex_count) ||
+				!read_cache_array(data, offset, mesh.indices, index_count)) {
+			WARN_PRINT("Hand tracking mesh cache is truncated, ignoring it.");
+			return false;
+		}
+	}
 
 	return true;
 }
 
+void OpenXRFbHandTrackingMeshExtensionWrapper::save_mesh_cache() const {
+	const CharString key = mesh_cache_key.utf8();
+	const uint32_t key_length = key.length();
+
+	PackedByteArray data;
+	append_cache_data(data, mesh_cache_magic, 4);
+	append_cache_data(data, &mesh_cache_version, 1);
+	append_cache_data(data, &key_length, 1);
+	append_cache_data(data, key.get_data(), key_length);
+
+	for (int i = 0; i < Hand::HAND_MAX; i++) {
+		const MeshData &mesh = mesh_data[i];
+		const BoneData &bones = bone_data[i];
+		const uint32_t counts[3] = { bones.joint_poses.size(), mesh.vertex_positions.size(), mesh.indices.size() };
+		append_cache_data(data, counts, 3);
+		append_cache_data(data, bones.joint_poses.ptr(), bones.joint_poses.size());
+		append_cache_data(data, bones.joint_radii.ptr(), bones.joint_radii.size());
+		append_cache_data(data, bones.joint_parents.ptr(), bones.joint_parents.size());
+		append_cache_data(data, mesh.vertex_positions.ptr(), mesh.vertex_positions.size());
+		append_cache_data(data, mesh.vertex_normals.ptr(), mesh.vertex_normals.size());
+		append_cache_data(data, mesh.vertex_uvs.ptr(), mesh.vertex_uvs.size());
+		append_cache_data(data, mesh.vertex_blend_indices.ptr(), mesh.vertex_blend_indices.size());
+		append_cache_data(data, mesh.vertex_blend_weights.ptr(), mesh.vertex_blend_weights.size());
+		append_cache_data(data, mesh.indices.ptr(), mesh.indices.size());
+	}
+
+	Ref<FileAccess> file = FileAccess::open(mesh_cache_path, FileAccess::WRITE);
+	if (file.is_null()) {
+		WARN_PRINT(vformat("Failed to write hand tracking mesh cache: %s", mesh_cache_path));
+		return;
+	}
+	file->store_buffer(data);
+}
+
 void OpenXRFbHandTrackingMeshExtensionWrapper::request_hand_mesh_data(Hand p_hand, const Callable &p_callback) {
 	if (!is_enabled()) {
 		p_callback.call(Ref<Mesh>());
@@ -376,6 +642,8 @@ void OpenXRFbHandTrackingMeshExtensionWrapper::reset_skeleton_pose(Hand p_hand,
 
 bool OpenXRFbHandTrackingMeshExtensionWrapper::initialize_fb_hand_tracking_mesh_extension(const XrInstance instance) {
 	GDEXTENSION_INIT_XR_FUNC_V(xrGetHandMeshFB);
+	GDEXTENSION_INIT_XR_FUNC_V(xrGetInstanceProperties);
+	GDEXTENSION_INIT_XR_FUNC_V(xrGetSystemProperties);
 
 	return true;
 }
@@ -36,13 +36,22 @@
 #include <godot_cpp/classes/os.hpp>
 #include <godot_cpp/classes/rendering_server.hpp>
 #include <godot_cpp/classes/scene_tree.hpp>
+#include <godot_cpp/classes/shader.hpp>
 #include <godot_cpp/classes/viewport.hpp>
 #include <godot_cpp/classes/xr_server.hpp>
+#include <godot_cpp/templates/list.hpp>
 #include <godot_cpp/templates/local_vector.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 
 using namespace godot;
 
+static const char *HOLE_PUNCH_SHADER_CODE =
+		"shader_type spatial;\n"
+		"render_mode blend_mix, depth_draw_opaque, cull_back, shadow_to_opacity, shadows_disabled;\n"
+		"void fragment() {\n"
+		"\tALBEDO = vec3(0.0, 0.0, 0.0);\n"
+		"}\n";
+
 OpenXRFbPassthroughExtensionWrapper *OpenXRFbPassthroughExtensionWrapper::singleton = nullptr;
 
 OpenXRFbPassthroughExtensionWrapper *OpenXRFbPassthroughExtensionWrapper::get_singleton() {
@@ -95,6 +104,8 @@ void OpenXRFbPassthroughExtensionWrapper::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_color_lut", "weight", "color_lut"), &OpenXRFbPassthroughExtensionWrapper::set_color_lut);
 	ClassDB::bind_method(D_METHOD("set_interpolated_color_lut", "weight", "source_color_lut", "target_color_lut"), &OpenXRFbPassthroughExtensionWrapper::set_interpolated_color_lut);
 	ClassDB::bind_method(D_METHOD("get_max_color_lut_resolution"), &OpenXRFbPassthroughExtensionWrapper::get_max_color_lut_resolution);
+	ClassDB::bind_method(D_METHOD("set_max_unused_color_luts", "max_unused_color_luts"), &OpenXRFbPassthroughExtensionWrapper::set_max_unused_color_luts);
+	ClassDB::bind_method(D_METHOD("get_max_unused_color_luts"), &OpenXRFbPassthroughExtensionWrapper::get_max_unused_color_luts);
 
 	ADD_SIGNAL(MethodInfo("openxr_fb_projected_passthrough_layer_created"));
 	ADD_SIGNAL(MethodInfo("openxr_fb_passthrough_stopped"));
@@ -278,6 +289,24 @@ void OpenXRFbPassthroughExtensionWrapper::_on_session_destroyed() {
 			}
 			render_state.passthrough_handle = XR_NULL_HANDLE;
 
+			// Color LUTs are destroyed along with the passthrough feature, but they keep their
+			// data, so they're created again if they're used in a later session. This includes
+			// the ones still queued to be freed, which mustn't destroy their handle again.
+			List<RID> owned_color_luts;
+			color_luts.get_owned_list(&owned_color_luts);
+			for (const RID &color_lut_rid : owned_color_luts) {
+				ColorLut *color_lut = color_luts.get_or_null(color_lut_rid);
+				if (color_lut != nullptr) {
+					color_lut->handle = XR_NULL_HANDLE;
+				}
+			}
+			render_state.color_lut_handle = XR_NULL_HANDLE;
+			render_state.source_color_lut_handle = XR_NULL_HANDLE;
+			render_state.target_color_lut_handle = XR_NULL_HANDLE;
+			render_state.color_map_lut.colorLut = XR_NULL_HANDLE;
+			render_state.color_map_interpolated_lut.sourceColorLut = XR_NULL_HANDLE;
+			render_state.color_map_interpolated_lut.targetColorLut = XR_NULL_HANDLE;
+
 			get_openxr_api()->unregister_composition_layer_provider(this);
 			get_openxr_api()->set_emulate_environment_blend_mode_alpha_blend(false);
 		}
@@ -450,16 +479,35 @@ void OpenXRFbPassthroughExtensionWrapper::_stop_passthrough_rt() {
 }
 
 RID OpenXRFbPassthroughExtensionWrapper::geometry_instance_create(const Array &p_array_mesh, const Transform3D &p_transform) {
+	ERR_FAIL_COND_V(p_array_mesh.size() != Mesh::ARRAY_MAX, RID());
+	PackedVector3Array vertices = p_array_mesh[Mesh::ARRAY_VERTEX];
+	PackedInt32Array indices = p_array_mesh[Mesh::ARRAY_INDEX];
+	return geometry_instance_create(vertices, indices, p_transform);
+}
+
+RID OpenXRFbPassthroughExtensionWrapper::geometry_instance_create(const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices, const Transform3D &p_transform) {
+	ERR_FAIL_COND_V_MSG(p_indices.is_empty() || p_indices.size() % 3 != 0, RID(), "Passthrough geometry must have indices for a whole number of triangles.");
+
+	// Negative indices wrap around to large unsigned values, so one comparison covers both bounds.
+	const uint32_t vertex_count = p_vertices.size();
+	const int32_t *index_ptr = p_indices.ptr();
+	uint32_t max_index = 0;
+	for (int i = 0; i < p_indices.size(); i++) {
+		max_index = MAX(max_index, (uint32_t)index_ptr[i]);
+	}
+	ERR_FAIL_COND_V_MSG(max_index >= vertex_count, RID(), "Passthrough geometry has indices outside of its vertex array.");
+
 	if (current_passthrough_layer != LAYER_PURPOSE_PROJECTED) {
 		start_passthrough_layer(LAYER_PURPOSE_PROJECTED);
 	}
 
+	// The packed arrays are shared with the render thread rather than copied.
 	RID ret = geometry_instances.make_rid();
-	RenderingServer::get_singleton()->call_on_render_thread(callable_mp(this, &OpenXRFbPassthroughExtensionWrapper::_geometry_instance_initialize_rt).bind(ret, p_array_mesh, p_transform));
+	RenderingServer::get_singleton()->call_on_render_thread(callable_mp(this, &OpenXRFbPassthroughExtensionWrapper::_geometry_instance_initialize_rt).bind(ret, p_vertices, p_indices, p_transform));
 	return ret;
 }
 
-void OpenXRFbPassthroughExtensionWrapper::_geometry_instance_initialize_rt(RID p_geometry_instance, const Array &p_array_mesh, const Transform3D &p_transform) {
+void OpenXRFbPassthroughExtensionWrapper::_geometry_instance_initialize_rt(RID p_geometry_instance, const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices, const Transform3D &p_transform) {
 	GeometryInstance *geometry_instance = geometry_instances.get_or_null(p_geometry_instance);
 
 	if (geometry_instance == nullptr) {
@@ -476,24 +524,25 @@ void OpenXRFbPassthroughExtensionWrapper::_geometry_instance_initialize_rt(RID p
 		return;
 	}
 
-	Array vertex_array = p_array_mesh[Mesh::ARRAY_VERTEX];
-	LocalVector<XrVector3f> vertices;
-	vertices.resize(vertex_array.size());
-	for (int j = 0; j < vertex_array.size(); j++) {
-		Vector3 vertex = vertex_array[j];
-		vertices[j] = {
-			static_cast<float>(vertex.x),
-			static_cast<float>(vertex.y),
-			static_cast<float>(vertex.z)
+	// With single precision, Vector3 has the same layout as XrVector3f, and the
+	// indices were validated as non-negative, so both can be passed as they are.
+#ifdef REAL_T_IS_DOUBLE
+	LocalVector<XrVector3f> vertex_buffer;
+	vertex_buffer.resize(p_vertices.size());
+	const Vector3 *vertex_ptr = p_vertices.ptr();
+	for (int i = 0; i < p_vertices.size(); i++) {
+		vertex_buffer[i] = {
+			static_cast<float>(vertex_ptr[i].x),
+			static_cast<float>(vertex_ptr[i].y),
+			static_cast<float>(vertex_ptr[i].z)
 		};
 	}
-
-	Array index_array = p_array_mesh[Mesh::ARRAY_INDEX];
-	LocalVector<uint32_t> indices;
-	indices.resize(index_array.size());
-	for (int j = 0; j < index_array.size(); j++) {
-		indices[j] = index_array[j];
-	}
+	const XrVector3f *vertices = vertex_buffer.ptr();
+#else
+	static_assert(sizeof(Vector3) == sizeof(XrVector3f), "Vector3 doesn't match the layout of XrVector3f.");
+	const XrVector3f *vertices = reinterpret_cast<const XrVector3f *>(p_vertices.ptr());
+#endif
+	const uint32_t *indices = reinterpret_cast<const uint32_t *>(p_indices.ptr());
 
 	XrTriangleMeshFB mesh = XR_NULL_HANDLE;
 	XrTriangleMeshCreateInfoFB triangle_mesh_info = {
@@ -501,10 +550,10 @@ void OpenXRFbPassthroughExtensionWrapper::_geometry_instance_initialize_rt(RID p
 		nullptr, // next
 		0, // flags
 		XR_WINDING_ORDER_CW_FB, // windingOrder
-		(uint32_t)vertex_array.size(), // vertexCount
-		vertices.ptr(), // vertexBuffer
-		(uint32_t)index_array.size(), // triangleCount
-		indices.ptr(), // indexBuffer
+		(uint32_t)p_vertices.size(), // vertexCount
+		vertices, // vertexBuffer
+		(uint32_t)p_indices.size() / 3, // triangleCount
+		indices, // indexBuffer
 	};
 
 	XrResult result = xrCreateTriangleMeshFB(SESSION, &triangle_mesh_info, &mesh);
@@ -550,61 +599,100 @@ void OpenXRFbPassthroughExtensionWrapper::_geometry_instance_initialize_rt(RID p
 	result = xrCreateGeometryInstanceFB(SESSION, &geometry_instance_info, &geometry_instance->handle);
 	if (XR_FAILED(result)) {
 		UtilityFunctions::print("Failed to create geometry instance, error code: ", result);
+		xrDestroyTriangleMeshFB(mesh);
 		return;
 	}
 }
 
 void OpenXRFbPassthroughExtensionWrapper::geometry_instance_set_transform(RID p_geometry_instance, const Transform3D &p_transform) {
-	RenderingServer::get_singleton()->call_on_render_thread(callable_mp(this, &OpenXRFbPassthroughExtensionWrapper::_geometry_instance_set_transform_rt).bind(p_geometry_instance, p_transform));
+	geometry_instance_transforms[p_geometry_instance] = p_transform;
+
+	if (!geometry_instance_transforms_flush_queued) {
+		geometry_instance_transforms_flush_queued = true;
+		callable_mp(this, &OpenXRFbPassthroughExtensionWrapper::_flush_geometry_instance_transforms).call_deferred();
+	}
 }
 
-void OpenXRFbPassthroughExtensionWrapper::_geometry_instance_set_transform_rt(RID p_geometry_instance, const Transform3D &p_transform) {
-	GeometryInstance *geometry_instance = geometry_instances.get_or_null(p_geometry_instance);
+void OpenXRFbPassthroughExtensionWrapper::_flush_geometry_instance_transforms() {
+	geometry_instance_transforms_flush_queued = false;
 
-	if (geometry_instance == nullptr) {
+	if (geometry_instance_transforms.is_empty()) {
 		return;
 	}
 
-	Transform3D reference_frame = XRServer::get_singleton()->get_reference_frame();
-	Transform3D transform = reference_frame.inverse() * p_transform;
+	{
+		std::lock_guard<std::mutex> lock(geometry_instance_transforms_rt_mutex);
+		for (const KeyValue<RID, Transform3D> &E : geometry_instance_transforms) {
+			geometry_instance_transforms_rt.push_back({ E.key, E.value });
+		}
+	}
+	geometry_instance_transforms.clear();
 
-	Quaternion quat = transform.basis.get_rotation_quaternion();
-	Vector3 scale = transform.basis.get_scale();
+	RenderingServer::get_singleton()->call_on_render_thread(callable_mp(this, &OpenXRFbPassthroughExtensionWrapper::_geometry_instance_set_transforms_rt));
+}
 
-	XrQuaternionf xr_orientation = {
-		static_cast<float>(quat.x),
-		static_cast<float>(quat.y),
-		static_cast<float>(quat.z),
-		static_cast<float>(quat.w)
-	};
-	XrVector3f xr_position = {
-		static_cast<float>(transform.origin.x),
-		static_cast<float>(transform.origin.y),
-		static_cast<float>(transform.origin.z)
-	};
-	XrPosef xr_pose = { xr_orientation, xr_position };
-	XrVector3f xr_scale = {
-		static_cast<float>(scale.x),
-		static_cast<float>(scale.y),
-		static_cast<float>(scale.z)
-	};
+void OpenXRFbPassthroughExtensionWrapper::_geometry_instance_set_transforms_rt() {
+	std::lock_guard<std::mutex> lock(geometry_instance_transforms_rt_mutex);
 
-	XrGeometryInstanceTransformFB xr_transform = {
-		XR_TYPE_GEOMETRY_INSTANCE_TRANSFORM_FB, // type
-		nullptr, // next
-		(XrSpace)get_openxr_api()->get_play_space(), // baseSpace
-		(XrTime)get_openxr_api()->get_predicted_display_time(), // time
-		xr_pose, // pose
-		xr_scale, // scale
-	};
+	if (geometry_instance_transforms_rt.is_empty()) {
+		return;
+	}
 
-	XrResult result = xrGeometryInstanceSetTransformFB(geometry_instance->handle, &xr_transform);
-	if (XR_FAILED(result)) {
-		UtilityFunctions::print("Failed to set geometry instance transform, error code: ", result);
+	Transform3D inverse_reference_frame = XRServer::get_singleton()->get_reference_frame().inverse();
+	XrSpace play_space = (XrSpace)get_openxr_api()->get_play_space();
+	XrTime display_time = (XrTime)get_openxr_api()->get_predicted_display_time();
+
+	// Flushes that haven't been handled yet are appended in order, so the last transform still wins.
+	for (const GeometryInstanceTransform &geometry_instance_transform : geometry_instance_transforms_rt) {
+		GeometryInstance *geometry_instance = geometry_instances.get_or_null(geometry_instance_transform.geometry_instance);
+
+		if (geometry_instance == nullptr || geometry_instance->handle == XR_NULL_HANDLE) {
+			continue;
+		}
+
+		Transform3D transform = inverse_reference_frame * geometry_instance_transform.transform;
+
+		Quaternion quat = transform.basis.get_rotation_quaternion();
+		Vector3 scale = transform.basis.get_scale();
+
+		XrQuaternionf xr_orientation = {
+			static_cast<float>(quat.x),
+			static_cast<float>(quat.y),
+			static_cast<float>(quat.z),
+			static_cast<float>(quat.w)
+		};
+		XrVector3f xr_position = {
+			static_cast<float>(transform.origin.x),
+			static_cast<float>(transform.origin.y),
+			static_cast<float>(transform.origin.z)
+		};
+		XrPosef xr_pose = { xr_orientation, xr_position };
+		XrVector3f xr_scale = {
+			static_cast<float>(scale.x),
+			static_cast<float>(scale.y),
+			static_cast<float>(scale.z)
+		};
+
+		XrGeometryInstanceTransformFB xr_transform = {
+			XR_TYPE_GEOMETRY_INSTANCE_TRANSFORM_FB, // type
+			nullptr, // next
+			play_space, // baseSpace
+			display_time, // time
+			xr_pose, // pose
+			xr_scale, // scale
+		};
+
+		XrResult result = xrGeometryInstanceSetTransformFB(geometry_instance->handle, &xr_transform);
+		if (XR_FAILED(result)) {
+			UtilityFunctions::print("Failed to set geometry instance transform, error code: ", result);
+		}
 	}
+
+	geometry_instance_transforms_rt.clear();
 }
 
 void OpenXRFbPassthroughExtensionWrapper::geometry_instance_free(RID p_geometry_instance) {
+	geometry_instance_transforms.erase(p_geometry_instance);
 	RenderingServer::get_singleton()->call_on_render_thread(callable_mp(this, &OpenXRFbPassthroughExtensionWrapper::_geometry_instance_free_rt).bind(p_geometry_instance));
 }
 
@@ -623,6 +711,141 @@ void OpenXRFbPassthroughExtensionWrapper::_geometry_instance_free_rt(RID p_geome
 	geometry_instances.free(p_geometry_instance);
 }
 
+Ref<ShaderMaterial> OpenXRFbPassthroughExtensionWrapper::get_hole_punch_material() {
+	if (hole_punch_material.is_null()) {
+		Ref<Shader> shader;
+		shader.instantiate();
+		shader->set_code(HOLE_PUNCH_SHADER_CODE);
+
+		hole_punch_material.instantiate();
+		hole_punch_material->set_shader(shader);
+	}
+	return hole_punch_material;
+}
+
+RID OpenXRFbPassthroughExtensionWrapper::hole_punch_create(const Ref<Mesh> &p_mesh, RID p_scenario, const Transform3D &p_transform) {
+	ERR_FAIL_COND_V(p_mesh.is_null(), RID());
+
+	RID batch_rid;
+	for (const RID &E : hole_punch_batch_list) {
+		const HolePunchBatch *batch = hole_punch_batches.get_or_null(E);
+		if (batch->mesh == p_mesh && batch->scenario == p_scenario) {
+			batch_rid = E;
+			break;
+		}
+	}
+
+	RenderingServer *rendering_server = RenderingServer::get_singleton();
+
+	if (!batch_rid.is_valid()) {
+		HolePunchBatch new_batch;
+		new_batch.mesh = p_mesh;
+		new_batch.scenario = p_scenario;
+		new_batch.multimesh = rendering_server->multimesh_create();
+		rendering_server->multimesh_set_mesh(new_batch.multimesh, p_mesh->get_rid());
+		new_batch.instance = rendering_server->instance_create2(new_batch.multimesh, p_scenario);
+		rendering_server->instance_geometry_set_material_override(new_batch.instance, get_hole_punch_material()->get_rid());
+		rendering_server->instance_geometry_set_cast_shadows_setting(new_batch.instance, RenderingServer::SHADOW_CASTING_SETTING_OFF);
+
+		batch_rid = hole_punch_batches.make_rid(new_batch);
+		hole_punch_batch_list.push_back(batch_rid);
+	}
+
+	HolePunchBatch *batch = hole_punch_batches.get_or_null(batch_rid);
+
+	HolePunch hole_punch;
+	hole_punch.batch = batch_rid;
+	hole_punch.index = batch->hole_punches.size();
+	hole_punch.transform = p_transform;
+
+	RID ret = hole_punches.make_rid(hole_punch);
+	batch->hole_punches.push_back(ret);
+	_queue_hole_punch_flush(batch);
+	return ret;
+}
+
+void OpenXRFbPassthroughExtensionWrapper::hole_punch_set_transform(RID p_hole_punch, const Transform3D &p_transform) {
+	HolePunch *hole_punch = hole_punches.get_or_null(p_hole_punch);
+	ERR_FAIL_NULL(hole_punch);
+
+	hole_punch->transform = p_transform;
+	_queue_hole_punch_flush(hole_punch_batches.get_or_null(hole_punch->batch));
+}
+
+void OpenXRFbPassthroughExtensionWrapper::hole_punch_free(RID p_hole_punch) {
+	HolePunch *hole_punch = hole_punches.get_or_null(p_hole_punch);
+	ERR_FAIL_NULL(hole_punch);
+
+	RID batch_rid = hole_punch->batch;
+	HolePunchBatch *batch = hole_punch_batches.get_or_null(batch_rid);
+
+	// Move the last hole punch of the batch into the freed slot.
+	uint32_t last = batch->hole_punches.size() - 1;
+	if (hole_punch->index != last) {
+		RID moved = batch->hole_punches[last];
+		batch->hole_punches[hole_punch->index] = moved;
+		hole_punches.get_or_null(moved)->index = hole_punch->index;
+	}
+	batch->hole_punches.resize(last);
+	hole_punches.free(p_hole_punch);
+
+	if (batch->hole_punches.is_empty()) {
+		RenderingServer *rendering_server = RenderingServer::get_singleton();
+		rendering_server->free_rid(batch->instance);
+		rendering_server->free_rid(batch->multimesh);
+
+		hole_punch_batch_list.erase(batch_rid);
+		hole_punch_batches.free(batch_rid);
+		return;
+	}
+
+	_queue_hole_punch_flush(batch);
+}
+
+void OpenXRFbPassthroughExtensionWrapper::_queue_hole_punch_flush(HolePunchBatch *p_batch) {
+	p_batch->dirty = true;
+
+	if (!hole_punch_flush_queued) {
+		hole_punch_flush_queued = true;
+		callable_mp(this, &OpenXRFbPassthroughExtensionWrapper::_flush_hole_punches).call_deferred();
+	}
+}
+
+void OpenXRFbPassthroughExtensionWrapper::_flush_hole_punches() {
+	hole_punch_flush_queued = false;
+
+	RenderingServer *rendering_server = RenderingServer::get_singleton();
+
+	for (const RID &E : hole_punch_batch_list) {
+		HolePunchBatch *batch = hole_punch_batches.get_or_null(E);
+		if (!batch->dirty) {
+			continue;
+		}
+		batch->dirty = false;
+
+		uint32_t count = batch->hole_punches.size();
+		if (count != batch->allocated_count) {
+			rendering_server->multimesh_allocate_data(batch->multimesh, count, RenderingServer::MULTIMESH_TRANSFORM_3D);
+			batch->allocated_count = count;
+		}
+
+		// Each instance is a 3x4 row-major transform.
+		PackedFloat32Array buffer;
+		buffer.resize(count * 12);
+		float *ptr = buffer.ptrw();
+		for (uint32_t i = 0; i < count; i++) {
+			const Transform3D &transform = hole_punches.get_or_null(batch->hole_punches[i])->transform;
+			for (int row = 0; row < 3; row++) {
+				*ptr++ = transform.basis.rows[row].x;
+				*ptr++ = transform.basis.rows[row].y;
+				*ptr++ = transform.basis.rows[row].z;
+				*ptr++ = transform.origin[row];
+			}
+		}
+		rendering_server->multimesh_set_buffer(batch->multimesh, buffer);
+	}
+}
+
 void OpenXRFbPassthroughExtensionWrapper::set_texture_opacity_factor(float p_value) {
 	texture_opacity_factor = p_value;
 	RenderingServer::get_singleton()->call_on_render_thread(callable_mp(this, &OpenXRFbPassthroughExtensionWrapper::_set_texture_opacity_factor_rt).bind(p_value));
@@ -873,7 +1096,37 @@ void OpenXRFbPassthroughExtensionWrapper::_set_interpolated_color_lut_rt(float p
 	}
 }
 
-RID OpenXRFbPassthroughExtensionWrapper::color_lut_create(OpenXRMetaPassthroughColorLut::ColorLutChannels p_channels, uint32_t p_image_cell_resolution, const PackedByteArray &p_buffer) {
+RID OpenXRFbPassthroughExtensionWrapper::color_lut_acquire(uint64_t p_content_hash) {
+	std::lock_guard<std::mutex> lock(color_lut_cache_mutex);
+	return _color_lut_acquire(p_content_hash);
+}
+
+RID OpenXRFbPassthroughExtensionWrapper::_color_lut_acquire(uint64_t p_content_hash) {
+	const RID *cached = color_lut_cache.getptr(p_content_hash);
+	if (cached == nullptr) {
+		return RID();
+	}
+
+	ColorLut *color_lut = color_luts.get_or_null(*cached);
+	ERR_FAIL_NULL_V(color_lut, RID());
+
+	if (color_lut->reference_count == 0) {
+		unused_color_luts.erase(*cached);
+	}
+	color_lut->reference_count++;
+
+	return *cached;
+}
+
+RID OpenXRFbPassthroughExtensionWrapper::color_lut_create(OpenXRMetaPassthroughColorLut::ColorLutChannels p_channels, uint32_t p_image_cell_resolution, const PackedByteArray &p_buffer, uint64_t p_content_hash) {
+	std::lock_guard<std::mutex> lock(color_lut_cache_mutex);
+
+	// The same content may have been created while this one was being populated.
+	RID cached = _color_lut_acquire(p_content_hash);
+	if (cached.is_valid()) {
+		return cached;
+	}
+
 	if (p_image_cell_resolution > system_passthrough_color_lut_properties.maxColorLutResolution) {
 		UtilityFunctions::print("Color LUT cell resolution cannot be greater than the maximum resolution supported by this system: ", system_passthrough_color_lut_properties.maxColorLutResolution);
 		return RID();
@@ -889,7 +1142,15 @@ RID OpenXRFbPassthroughExtensionWrapper::color_lut_create(OpenXRMetaPassthroughC
 		} break;
 	}
 
-	return color_luts.make_rid({ channels, p_image_cell_resolution, p_buffer });
+	ColorLut color_lut;
+	color_lut.channels = channels;
+	color_lut.image_cell_resolution = p_image_cell_resolution;
+	color_lut.buffer = p_buffer;
+	color_lut.content_hash = p_content_hash;
+
+	RID ret = color_luts.make_rid(color_lut);
+	color_lut_cache.insert(p_content_hash, ret);
+	return ret;
 }
 
 XrPassthroughColorLutMETA OpenXRFbPassthroughExtensionWrapper::_color_lut_get_handle_rt(RID p_color_lut) {
@@ -925,22 +1186,65 @@ XrPassthroughColorLutMETA OpenXRFbPassthroughExtensionWrapper::_color_lut_get_ha
 }
 
 void OpenXRFbPassthroughExtensionWrapper::color_lut_free(RID p_color_lut) {
-	RenderingServer::get_singleton()->call_on_render_thread(callable_mp(this, &OpenXRFbPassthroughExtensionWrapper::_color_lut_free_rt).bind(p_color_lut));
+	// Color LUT resources can be released on the render thread.
+	std::lock_guard<std::mutex> lock(color_lut_cache_mutex);
+
+	ColorLut *color_lut = color_luts.get_or_null(p_color_lut);
+	ERR_FAIL_NULL(color_lut);
+	ERR_FAIL_COND(color_lut->reference_count == 0);
+
+	color_lut->reference_count--;
+	if (color_lut->reference_count > 0) {
+		return;
+	}
+
+	// Keep the runtime handle, in case the same color LUT is created again.
+	unused_color_luts.push_back(p_color_lut);
+	_trim_unused_color_luts();
+}
+
+void OpenXRFbPassthroughExtensionWrapper::_trim_unused_color_luts() {
+	while ((int)unused_color_luts.size() > max_unused_color_luts) {
+		RID color_lut_rid = unused_color_luts[0];
+		unused_color_luts.remove_at(0);
+
+		ColorLut *color_lut = color_luts.get_or_null(color_lut_rid);
+		if (color_lut != nullptr) {
+			color_lut_cache.erase(color_lut->content_hash);
+		}
+
+		RenderingServer::get_singleton()->call_on_render_thread(callable_mp(this, &OpenXRFbPassthroughExtensionWrapper::_color_lut_free_rt).bind(color_lut_rid));
+	}
+}
+
+void OpenXRFbPassthroughExtensionWrapper::set_max_unused_color_luts(int p_max_unused_color_luts) {
+	std::lock_guard<std::mutex> lock(color_lut_cache_mutex);
+	max_unused_color_luts = MAX(p_max_unused_color_luts, 0);
+	_trim_unused_color_luts();
+}
+
+int OpenXRFbPassthroughExtensionWrapper::get_max_unused_color_luts() const {
+	return max_unused_color_luts;
 }
 
 void OpenXRFbPassthroughExtensionWrapper::_color_lut_free_rt(RID p_color_lut) {
 	ColorLut *color_lut = color_luts.get_or_null(p_color_lut);
-	XrPassthroughColorLutMETA handle = color_lut ? color_lut->handle : XR_NULL_HANDLE;
+	if (color_lut == nullptr) {
+		UtilityFunctions::print("Cannot delete invalid color LUT");
+		return;
+	}
 
+	// The runtime handle is only created once the color LUT is used.
+	XrPassthroughColorLutMETA handle = color_lut->handle;
 	if (handle == XR_NULL_HANDLE) {
-		UtilityFunctions::print("Cannot delete invalid color LUT");
+		color_luts.free(p_color_lut);
 		return;
 	}
 
 	XrResult result = xrDestroyPassthroughColorLutMETA(handle);
 	if (XR_FAILED(result)) {
+		// The color LUT can't be used any more, so still release it below.
 		UtilityFunctions::printerr("Failed to destroy passthrough color LUT, error code: ", result);
-		return;
 	}
 
 	if (render_state.color_lut_handle == handle) {
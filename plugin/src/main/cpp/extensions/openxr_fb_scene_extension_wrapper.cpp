@@ -29,6 +29,8 @@
 
 #include "extensions/openxr_fb_scene_extension_wrapper.h"
 
+#include <cstring>
+
 #include <godot_cpp/classes/object.hpp>
 #include <godot_cpp/classes/open_xrapi_extension.hpp>
 #include <godot_cpp/templates/local_vector.hpp>
@@ -101,9 +103,46 @@ const PackedStringArray &OpenXRFbSceneExtensionWrapper::get_supported_semantic_l
 	return semantic_labels;
 }
 
-PackedStringArray OpenXRFbSceneExtensionWrapper::get_semantic_labels(const XrSpace p_space) {
+int OpenXRFbSceneExtensionWrapper::find_semantic_label(const char *p_label, int p_length) {
+	int index = 0;
+	const char *label = SUPPORTED_SEMANTIC_LABELS;
+	while (*label != '\0') {
+		const char *end = strchr(label, ',');
+		int length = end ? int(end - label) : int(strlen(label));
+		if (length == p_length && strncmp(label, p_label, length) == 0) {
+			return index;
+		}
+		if (end == nullptr) {
+			break;
+		}
+		label = end + 1;
+		index++;
+	}
+	return -1;
+}
+
+int OpenXRFbSceneExtensionWrapper::find_semantic_label(const String &p_label) {
+	CharString label = p_label.to_upper().utf8();
+	return find_semantic_label(label.get_data(), label.length());
+}
+
+uint32_t OpenXRFbSceneExtensionWrapper::get_semantic_label_mask(const PackedStringArray &p_labels) {
+	uint32_t mask = 0;
+	for (int i = 0; i < p_labels.size(); i++) {
+		int index = find_semantic_label(p_labels[i]);
+		if (index >= 0) {
+			mask |= 1u << index;
+		}
+	}
+	return mask;
+}
+
+bool OpenXRFbSceneExtensionWrapper::get_semantic_labels(const XrSpace p_space, PackedStringArray &r_labels, uint32_t &r_mask) {
+	r_labels.clear();
+	r_mask = 0;
+
 	if (!OpenXRFbSpatialEntityExtensionWrapper::get_singleton()->is_component_enabled(p_space, XR_SPACE_COMPONENT_TYPE_SEMANTIC_LABELS_FB)) {
-		return PackedStringArray();
+		return false;
 	}
 
 	XrSemanticLabelsSupportFlagsFB flags = XR_SEMANTIC_LABELS_SUPPORT_MULTIPLE_SEMANTIC_LABELS_BIT_FB | XR_SEMANTIC_LABELS_SUPPORT_ACCEPT_DESK_TO_TABLE_MIGRATION_BIT_FB | XR_SEMANTIC_LABELS_SUPPORT_ACCEPT_INVISIBLE_WALL_FACE_BIT_FB;
@@ -118,21 +157,50 @@ PackedStringArray OpenXRFbSceneExtensionWrapper::get_semantic_labels(const XrSpa
 	XrSemanticLabelsFB labels = { XR_TYPE_SEMANTIC_LABELS_FB, &semanticLabelsSupportInfo, 0 };
 
 	// First call.
-	xrGetSpaceSemanticLabelsFB(SESSION, p_space, &labels);
+	XrResult result = xrGetSpaceSemanticLabelsFB(SESSION, p_space, &labels);
+	if (XR_FAILED(result)) {
+		WARN_PRINT("xrGetSpaceSemanticLabelsFB failed to get label buffer size!");
+		WARN_PRINT(get_openxr_api()->get_error_string(result));
+		return false;
+	}
 
 	// Second call
 	CharString label_data;
 	label_data.resize(labels.bufferCountOutput + 1);
 	labels.bufferCapacityInput = labels.bufferCountOutput;
 	labels.buffer = label_data.ptrw();
-	xrGetSpaceSemanticLabelsFB(SESSION, p_space, &labels);
+	result = xrGetSpaceSemanticLabelsFB(SESSION, p_space, &labels);
+	if (XR_FAILED(result)) {
+		WARN_PRINT("xrGetSpaceSemanticLabelsFB failed to get labels!");
+		WARN_PRINT(get_openxr_api()->get_error_string(result));
+		return false;
+	}
 
 	label_data[label_data.size() - 1] = '\0';
 
-	// We decided to deal with semantic labels in lower-case to make it easier to use them as part of
-	// property names on Godot objects, since Godot automatically converts property names to lower case
-	// when saving.
-	return String(label_data).to_lower().split(",");
+	// Labels we asked the runtime for are matched in place against our list, and
+	// share its lower-case strings, rather than each being copied and lowered.
+	const PackedStringArray &supported_labels = get_supported_semantic_labels();
+	const char *label = label_data.get_data();
+	while (*label != '\0') {
+		const char *end = strchr(label, ',');
+		int length = end ? int(end - label) : int(strlen(label));
+		if (length > 0) {
+			int index = find_semantic_label(label, length);
+			if (index >= 0) {
+				r_labels.push_back(supported_labels[index]);
+				r_mask |= 1u << index;
+			} else {
+				r_labels.push_back(String::utf8(label, length).to_lower());
+			}
+		}
+		if (end == nullptr) {
+			break;
+		}
+		label = end + 1;
+	}
+
+	return true;
 }
 
 bool OpenXRFbSceneExtensionWrapper::get_room_layout(const XrSpace p_space, RoomLayout &r_room_layout) {
@@ -51,6 +51,7 @@ OpenXRFbSpatialEntityExtensionWrapper::OpenXRFbSpatialEntityExtensionWrapper() :
 	ERR_FAIL_COND_MSG(singleton != nullptr, "An OpenXRFbSpatialEntityExtensionWrapper singleton already exists.");
 
 	request_extensions[XR_FB_SPATIAL_ENTITY_EXTENSION_NAME] = &fb_spatial_entity_ext;
+	request_extensions[XR_KHR_LOCATE_SPACES_EXTENSION_NAME] = &khr_locate_spaces_ext;
 	singleton = this;
 }
 
@@ -60,10 +61,22 @@ OpenXRFbSpatialEntityExtensionWrapper::~OpenXRFbSpatialEntityExtensionWrapper()
 
 void OpenXRFbSpatialEntityExtensionWrapper::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_spatial_entity_supported"), &OpenXRFbSpatialEntityExtensionWrapper::is_spatial_entity_supported);
+	ClassDB::bind_method(D_METHOD("is_locate_spaces_supported"), &OpenXRFbSpatialEntityExtensionWrapper::is_locate_spaces_supported);
+
+	ClassDB::bind_method(D_METHOD("set_static_entity_update_interval", "frames"), &OpenXRFbSpatialEntityExtensionWrapper::set_static_entity_update_interval);
+	ClassDB::bind_method(D_METHOD("get_static_entity_update_interval"), &OpenXRFbSpatialEntityExtensionWrapper::get_static_entity_update_interval);
+	ClassDB::bind_method(D_METHOD("set_pose_update_threshold", "distance"), &OpenXRFbSpatialEntityExtensionWrapper::set_pose_update_threshold);
+	ClassDB::bind_method(D_METHOD("get_pose_update_threshold"), &OpenXRFbSpatialEntityExtensionWrapper::get_pose_update_threshold);
+	ClassDB::bind_method(D_METHOD("set_rotation_update_threshold", "angle"), &OpenXRFbSpatialEntityExtensionWrapper::set_rotation_update_threshold);
+	ClassDB::bind_method(D_METHOD("get_rotation_update_threshold"), &OpenXRFbSpatialEntityExtensionWrapper::get_rotation_update_threshold);
+
+	ClassDB::bind_method(D_METHOD("clear_component_status_cache"), &OpenXRFbSpatialEntityExtensionWrapper::clear_component_status_cache);
 }
 
 void OpenXRFbSpatialEntityExtensionWrapper::cleanup() {
 	fb_spatial_entity_ext = false;
+	khr_locate_spaces_ext = false;
+	component_status_cache.clear();
 }
 
 Dictionary OpenXRFbSpatialEntityExtensionWrapper::_get_requested_extensions() {
@@ -83,55 +96,215 @@ void OpenXRFbSpatialEntityExtensionWrapper::_on_instance_created(uint64_t instan
 			fb_spatial_entity_ext = false;
 		}
 	}
+
+	if (khr_locate_spaces_ext) {
+		bool result = initialize_khr_locate_spaces_extension((XrInstance)instance);
+		if (!result) {
+			UtilityFunctions::print("Failed to initialize khr_locate_spaces extension");
+			khr_locate_spaces_ext = false;
+		}
+	}
 }
 
 void OpenXRFbSpatialEntityExtensionWrapper::_on_instance_destroyed() {
 	cleanup();
 }
 
+void OpenXRFbSpatialEntityExtensionWrapper::_on_session_destroyed() {
+	// All spaces are destroyed with the session.
+	component_status_cache.clear();
+}
+
 void OpenXRFbSpatialEntityExtensionWrapper::_on_process() {
-	for (KeyValue<StringName, TrackedEntity> &E : tracked_entities) {
-		if (E.value.tracker.is_null()) {
-			E.value.tracker.instantiate();
-			E.value.tracker->set_tracker_name(E.key);
-			E.value.tracker->set_tracker_desc(String("Anchor ") + E.key);
-			E.value.tracker->set_tracker_type(XRServer::TRACKER_ANCHOR);
-			XRServer::get_singleton()->add_tracker(E.value.tracker);
+	if (tracked_entity_list_dirty) {
+		rebuild_tracked_entity_list();
+	}
+
+	process_frame++;
+
+	// Gather the entities due for an update this frame.
+	locate_spaces.clear();
+	locate_entities.clear();
+	for (TrackedEntity *entity : tracked_entity_list) {
+		if (entity->next_locate_frame <= process_frame) {
+			locate_spaces.push_back(entity->space);
+			locate_entities.push_back(entity);
 		}
+	}
+
+	if (locate_spaces.is_empty()) {
+		return;
+	}
+
+	const XrSpace play_space = reinterpret_cast<XrSpace>(get_openxr_api()->get_play_space());
+	const XrTime display_time = get_openxr_api()->get_predicted_display_time();
+	locate_results.resize(locate_spaces.size());
+
+	if (khr_locate_spaces_ext) {
+		// Locate all spaces in a single call.
+		XrSpacesLocateInfo locate_info = {
+			XR_TYPE_SPACES_LOCATE_INFO, // type
+			nullptr, // next
+			play_space, // baseSpace
+			display_time, // time
+			locate_spaces.size(), // spaceCount
+			locate_spaces.ptr(), // spaces
+		};
 
-		XrSpaceLocation location = {
-			XR_TYPE_SPACE_LOCATION, // type
+		XrSpaceLocations locations = {
+			XR_TYPE_SPACE_LOCATIONS, // type
 			nullptr, // next
-			0, // locationFlags
-			{
-					{ 0.0, 0.0, 0.0, 0.0 }, // orientation
-					{ 0.0, 0.0, 0.0 } // position
-			} // pose
+			locate_results.size(), // locationCount
+			locate_results.ptr(), // locations
 		};
 
-		XrResult result = xrLocateSpace(E.value.space, reinterpret_cast<XrSpace>(get_openxr_api()->get_play_space()), get_openxr_api()->get_predicted_display_time(), &location);
+		XrResult result = xrLocateSpacesKHR(SESSION, &locate_info, &locations);
 		if (XR_FAILED(result)) {
-			WARN_PRINT("OpenXR: failed to locate anchor " + E.key);
+			WARN_PRINT("OpenXR: failed to locate anchors");
 			WARN_PRINT(get_openxr_api()->get_error_string(result));
-			continue;
+			return;
+		}
+	} else {
+		for (uint32_t i = 0; i < locate_spaces.size(); i++) {
+			XrSpaceLocation location = {
+				XR_TYPE_SPACE_LOCATION, // type
+				nullptr, // next
+				0, // locationFlags
+				{
+						{ 0.0, 0.0, 0.0, 0.0 }, // orientation
+						{ 0.0, 0.0, 0.0 } // position
+				} // pose
+			};
+
+			XrResult result = xrLocateSpace(locate_spaces[i], play_space, display_time, &location);
+			if (XR_FAILED(result)) {
+				WARN_PRINT("OpenXR: failed to locate anchor " + locate_entities[i]->tracker->get_tracker_name());
+				WARN_PRINT(get_openxr_api()->get_error_string(result));
+				locate_entities[i] = nullptr;
+				continue;
+			}
+
+			locate_results[i].locationFlags = location.locationFlags;
+			locate_results[i].pose = location.pose;
+		}
+	}
+
+	for (uint32_t i = 0; i < locate_entities.size(); i++) {
+		if (locate_entities[i] != nullptr) {
+			update_tracked_entity(*locate_entities[i], locate_results[i]);
+		}
+	}
+}
+
+bool OpenXRFbSpatialEntityExtensionWrapper::locate_space(const XrSpace &p_space, Vector3 &r_position) {
+	const XrSpace play_space = reinterpret_cast<XrSpace>(get_openxr_api()->get_play_space());
+	const XrTime display_time = get_openxr_api()->get_predicted_display_time();
+
+	XrSpaceLocation location = {
+		XR_TYPE_SPACE_LOCATION, // type
+		nullptr, // next
+		0, // locationFlags
+		{
+				{ 0.0, 0.0, 0.0, 0.0 }, // orientation
+				{ 0.0, 0.0, 0.0 } // position
+		} // pose
+	};
+
+	XrResult result = xrLocateSpace(p_space, play_space, display_time, &location);
+	if (XR_FAILED(result) || !(location.locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT)) {
+		return false;
+	}
+
+	r_position = Vector3(location.pose.position.x, location.pose.position.y, location.pose.position.z);
+	return true;
+}
+
+void OpenXRFbSpatialEntityExtensionWrapper::rebuild_tracked_entity_list() {
+	tracked_entity_list.clear();
+	tracked_entity_list.reserve(tracked_entities.size());
+
+	for (KeyValue<XrUuidEXT, TrackedEntity> &E : tracked_entities) {
+		if (E.value.tracker.is_null()) {
+			const StringName name = OpenXRUtilities::uuid_to_string_name(E.key);
+			E.value.tracker.instantiate();
+			E.value.tracker->set_tracker_name(name);
+			E.value.tracker->set_tracker_desc(String("Anchor ") + name);
+			E.value.tracker->set_tracker_type(XRServer::TRACKER_ANCHOR);
+			XRServer::get_singleton()->add_tracker(E.value.tracker);
 		}
 
-		if ((location.locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT) && (location.locationFlags & XR_SPACE_LOCATION_ORIENTATION_VALID_BIT)) {
-			Transform3D transform(
-					Basis(Quaternion(location.pose.orientation.x, location.pose.orientation.y, location.pose.orientation.z, location.pose.orientation.w)),
-					Vector3(location.pose.position.x, location.pose.position.y, location.pose.position.z));
+		tracked_entity_list.push_back(&E.value);
+	}
 
-			E.value.tracker->set_pose("default", transform, Vector3(), Vector3(), XRPose::XR_TRACKING_CONFIDENCE_HIGH);
+	tracked_entity_list_dirty = false;
+}
+
+void OpenXRFbSpatialEntityExtensionWrapper::update_tracked_entity(TrackedEntity &p_entity, const XrSpaceLocationData &p_location) {
+	if ((p_location.locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT) && (p_location.locationFlags & XR_SPACE_LOCATION_ORIENTATION_VALID_BIT)) {
+		const Quaternion orientation(p_location.pose.orientation.x, p_location.pose.orientation.y, p_location.pose.orientation.z, p_location.pose.orientation.w);
+		Transform3D transform(
+				Basis(orientation),
+				Vector3(p_location.pose.position.x, p_location.pose.position.y, p_location.pose.position.z));
+
+		// Only publish poses that moved beyond the thresholds.
+		bool changed = !p_entity.published_tracked;
+		if (!changed) {
+			const Quaternion published_orientation = p_entity.published_transform.basis.get_rotation_quaternion();
+			changed = p_entity.published_transform.origin.distance_to(transform.origin) > pose_update_threshold ||
+					published_orientation.angle_to(orientation) > rotation_update_threshold;
+		}
+
+		if (changed) {
+			p_entity.tracker->set_pose("default", transform, Vector3(), Vector3(), XRPose::XR_TRACKING_CONFIDENCE_HIGH);
+			p_entity.published_transform = transform;
+			p_entity.published_tracked = true;
+			p_entity.stable_frames = 0;
 		} else {
-			Ref<XRPose> default_pose = E.value.tracker->get_pose("default");
+			p_entity.stable_frames++;
+		}
+	} else {
+		if (p_entity.published_tracked || p_entity.tracker->get_pose("default").is_null()) {
+			Ref<XRPose> default_pose = p_entity.tracker->get_pose("default");
 			if (default_pose.is_valid()) {
 				// Set the tracking confidence to none, while maintaining the existing transform.
 				default_pose->set_tracking_confidence(XRPose::XR_TRACKING_CONFIDENCE_NONE);
 			} else {
-				E.value.tracker->set_pose("default", Transform3D(), Vector3(), Vector3(), XRPose::XR_TRACKING_CONFIDENCE_NONE);
+				p_entity.tracker->set_pose("default", Transform3D(), Vector3(), Vector3(), XRPose::XR_TRACKING_CONFIDENCE_NONE);
 			}
 		}
+		p_entity.published_tracked = false;
+		p_entity.stable_frames = 0;
 	}
+
+	// Entities that have been stable for a whole interval are demoted to the
+	// static tier, and only located every static_entity_update_interval frames.
+	const uint32_t interval = p_entity.stable_frames >= uint32_t(static_entity_update_interval) ? static_entity_update_interval : 1;
+	p_entity.next_locate_frame = process_frame + interval;
+}
+
+void OpenXRFbSpatialEntityExtensionWrapper::set_static_entity_update_interval(int p_frames) {
+	ERR_FAIL_COND_MSG(p_frames < 1, "The static entity update interval must be at least 1 frame.");
+	static_entity_update_interval = p_frames;
+}
+
+int OpenXRFbSpatialEntityExtensionWrapper::get_static_entity_update_interval() const {
+	return static_entity_update_interval;
+}
+
+void OpenXRFbSpatialEntityExtensionWrapper::set_pose_update_threshold(float p_distance) {
+	pose_update_threshold = p_distance;
+}
+
+float OpenXRFbSpatialEntityExtensionWrapper::get_pose_update_threshold() const {
+	return pose_update_threshold;
+}
+
+void OpenXRFbSpatialEntityExtensionWrapper::set_rotation_update_threshold(float p_angle) {
+	rotation_update_threshold = p_angle;
+}
+
+float OpenXRFbSpatialEntityExtensionWrapper::get_rotation_update_threshold() const {
+	return rotation_update_threshold;
 }
 
 bool OpenXRFbSpatialEntityExtensionWrapper::initialize_fb_spatial_entity_extension(const XrInstance &p_instance) {
@@ -146,6 +319,12 @@ bool OpenXRFbSpatialEntityExtensionWrapper::initialize_fb_spatial_entity_extensi
 	return true;
 }
 
+bool OpenXRFbSpatialEntityExtensionWrapper::initialize_khr_locate_spaces_extension(const XrInstance &p_instance) {
+	GDEXTENSION_INIT_XR_FUNC_V(xrLocateSpacesKHR);
+
+	return true;
+}
+
 bool OpenXRFbSpatialEntityExtensionWrapper::_on_event_polled(const void *event) {
 	if (static_cast<const XrEventDataBuffer *>(event)->type == XR_TYPE_EVENT_DATA_SPATIAL_ANCHOR_CREATE_COMPLETE_FB) {
 		on_spatial_anchor_created((const XrEventDataSpatialAnchorCreateCompleteFB *)event);
@@ -207,6 +386,7 @@ void OpenXRFbSpatialEntityExtensionWrapper::on_spatial_anchor_created(const XrEv
 }
 
 bool OpenXRFbSpatialEntityExtensionWrapper::destroy_space(const XrSpace &p_space) {
+	invalidate_component_status(p_space);
 	return XR_SUCCEEDED(xrDestroySpace(p_space));
 }
 
@@ -222,11 +402,36 @@ Vector<XrSpaceComponentTypeFB> OpenXRFbSpatialEntityExtensionWrapper::get_suppor
 }
 
 bool OpenXRFbSpatialEntityExtensionWrapper::is_component_enabled(const XrSpace &space, XrSpaceComponentTypeFB type) {
+	const ComponentStatusKey key(space, type);
+	const bool *cached = component_status_cache.getptr(key);
+	if (cached) {
+		return *cached;
+	}
+
 	XrSpaceComponentStatusFB status = { XR_TYPE_SPACE_COMPONENT_STATUS_FB, nullptr };
-	xrGetSpaceComponentStatusFB(space, type, &status);
+	XrResult result = xrGetSpaceComponentStatusFB(space, type, &status);
+	if (XR_SUCCEEDED(result) && !status.changePending) {
+		component_status_cache.insert(key, status.enabled);
+	}
 	return (status.enabled && !status.changePending);
 }
 
+void OpenXRFbSpatialEntityExtensionWrapper::invalidate_component_status(const XrSpace &p_space) {
+	LocalVector<ComponentStatusKey> keys;
+	for (const KeyValue<ComponentStatusKey, bool> &E : component_status_cache) {
+		if (E.key.space == p_space) {
+			keys.push_back(E.key);
+		}
+	}
+	for (const ComponentStatusKey &key : keys) {
+		component_status_cache.erase(key);
+	}
+}
+
+void OpenXRFbSpatialEntityExtensionWrapper::clear_component_status_cache() {
+	component_status_cache.clear();
+}
+
 bool OpenXRFbSpatialEntityExtensionWrapper::set_component_enabled(const XrSpace &p_space, XrSpaceComponentTypeFB p_component, bool p_enabled, SetComponentEnabledCallback p_callback, void *p_userdata) {
 	XrSpaceComponentStatusSetInfoFB request = {
 		XR_TYPE_SPACE_COMPONENT_STATUS_SET_INFO_FB,
@@ -235,6 +440,9 @@ bool OpenXRFbSpatialEntityExtensionWrapper::set_component_enabled(const XrSpace
 		p_enabled,
 		0,
 	};
+	// The status is pending until the completion event arrives.
+	component_status_cache.erase(ComponentStatusKey(p_space, p_component));
+
 	XrAsyncRequestIdFB request_id = 0;
 	XrResult result = xrSetSpaceComponentStatusFB(p_space, &request, &request_id);
 	if (!XR_SUCCEEDED(result)) {
@@ -248,6 +456,12 @@ bool OpenXRFbSpatialEntityExtensionWrapper::set_component_enabled(const XrSpace
 }
 
 void OpenXRFbSpatialEntityExtensionWrapper::on_set_component_enabled_complete(const XrEventDataSpaceSetStatusCompleteFB *event) {
+	if (XR_SUCCEEDED(event->result)) {
+		component_status_cache.insert(ComponentStatusKey(event->space, event->componentType), (bool)event->enabled);
+	} else {
+		component_status_cache.erase(ComponentStatusKey(event->space, event->componentType));
+	}
+
 	if (!set_component_enabled_info.has(event->requestId)) {
 		WARN_PRINT("Received unexpected XR_TYPE_EVENT_DATA_SPACE_SET_STATUS_COMPLETE_FB");
 		return;
@@ -258,21 +472,33 @@ void OpenXRFbSpatialEntityExtensionWrapper::on_set_component_enabled_complete(co
 	set_component_enabled_info.erase(event->requestId);
 }
 
-void OpenXRFbSpatialEntityExtensionWrapper::track_entity(const StringName &p_name, const XrSpace &p_space) {
-	tracked_entities[p_name] = TrackedEntity(p_space);
+void OpenXRFbSpatialEntityExtensionWrapper::track_entity(const XrUuidEXT &p_uuid, const XrSpace &p_space) {
+	TrackedEntity *entity = tracked_entities.getptr(p_uuid);
+	if (entity) {
+		// Keep the existing tracker, but locate the new space right away.
+		entity->space = p_space;
+		entity->published_tracked = false;
+		entity->stable_frames = 0;
+		entity->next_locate_frame = 0;
+		return;
+	}
+
+	tracked_entities[p_uuid] = TrackedEntity(p_space);
+	tracked_entity_list_dirty = true;
 }
 
-void OpenXRFbSpatialEntityExtensionWrapper::untrack_entity(const StringName &p_name) {
-	TrackedEntity *entity = tracked_entities.getptr(p_name);
+void OpenXRFbSpatialEntityExtensionWrapper::untrack_entity(const XrUuidEXT &p_uuid) {
+	TrackedEntity *entity = tracked_entities.getptr(p_uuid);
 	if (entity) {
 		if (entity->tracker.is_valid()) {
 			XRServer::get_singleton()->remove_tracker(entity->tracker);
 			entity->tracker.unref();
 		}
-		tracked_entities.erase(p_name);
+		tracked_entities.erase(p_uuid);
+		tracked_entity_list_dirty = true;
 	}
 }
 
-bool OpenXRFbSpatialEntityExtensionWrapper::is_entity_tracked(const StringName &p_name) const {
-	return tracked_entities.has(p_name);
+bool OpenXRFbSpatialEntityExtensionWrapper::is_entity_tracked(const XrUuidEXT &p_uuid) const {
+	return tracked_entities.has(p_uuid);
 }
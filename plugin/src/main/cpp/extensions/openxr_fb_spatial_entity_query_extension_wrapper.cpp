@@ -108,18 +108,18 @@ bool OpenXRFbSpatialEntityQueryExtensionWrapper::_on_event_polled(const void *ev
 	return false;
 }
 
-bool OpenXRFbSpatialEntityQueryExtensionWrapper::query_spatial_entities(const XrSpaceQueryInfoBaseHeaderFB *p_info, QueryCompleteCallback p_callback, void *p_userdata) {
+bool OpenXRFbSpatialEntityQueryExtensionWrapper::query_spatial_entities(const XrSpaceQueryInfoBaseHeaderFB *p_info, QueryCompleteCallback p_callback, void *p_userdata, QueryResultsCallback p_results_callback) {
 	XrAsyncRequestIdFB request_id = 0;
 
 	const XrResult result = xrQuerySpacesFB(SESSION, p_info, &request_id);
 	if (!XR_SUCCEEDED(result)) {
 		WARN_PRINT("xrQuerySpacesFB failed!");
 		WARN_PRINT(get_openxr_api()->get_error_string(result));
-		p_callback({}, p_userdata);
+		p_callback(result, {}, p_userdata);
 		return false;
 	}
 
-	queries[request_id] = QueryInfo(p_callback, p_userdata);
+	queries[request_id] = QueryInfo(p_callback, p_results_callback, p_userdata);
 	return true;
 }
 
@@ -146,17 +146,24 @@ void OpenXRFbSpatialEntityQueryExtensionWrapper::on_space_query_results(const Xr
 
 	QueryInfo *query = queries.getptr(event->requestId);
 
-	query->results.resize(queryResults.resultCountOutput);
+	// Each event delivers a new page of results, so append it to the earlier ones.
+	const uint32_t page_start = query->results.size();
+	query->results.resize(page_start + queryResults.resultCountOutput);
 	queryResults.resultCapacityInput = queryResults.resultCountOutput;
-	queryResults.results = query->results.ptrw();
+	queryResults.results = query->results.ptrw() + page_start;
 
 	result = xrRetrieveSpaceQueryResultsFB(SESSION, event->requestId, &queryResults);
 	if (!XR_SUCCEEDED(result)) {
-		query->results.clear();
+		query->results.resize(page_start);
 		WARN_PRINT("xrRetrieveSpaceQueryResultsFB failed to get results!");
 		WARN_PRINT(get_openxr_api()->get_error_string(result));
 		return;
 	}
+
+	query->results.resize(page_start + queryResults.resultCountOutput);
+	if (query->results_callback && queryResults.resultCountOutput > 0) {
+		query->results_callback(query->results.ptr() + page_start, queryResults.resultCountOutput, query->userdata);
+	}
 }
 
 void OpenXRFbSpatialEntityQueryExtensionWrapper::on_space_query_complete(const XrEventDataSpaceQueryCompleteFB *event) {
@@ -165,6 +172,6 @@ void OpenXRFbSpatialEntityQueryExtensionWrapper::on_space_query_complete(const X
 		return;
 	}
 	QueryInfo *query = queries.getptr(event->requestId);
-	query->callback(query->results, query->userdata);
+	query->callback(event->result, query->results, query->userdata);
 	queries.erase(event->requestId);
 }
@@ -36,11 +36,120 @@
 
 using namespace godot;
 
-// Calculate the average of two floating point values
-static inline constexpr float average(float a, float b) {
-	return (a + b) * 0.5f;
+// HTC weights are mapped from a single source buffer, holding the eye
+// weights followed by the lip weights.
+static constexpr uint8_t HTC_EYE_OFFSET = 0;
+static constexpr uint8_t HTC_LIP_OFFSET = HTC_EYE_OFFSET + XR_FACIAL_EXPRESSION_EYE_COUNT_HTC;
+static constexpr int HTC_SOURCE_COUNT = HTC_LIP_OFFSET + XR_FACIAL_EXPRESSION_LIP_COUNT_HTC;
+
+// Confidence regions, updated independently from each facial tracker.
+static constexpr uint8_t HTC_REGION_EYE = 0;
+static constexpr uint8_t HTC_REGION_LIP = 1;
+
+static constexpr uint8_t eye(XrEyeExpressionHTC p_expression) {
+	return uint8_t(HTC_EYE_OFFSET + p_expression);
 }
 
+static constexpr uint8_t lip(XrLipExpressionHTC p_expression) {
+	return uint8_t(HTC_LIP_OFFSET + p_expression);
+}
+
+static constexpr uint8_t get_facial_expression_region(uint8_t p_source) {
+	return p_source < HTC_LIP_OFFSET ? HTC_REGION_EYE : HTC_REGION_LIP;
+}
+
+// Sparse HTC to Godot blend shape remap matrix, as a list of non-zero terms.
+// Blended shapes are expanded into their source expressions, and shapes not
+// measured by XR_HTC_facial_tracking have no terms (always zero).
+static constexpr FaceExpressionMapper::Term facial_remap_terms[] = {
+	// Base Shapes
+	{ XRFaceTracker::FT_EYE_LOOK_OUT_RIGHT, eye(XR_EYE_EXPRESSION_RIGHT_OUT_HTC), 1.0f },
+	{ XRFaceTracker::FT_EYE_LOOK_IN_RIGHT, eye(XR_EYE_EXPRESSION_RIGHT_IN_HTC), 1.0f },
+	{ XRFaceTracker::FT_EYE_LOOK_UP_RIGHT, eye(XR_EYE_EXPRESSION_RIGHT_UP_HTC), 1.0f },
+	{ XRFaceTracker::FT_EYE_LOOK_DOWN_RIGHT, eye(XR_EYE_EXPRESSION_RIGHT_DOWN_HTC), 1.0f },
+	{ XRFaceTracker::FT_EYE_LOOK_OUT_LEFT, eye(XR_EYE_EXPRESSION_LEFT_OUT_HTC), 1.0f },
+	{ XRFaceTracker::FT_EYE_LOOK_IN_LEFT, eye(XR_EYE_EXPRESSION_LEFT_IN_HTC), 1.0f },
+	{ XRFaceTracker::FT_EYE_LOOK_UP_LEFT, eye(XR_EYE_EXPRESSION_LEFT_UP_HTC), 1.0f },
+	{ XRFaceTracker::FT_EYE_LOOK_DOWN_LEFT, eye(XR_EYE_EXPRESSION_LEFT_DOWN_HTC), 1.0f },
+	{ XRFaceTracker::FT_EYE_CLOSED_RIGHT, eye(XR_EYE_EXPRESSION_RIGHT_BLINK_HTC), 1.0f },
+	{ XRFaceTracker::FT_EYE_CLOSED_LEFT, eye(XR_EYE_EXPRESSION_LEFT_BLINK_HTC), 1.0f },
+	{ XRFaceTracker::FT_EYE_SQUINT_RIGHT, eye(XR_EYE_EXPRESSION_RIGHT_SQUEEZE_HTC), 1.0f },
+	{ XRFaceTracker::FT_EYE_SQUINT_LEFT, eye(XR_EYE_EXPRESSION_LEFT_SQUEEZE_HTC), 1.0f },
+	{ XRFaceTracker::FT_EYE_WIDE_RIGHT, eye(XR_EYE_EXPRESSION_RIGHT_WIDE_HTC), 1.0f },
+	{ XRFaceTracker::FT_EYE_WIDE_LEFT, eye(XR_EYE_EXPRESSION_LEFT_WIDE_HTC), 1.0f },
+	{ XRFaceTracker::FT_CHEEK_PUFF_RIGHT, lip(XR_LIP_EXPRESSION_CHEEK_PUFF_RIGHT_HTC), 1.0f },
+	{ XRFaceTracker::FT_CHEEK_PUFF_LEFT, lip(XR_LIP_EXPRESSION_CHEEK_PUFF_LEFT_HTC), 1.0f },
+	{ XRFaceTracker::FT_CHEEK_SUCK_RIGHT, lip(XR_LIP_EXPRESSION_CHEEK_SUCK_HTC), 1.0f },
+	{ XRFaceTracker::FT_CHEEK_SUCK_LEFT, lip(XR_LIP_EXPRESSION_CHEEK_SUCK_HTC), 1.0f },
+	{ XRFaceTracker::FT_JAW_OPEN, lip(XR_LIP_EXPRESSION_JAW_OPEN_HTC), 1.0f },
+	{ XRFaceTracker::FT_MOUTH_CLOSED, lip(XR_LIP_EXPRESSION_MOUTH_APE_SHAPE_HTC), 1.0f },
+	{ XRFaceTracker::FT_JAW_RIGHT, lip(XR_LIP_EXPRESSION_JAW_RIGHT_HTC), 1.0f },
+	{ XRFaceTracker::FT_JAW_LEFT, lip(XR_LIP_EXPRESSION_JAW_LEFT_HTC), 1.0f },
+	{ XRFaceTracker::FT_JAW_FORWARD, lip(XR_LIP_EXPRESSION_JAW_FORWARD_HTC), 1.0f },
+	{ XRFaceTracker::FT_LIP_SUCK_UPPER_RIGHT, lip(XR_LIP_EXPRESSION_MOUTH_UPPER_INSIDE_HTC), 1.0f },
+	{ XRFaceTracker::FT_LIP_SUCK_UPPER_LEFT, lip(XR_LIP_EXPRESSION_MOUTH_UPPER_INSIDE_HTC), 1.0f },
+	{ XRFaceTracker::FT_LIP_SUCK_LOWER_RIGHT, lip(XR_LIP_EXPRESSION_MOUTH_LOWER_INSIDE_HTC), 1.0f },
+	{ XRFaceTracker::FT_LIP_SUCK_LOWER_LEFT, lip(XR_LIP_EXPRESSION_MOUTH_LOWER_INSIDE_HTC), 1.0f },
+	{ XRFaceTracker::FT_LIP_PUCKER_UPPER_RIGHT, lip(XR_LIP_EXPRESSION_MOUTH_POUT_HTC), 1.0f },
+	{ XRFaceTracker::FT_LIP_PUCKER_UPPER_LEFT, lip(XR_LIP_EXPRESSION_MOUTH_POUT_HTC), 1.0f },
+	{ XRFaceTracker::FT_LIP_PUCKER_LOWER_RIGHT, lip(XR_LIP_EXPRESSION_MOUTH_POUT_HTC), 1.0f },
+	{ XRFaceTracker::FT_LIP_PUCKER_LOWER_LEFT, lip(XR_LIP_EXPRESSION_MOUTH_POUT_HTC), 1.0f },
+	{ XRFaceTracker::FT_MOUTH_UPPER_UP_RIGHT, lip(XR_LIP_EXPRESSION_MOUTH_UPPER_UPRIGHT_HTC), 1.0f },
+	{ XRFaceTracker::FT_MOUTH_UPPER_UP_LEFT, lip(XR_LIP_EXPRESSION_MOUTH_UPPER_UPLEFT_HTC), 1.0f },
+	{ XRFaceTracker::FT_MOUTH_LOWER_DOWN_RIGHT, lip(XR_LIP_EXPRESSION_MOUTH_LOWER_DOWNRIGHT_HTC), 1.0f },
+	{ XRFaceTracker::FT_MOUTH_LOWER_DOWN_LEFT, lip(XR_LIP_EXPRESSION_MOUTH_LOWER_DOWNLEFT_HTC), 1.0f },
+	{ XRFaceTracker::FT_MOUTH_UPPER_RIGHT, lip(XR_LIP_EXPRESSION_MOUTH_UPPER_RIGHT_HTC), 1.0f },
+	{ XRFaceTracker::FT_MOUTH_UPPER_LEFT, lip(XR_LIP_EXPRESSION_MOUTH_UPPER_LEFT_HTC), 1.0f },
+	{ XRFaceTracker::FT_MOUTH_LOWER_RIGHT, lip(XR_LIP_EXPRESSION_MOUTH_LOWER_RIGHT_HTC), 1.0f },
+	{ XRFaceTracker::FT_MOUTH_LOWER_LEFT, lip(XR_LIP_EXPRESSION_MOUTH_LOWER_LEFT_HTC), 1.0f },
+	{ XRFaceTracker::FT_MOUTH_CORNER_PULL_RIGHT, lip(XR_LIP_EXPRESSION_MOUTH_SMILE_RIGHT_HTC), 1.0f },
+	{ XRFaceTracker::FT_MOUTH_CORNER_PULL_LEFT, lip(XR_LIP_EXPRESSION_MOUTH_SMILE_LEFT_HTC), 1.0f },
+	{ XRFaceTracker::FT_MOUTH_FROWN_RIGHT, lip(XR_LIP_EXPRESSION_MOUTH_SAD_RIGHT_HTC), 1.0f },
+	{ XRFaceTracker::FT_MOUTH_FROWN_LEFT, lip(XR_LIP_EXPRESSION_MOUTH_SAD_LEFT_HTC), 1.0f },
+	{ XRFaceTracker::FT_TONGUE_OUT, lip(XR_LIP_EXPRESSION_TONGUE_LONGSTEP2_HTC), 1.0f },
+	{ XRFaceTracker::FT_TONGUE_UP, lip(XR_LIP_EXPRESSION_TONGUE_UP_HTC), 1.0f },
+	{ XRFaceTracker::FT_TONGUE_DOWN, lip(XR_LIP_EXPRESSION_TONGUE_DOWN_HTC), 1.0f },
+	{ XRFaceTracker::FT_TONGUE_RIGHT, lip(XR_LIP_EXPRESSION_TONGUE_RIGHT_HTC), 1.0f },
+	{ XRFaceTracker::FT_TONGUE_LEFT, lip(XR_LIP_EXPRESSION_TONGUE_LEFT_HTC), 1.0f },
+	{ XRFaceTracker::FT_TONGUE_ROLL, lip(XR_LIP_EXPRESSION_TONGUE_ROLL_HTC), 1.0f },
+
+	// Blended Shapes
+	{ XRFaceTracker::FT_EYE_CLOSED, eye(XR_EYE_EXPRESSION_RIGHT_BLINK_HTC), 0.5f },
+	{ XRFaceTracker::FT_EYE_CLOSED, eye(XR_EYE_EXPRESSION_LEFT_BLINK_HTC), 0.5f },
+	{ XRFaceTracker::FT_EYE_WIDE, eye(XR_EYE_EXPRESSION_RIGHT_WIDE_HTC), 0.5f },
+	{ XRFaceTracker::FT_EYE_WIDE, eye(XR_EYE_EXPRESSION_LEFT_WIDE_HTC), 0.5f },
+	{ XRFaceTracker::FT_EYE_SQUINT, eye(XR_EYE_EXPRESSION_RIGHT_SQUEEZE_HTC), 0.5f },
+	{ XRFaceTracker::FT_EYE_SQUINT, eye(XR_EYE_EXPRESSION_LEFT_SQUEEZE_HTC), 0.5f },
+	{ XRFaceTracker::FT_CHEEK_PUFF, lip(XR_LIP_EXPRESSION_CHEEK_PUFF_RIGHT_HTC), 0.5f },
+	{ XRFaceTracker::FT_CHEEK_PUFF, lip(XR_LIP_EXPRESSION_CHEEK_PUFF_LEFT_HTC), 0.5f },
+	{ XRFaceTracker::FT_CHEEK_SUCK, lip(XR_LIP_EXPRESSION_CHEEK_SUCK_HTC), 1.0f },
+	{ XRFaceTracker::FT_LIP_SUCK_UPPER, lip(XR_LIP_EXPRESSION_MOUTH_UPPER_INSIDE_HTC), 1.0f },
+	{ XRFaceTracker::FT_LIP_SUCK_LOWER, lip(XR_LIP_EXPRESSION_MOUTH_LOWER_INSIDE_HTC), 1.0f },
+	{ XRFaceTracker::FT_LIP_PUCKER_UPPER, lip(XR_LIP_EXPRESSION_MOUTH_POUT_HTC), 1.0f },
+	{ XRFaceTracker::FT_LIP_PUCKER_LOWER, lip(XR_LIP_EXPRESSION_MOUTH_POUT_HTC), 1.0f },
+	{ XRFaceTracker::FT_LIP_PUCKER, lip(XR_LIP_EXPRESSION_MOUTH_POUT_HTC), 1.0f },
+	{ XRFaceTracker::FT_MOUTH_UPPER_UP, lip(XR_LIP_EXPRESSION_MOUTH_UPPER_UPRIGHT_HTC), 0.5f },
+	{ XRFaceTracker::FT_MOUTH_UPPER_UP, lip(XR_LIP_EXPRESSION_MOUTH_UPPER_UPLEFT_HTC), 0.5f },
+	{ XRFaceTracker::FT_MOUTH_LOWER_DOWN, lip(XR_LIP_EXPRESSION_MOUTH_LOWER_DOWNRIGHT_HTC), 0.5f },
+	{ XRFaceTracker::FT_MOUTH_LOWER_DOWN, lip(XR_LIP_EXPRESSION_MOUTH_LOWER_DOWNLEFT_HTC), 0.5f },
+	{ XRFaceTracker::FT_MOUTH_OPEN, lip(XR_LIP_EXPRESSION_MOUTH_UPPER_UPRIGHT_HTC), 0.25f },
+	{ XRFaceTracker::FT_MOUTH_OPEN, lip(XR_LIP_EXPRESSION_MOUTH_UPPER_UPLEFT_HTC), 0.25f },
+	{ XRFaceTracker::FT_MOUTH_OPEN, lip(XR_LIP_EXPRESSION_MOUTH_LOWER_DOWNRIGHT_HTC), 0.25f },
+	{ XRFaceTracker::FT_MOUTH_OPEN, lip(XR_LIP_EXPRESSION_MOUTH_LOWER_DOWNLEFT_HTC), 0.25f },
+	{ XRFaceTracker::FT_MOUTH_SMILE_RIGHT, lip(XR_LIP_EXPRESSION_MOUTH_SMILE_RIGHT_HTC), 1.0f },
+	{ XRFaceTracker::FT_MOUTH_SMILE_LEFT, lip(XR_LIP_EXPRESSION_MOUTH_SMILE_LEFT_HTC), 1.0f },
+	{ XRFaceTracker::FT_MOUTH_SMILE, lip(XR_LIP_EXPRESSION_MOUTH_SMILE_RIGHT_HTC), 0.5f },
+	{ XRFaceTracker::FT_MOUTH_SMILE, lip(XR_LIP_EXPRESSION_MOUTH_SMILE_LEFT_HTC), 0.5f },
+	{ XRFaceTracker::FT_MOUTH_SAD_RIGHT, lip(XR_LIP_EXPRESSION_MOUTH_SAD_RIGHT_HTC), 1.0f },
+	{ XRFaceTracker::FT_MOUTH_SAD_LEFT, lip(XR_LIP_EXPRESSION_MOUTH_SAD_LEFT_HTC), 1.0f },
+	{ XRFaceTracker::FT_MOUTH_SAD, lip(XR_LIP_EXPRESSION_MOUTH_SAD_RIGHT_HTC), 0.5f },
+	{ XRFaceTracker::FT_MOUTH_SAD, lip(XR_LIP_EXPRESSION_MOUTH_SAD_LEFT_HTC), 0.5f },
+};
+
+static_assert(FaceExpressionMapper::terms_fit(facial_remap_terms, get_facial_expression_region), "Too many facial remap terms for a single blend shape.");
+
+static constexpr FaceExpressionMapper::Mapping facial_remap_mapping = FaceExpressionMapper::build_mapping(facial_remap_terms, get_facial_expression_region);
+
 OpenXRHtcFacialTrackingExtensionWrapper *OpenXRHtcFacialTrackingExtensionWrapper::singleton = nullptr;
 
 OpenXRHtcFacialTrackingExtensionWrapper *OpenXRHtcFacialTrackingExtensionWrapper::get_singleton() {
@@ -175,6 +284,9 @@ void OpenXRHtcFacialTrackingExtensionWrapper::_on_session_destroyed() {
 		}
 		xr_face_tracker_registered = false;
 	}
+
+	// Forget the held weights.
+	face_mapper.reset();
 }
 
 void OpenXRHtcFacialTrackingExtensionWrapper::_on_process() {
@@ -189,8 +301,8 @@ void OpenXRHtcFacialTrackingExtensionWrapper::_on_process() {
 		return;
 	}
 
-	float eyeWeights[XR_FACIAL_EXPRESSION_EYE_COUNT_HTC] = {};
-	float lipWeights[XR_FACIAL_EXPRESSION_LIP_COUNT_HTC] = {};
+	float htc_weights[HTC_SOURCE_COUNT] = {};
+	bool region_valid[FaceExpressionMapper::MAX_REGIONS] = {};
 
 	// Read the eye weights if supported
 	if (facial_tracking_eye) {
@@ -201,13 +313,15 @@ void OpenXRHtcFacialTrackingExtensionWrapper::_on_process() {
 			XR_FALSE, // isActive
 			display_time, // sampleTime
 			XR_FACIAL_EXPRESSION_EYE_COUNT_HTC,
-			eyeWeights
+			htc_weights + HTC_EYE_OFFSET
 		};
 
 		// Read the weights
 		XrResult result = xrGetFacialExpressionsHTC(facial_tracking_eye, &expression_eye);
 		if (XR_FAILED(result)) {
 			UtilityFunctions::print("Failed to get facial expression eye weights: ", result);
+		} else {
+			region_valid[HTC_REGION_EYE] = expression_eye.isActive;
 		}
 	}
 
@@ -220,171 +334,22 @@ void OpenXRHtcFacialTrackingExtensionWrapper::_on_process() {
 			XR_FALSE, // isActive
 			display_time, // sampleTime
 			XR_FACIAL_EXPRESSION_LIP_COUNT_HTC,
-			lipWeights
+			htc_weights + HTC_LIP_OFFSET
 		};
 
 		// Read the weights
 		XrResult result = xrGetFacialExpressionsHTC(facial_tracking_lip, &expression_lip);
 		if (XR_FAILED(result)) {
 			UtilityFunctions::print("Failed to get facial expression lip weights: ", result);
+		} else {
+			region_valid[HTC_REGION_LIP] = expression_lip.isActive;
 		}
 	}
 
-	// Map HTC weights to Godot weights.
-	float xr_weights[XRFaceTracker::FT_MAX] = {};
-
-	// Base Shapes
-	xr_weights[XRFaceTracker::FT_EYE_LOOK_OUT_RIGHT] = eyeWeights[XR_EYE_EXPRESSION_RIGHT_OUT_HTC];
-	xr_weights[XRFaceTracker::FT_EYE_LOOK_IN_RIGHT] = eyeWeights[XR_EYE_EXPRESSION_RIGHT_IN_HTC];
-	xr_weights[XRFaceTracker::FT_EYE_LOOK_UP_RIGHT] = eyeWeights[XR_EYE_EXPRESSION_RIGHT_UP_HTC];
-	xr_weights[XRFaceTracker::FT_EYE_LOOK_DOWN_RIGHT] = eyeWeights[XR_EYE_EXPRESSION_RIGHT_DOWN_HTC];
-	xr_weights[XRFaceTracker::FT_EYE_LOOK_OUT_LEFT] = eyeWeights[XR_EYE_EXPRESSION_LEFT_OUT_HTC];
-	xr_weights[XRFaceTracker::FT_EYE_LOOK_IN_LEFT] = eyeWeights[XR_EYE_EXPRESSION_LEFT_IN_HTC];
-	xr_weights[XRFaceTracker::FT_EYE_LOOK_UP_LEFT] = eyeWeights[XR_EYE_EXPRESSION_LEFT_UP_HTC];
-	xr_weights[XRFaceTracker::FT_EYE_LOOK_DOWN_LEFT] = eyeWeights[XR_EYE_EXPRESSION_LEFT_DOWN_HTC];
-	xr_weights[XRFaceTracker::FT_EYE_CLOSED_RIGHT] = eyeWeights[XR_EYE_EXPRESSION_RIGHT_BLINK_HTC];
-	xr_weights[XRFaceTracker::FT_EYE_CLOSED_LEFT] = eyeWeights[XR_EYE_EXPRESSION_LEFT_BLINK_HTC];
-	xr_weights[XRFaceTracker::FT_EYE_SQUINT_RIGHT] = eyeWeights[XR_EYE_EXPRESSION_RIGHT_SQUEEZE_HTC];
-	xr_weights[XRFaceTracker::FT_EYE_SQUINT_LEFT] = eyeWeights[XR_EYE_EXPRESSION_LEFT_SQUEEZE_HTC];
-	xr_weights[XRFaceTracker::FT_EYE_WIDE_RIGHT] = eyeWeights[XR_EYE_EXPRESSION_RIGHT_WIDE_HTC];
-	xr_weights[XRFaceTracker::FT_EYE_WIDE_LEFT] = eyeWeights[XR_EYE_EXPRESSION_LEFT_WIDE_HTC];
-	xr_weights[XRFaceTracker::FT_EYE_DILATION_RIGHT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_EYE_DILATION_LEFT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_EYE_CONSTRICT_RIGHT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_EYE_CONSTRICT_LEFT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_BROW_PINCH_RIGHT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_BROW_PINCH_LEFT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_BROW_LOWERER_RIGHT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_BROW_LOWERER_LEFT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_BROW_INNER_UP_RIGHT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_BROW_INNER_UP_LEFT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_BROW_OUTER_UP_RIGHT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_BROW_OUTER_UP_LEFT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_NOSE_SNEER_RIGHT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_NOSE_SNEER_LEFT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_NASAL_DILATION_RIGHT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_NASAL_DILATION_LEFT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_NASAL_CONSTRICT_RIGHT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_NASAL_CONSTRICT_LEFT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_CHEEK_SQUINT_RIGHT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_CHEEK_SQUINT_LEFT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_CHEEK_PUFF_RIGHT] = lipWeights[XR_LIP_EXPRESSION_CHEEK_PUFF_RIGHT_HTC];
-	xr_weights[XRFaceTracker::FT_CHEEK_PUFF_LEFT] = lipWeights[XR_LIP_EXPRESSION_CHEEK_PUFF_LEFT_HTC];
-	xr_weights[XRFaceTracker::FT_CHEEK_SUCK_RIGHT] = lipWeights[XR_LIP_EXPRESSION_CHEEK_SUCK_HTC];
-	xr_weights[XRFaceTracker::FT_CHEEK_SUCK_LEFT] = lipWeights[XR_LIP_EXPRESSION_CHEEK_SUCK_HTC];
-	xr_weights[XRFaceTracker::FT_JAW_OPEN] = lipWeights[XR_LIP_EXPRESSION_JAW_OPEN_HTC];
-	xr_weights[XRFaceTracker::FT_MOUTH_CLOSED] = lipWeights[XR_LIP_EXPRESSION_MOUTH_APE_SHAPE_HTC];
-	xr_weights[XRFaceTracker::FT_JAW_RIGHT] = lipWeights[XR_LIP_EXPRESSION_JAW_RIGHT_HTC];
-	xr_weights[XRFaceTracker::FT_JAW_LEFT] = lipWeights[XR_LIP_EXPRESSION_JAW_LEFT_HTC];
-	xr_weights[XRFaceTracker::FT_JAW_FORWARD] = lipWeights[XR_LIP_EXPRESSION_JAW_FORWARD_HTC];
-	xr_weights[XRFaceTracker::FT_JAW_BACKWARD] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_JAW_CLENCH] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_JAW_MANDIBLE_RAISE] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_LIP_SUCK_UPPER_RIGHT] = lipWeights[XR_LIP_EXPRESSION_MOUTH_UPPER_INSIDE_HTC];
-	xr_weights[XRFaceTracker::FT_LIP_SUCK_UPPER_LEFT] = lipWeights[XR_LIP_EXPRESSION_MOUTH_UPPER_INSIDE_HTC];
-	xr_weights[XRFaceTracker::FT_LIP_SUCK_LOWER_RIGHT] = lipWeights[XR_LIP_EXPRESSION_MOUTH_LOWER_INSIDE_HTC];
-	xr_weights[XRFaceTracker::FT_LIP_SUCK_LOWER_LEFT] = lipWeights[XR_LIP_EXPRESSION_MOUTH_LOWER_INSIDE_HTC];
-	xr_weights[XRFaceTracker::FT_LIP_SUCK_CORNER_RIGHT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_LIP_SUCK_CORNER_LEFT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_LIP_FUNNEL_UPPER_RIGHT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_LIP_FUNNEL_UPPER_LEFT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_LIP_FUNNEL_LOWER_RIGHT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_LIP_FUNNEL_LOWER_LEFT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_LIP_PUCKER_UPPER_RIGHT] = lipWeights[XR_LIP_EXPRESSION_MOUTH_POUT_HTC];
-	xr_weights[XRFaceTracker::FT_LIP_PUCKER_UPPER_LEFT] = lipWeights[XR_LIP_EXPRESSION_MOUTH_POUT_HTC];
-	xr_weights[XRFaceTracker::FT_LIP_PUCKER_LOWER_RIGHT] = lipWeights[XR_LIP_EXPRESSION_MOUTH_POUT_HTC];
-	xr_weights[XRFaceTracker::FT_LIP_PUCKER_LOWER_LEFT] = lipWeights[XR_LIP_EXPRESSION_MOUTH_POUT_HTC];
-	xr_weights[XRFaceTracker::FT_MOUTH_UPPER_UP_RIGHT] = lipWeights[XR_LIP_EXPRESSION_MOUTH_UPPER_UPRIGHT_HTC];
-	xr_weights[XRFaceTracker::FT_MOUTH_UPPER_UP_LEFT] = lipWeights[XR_LIP_EXPRESSION_MOUTH_UPPER_UPLEFT_HTC];
-	xr_weights[XRFaceTracker::FT_MOUTH_LOWER_DOWN_RIGHT] = lipWeights[XR_LIP_EXPRESSION_MOUTH_LOWER_DOWNRIGHT_HTC];
-	xr_weights[XRFaceTracker::FT_MOUTH_LOWER_DOWN_LEFT] = lipWeights[XR_LIP_EXPRESSION_MOUTH_LOWER_DOWNLEFT_HTC];
-	xr_weights[XRFaceTracker::FT_MOUTH_UPPER_DEEPEN_RIGHT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_UPPER_DEEPEN_LEFT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_UPPER_RIGHT] = lipWeights[XR_LIP_EXPRESSION_MOUTH_UPPER_RIGHT_HTC];
-	xr_weights[XRFaceTracker::FT_MOUTH_UPPER_LEFT] = lipWeights[XR_LIP_EXPRESSION_MOUTH_UPPER_LEFT_HTC];
-	xr_weights[XRFaceTracker::FT_MOUTH_LOWER_RIGHT] = lipWeights[XR_LIP_EXPRESSION_MOUTH_LOWER_RIGHT_HTC];
-	xr_weights[XRFaceTracker::FT_MOUTH_LOWER_LEFT] = lipWeights[XR_LIP_EXPRESSION_MOUTH_LOWER_LEFT_HTC];
-	xr_weights[XRFaceTracker::FT_MOUTH_CORNER_PULL_RIGHT] = lipWeights[XR_LIP_EXPRESSION_MOUTH_SMILE_RIGHT_HTC];
-	xr_weights[XRFaceTracker::FT_MOUTH_CORNER_PULL_LEFT] = lipWeights[XR_LIP_EXPRESSION_MOUTH_SMILE_LEFT_HTC];
-	xr_weights[XRFaceTracker::FT_MOUTH_CORNER_SLANT_RIGHT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_CORNER_SLANT_LEFT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_FROWN_RIGHT] = lipWeights[XR_LIP_EXPRESSION_MOUTH_SAD_RIGHT_HTC];
-	xr_weights[XRFaceTracker::FT_MOUTH_FROWN_LEFT] = lipWeights[XR_LIP_EXPRESSION_MOUTH_SAD_LEFT_HTC];
-	xr_weights[XRFaceTracker::FT_MOUTH_STRETCH_RIGHT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_STRETCH_LEFT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_DIMPLE_RIGHT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_DIMPLE_LEFT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_RAISER_UPPER] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_RAISER_LOWER] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_PRESS_RIGHT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_PRESS_LEFT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_TIGHTENER_RIGHT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_TIGHTENER_LEFT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_TONGUE_OUT] = lipWeights[XR_LIP_EXPRESSION_TONGUE_LONGSTEP2_HTC];
-	xr_weights[XRFaceTracker::FT_TONGUE_UP] = lipWeights[XR_LIP_EXPRESSION_TONGUE_UP_HTC];
-	xr_weights[XRFaceTracker::FT_TONGUE_DOWN] = lipWeights[XR_LIP_EXPRESSION_TONGUE_DOWN_HTC];
-	xr_weights[XRFaceTracker::FT_TONGUE_RIGHT] = lipWeights[XR_LIP_EXPRESSION_TONGUE_RIGHT_HTC];
-	xr_weights[XRFaceTracker::FT_TONGUE_LEFT] = lipWeights[XR_LIP_EXPRESSION_TONGUE_LEFT_HTC];
-	xr_weights[XRFaceTracker::FT_TONGUE_ROLL] = lipWeights[XR_LIP_EXPRESSION_TONGUE_ROLL_HTC];
-	xr_weights[XRFaceTracker::FT_TONGUE_BLEND_DOWN] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_TONGUE_CURL_UP] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_TONGUE_SQUISH] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_TONGUE_FLAT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_TONGUE_TWIST_RIGHT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_TONGUE_TWIST_LEFT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_SOFT_PALATE_CLOSE] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_THROAT_SWALLOW] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_NECK_FLEX_RIGHT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_NECK_FLEX_LEFT] = 0.0f; // Not measured by XR_htc_facial_tracking
-
-	// Blended Shapes
-	xr_weights[XRFaceTracker::FT_EYE_CLOSED] = average(xr_weights[XRFaceTracker::FT_EYE_CLOSED_RIGHT], xr_weights[XRFaceTracker::FT_EYE_CLOSED_LEFT]);
-	xr_weights[XRFaceTracker::FT_EYE_WIDE] = average(xr_weights[XRFaceTracker::FT_EYE_WIDE_RIGHT], xr_weights[XRFaceTracker::FT_EYE_WIDE_LEFT]);
-	xr_weights[XRFaceTracker::FT_EYE_SQUINT] = average(xr_weights[XRFaceTracker::FT_EYE_SQUINT_RIGHT], xr_weights[XRFaceTracker::FT_EYE_SQUINT_LEFT]);
-	xr_weights[XRFaceTracker::FT_EYE_DILATION] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_EYE_CONSTRICT] = 0.0f; // Not measured by XR_fb_face_tracking
-	xr_weights[XRFaceTracker::FT_BROW_DOWN_RIGHT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_BROW_DOWN_LEFT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_BROW_DOWN] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_BROW_UP_RIGHT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_BROW_UP_LEFT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_BROW_UP] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_NOSE_SNEER] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_NASAL_DILATION] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_NASAL_CONSTRICT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_CHEEK_PUFF] = average(xr_weights[XRFaceTracker::FT_CHEEK_PUFF_RIGHT], xr_weights[XRFaceTracker::FT_CHEEK_PUFF_LEFT]);
-	xr_weights[XRFaceTracker::FT_CHEEK_SUCK] = lipWeights[XR_LIP_EXPRESSION_CHEEK_SUCK_HTC];
-	xr_weights[XRFaceTracker::FT_CHEEK_SQUINT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_LIP_SUCK_UPPER] = lipWeights[XR_LIP_EXPRESSION_MOUTH_UPPER_INSIDE_HTC];
-	xr_weights[XRFaceTracker::FT_LIP_SUCK_LOWER] = lipWeights[XR_LIP_EXPRESSION_MOUTH_LOWER_INSIDE_HTC];
-	xr_weights[XRFaceTracker::FT_LIP_SUCK] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_LIP_FUNNEL_UPPER] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_LIP_FUNNEL_LOWER] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_LIP_FUNNEL] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_LIP_PUCKER_UPPER] = lipWeights[XR_LIP_EXPRESSION_MOUTH_POUT_HTC];
-	xr_weights[XRFaceTracker::FT_LIP_PUCKER_LOWER] = lipWeights[XR_LIP_EXPRESSION_MOUTH_POUT_HTC];
-	xr_weights[XRFaceTracker::FT_LIP_PUCKER] = lipWeights[XR_LIP_EXPRESSION_MOUTH_POUT_HTC];
-	xr_weights[XRFaceTracker::FT_MOUTH_UPPER_UP] = average(xr_weights[XRFaceTracker::FT_MOUTH_UPPER_UP_RIGHT], xr_weights[XRFaceTracker::FT_MOUTH_UPPER_UP_LEFT]);
-	xr_weights[XRFaceTracker::FT_MOUTH_LOWER_DOWN] = average(xr_weights[XRFaceTracker::FT_MOUTH_LOWER_DOWN_RIGHT], xr_weights[XRFaceTracker::FT_MOUTH_LOWER_DOWN_LEFT]);
-	xr_weights[XRFaceTracker::FT_MOUTH_OPEN] = average(xr_weights[XRFaceTracker::FT_MOUTH_UPPER_UP], xr_weights[XRFaceTracker::FT_MOUTH_LOWER_DOWN]);
-	xr_weights[XRFaceTracker::FT_MOUTH_RIGHT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_LEFT] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_SMILE_RIGHT] = lipWeights[XR_LIP_EXPRESSION_MOUTH_SMILE_RIGHT_HTC];
-	xr_weights[XRFaceTracker::FT_MOUTH_SMILE_LEFT] = lipWeights[XR_LIP_EXPRESSION_MOUTH_SMILE_LEFT_HTC];
-	xr_weights[XRFaceTracker::FT_MOUTH_SMILE] = average(xr_weights[XRFaceTracker::FT_MOUTH_SMILE_RIGHT], xr_weights[XRFaceTracker::FT_MOUTH_SMILE_LEFT]);
-	xr_weights[XRFaceTracker::FT_MOUTH_SAD_RIGHT] = lipWeights[XR_LIP_EXPRESSION_MOUTH_SAD_RIGHT_HTC];
-	xr_weights[XRFaceTracker::FT_MOUTH_SAD_LEFT] = lipWeights[XR_LIP_EXPRESSION_MOUTH_SAD_LEFT_HTC];
-	xr_weights[XRFaceTracker::FT_MOUTH_SAD] = average(xr_weights[XRFaceTracker::FT_MOUTH_SAD_RIGHT], xr_weights[XRFaceTracker::FT_MOUTH_SAD_LEFT]);
-	xr_weights[XRFaceTracker::FT_MOUTH_STRETCH] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_DIMPLE] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_TIGHTENER] = 0.0f; // Not measured by XR_htc_facial_tracking
-	xr_weights[XRFaceTracker::FT_MOUTH_PRESS] = 0.0f; // Not measured by XR_htc_facial_tracking
-
-	// Populate the XRFaceTracker
-	PackedFloat32Array xr_weights_array;
-	xr_weights_array.resize(XRFaceTracker::FT_MAX);
-	memcpy(xr_weights_array.ptrw(), xr_weights, sizeof(xr_weights));
-	xr_face_tracker->set_blend_shapes(xr_weights_array);
+	// Map HTC weights to Godot weights, and only publish them if they changed.
+	if (face_mapper.update(facial_remap_mapping, htc_weights, region_valid)) {
+		face_mapper.publish(xr_face_tracker);
+	}
 
 	// Register the XRFaceTracker if necessary
 	if (!xr_face_tracker_registered) {
@@ -102,6 +102,14 @@ bool OpenXRMetaSpatialEntityMeshExtensionWrapper::get_triangle_mesh(const XrSpac
 		return false;
 	}
 
+	return fetch_triangle_mesh(p_space, r_triangle_mesh);
+}
+
+bool OpenXRMetaSpatialEntityMeshExtensionWrapper::fetch_triangle_mesh(const XrSpace &p_space, TriangleMesh &r_triangle_mesh) {
+	if (!meta_spatial_entity_mesh_ext) {
+		return false;
+	}
+
 	XrSpaceTriangleMeshGetInfoMETA info = {
 		XR_TYPE_SPACE_TRIANGLE_MESH_GET_INFO_META, // type
 		nullptr, // next
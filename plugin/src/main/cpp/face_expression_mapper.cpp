@@ -0,0 +1,98 @@
+/**************************************************************************/
+/*  face_expression_mapper.cpp                                            */
+/**************************************************************************/
+/*                       This file is part of:                            */
+/*                              GODOT XR                                  */
+/*                      https://godotengine.org                           */
+/**************************************************************************/
+/* Copyright (c) 2022-present Godot XR contributors (see CONTRIBUTORS.md) */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "face_expression_mapper.h"
+
+#include <godot_cpp/core/math.hpp>
+
+using namespace godot;
+
+bool FaceExpressionMapper::update(const Mapping &p_mapping, const float *p_source_weights, const bool *p_region_valid) {
+	dirty_begin = XRFaceTracker::FT_MAX;
+	dirty_end = 0;
+	dirty_count = 0;
+
+	for (int i = 0; i < XRFaceTracker::FT_MAX; i++) {
+		const uint8_t *source = p_mapping.source[i];
+		const float *weight = p_mapping.weight[i];
+		const float value = weight[0] * p_source_weights[source[0]] +
+				weight[1] * p_source_weights[source[1]] +
+				weight[2] * p_source_weights[source[2]] +
+				weight[3] * p_source_weights[source[3]];
+		back[i] = p_region_valid[p_mapping.region[i]] ? value : back[i];
+
+		// Compare against what the tracker holds, so slow drifts below the
+		// epsilon still get published eventually.
+		if (Math::abs(back[i] - front[i]) > change_epsilon) {
+			dirty_begin = MIN(dirty_begin, i);
+			dirty_end = i + 1;
+			dirty_count++;
+		}
+	}
+
+	return publish_all || dirty_count > 0;
+}
+
+void FaceExpressionMapper::publish(const Ref<XRFaceTracker> &p_tracker) {
+	if (p_tracker.is_null() || (!publish_all && dirty_count == 0)) {
+		return;
+	}
+
+	if (publish_all || dirty_count > MAX_SPARSE_PUBLISH) {
+		// Bulk update. XRFaceTracker copies the weights, so the persistent
+		// array stays unshared and writing it never reallocates.
+		memcpy(front, back, sizeof(front));
+		if (published_weights.size() != XRFaceTracker::FT_MAX) {
+			published_weights.resize(XRFaceTracker::FT_MAX);
+		}
+		memcpy(published_weights.ptrw(), front, sizeof(front));
+		p_tracker->set_blend_shapes(published_weights);
+	} else {
+		for (int i = dirty_begin; i < dirty_end; i++) {
+			if (Math::abs(back[i] - front[i]) > change_epsilon) {
+				front[i] = back[i];
+				p_tracker->set_blend_shape(XRFaceTracker::BlendShapeEntry(i), front[i]);
+			}
+		}
+	}
+
+	dirty_begin = 0;
+	dirty_end = 0;
+	dirty_count = 0;
+	publish_all = false;
+}
+
+void FaceExpressionMapper::reset() {
+	memset(back, 0, sizeof(back));
+	memset(front, 0, sizeof(front));
+	dirty_begin = 0;
+	dirty_end = 0;
+	dirty_count = 0;
+	publish_all = true;
+}
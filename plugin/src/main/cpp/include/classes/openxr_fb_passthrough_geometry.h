@@ -45,13 +45,16 @@ private:
 	void destroy_passthrough_geometry();
 	void update_passthrough_geometry_transform();
 
+	bool has_opaque_mesh() const;
 	void instatiate_opaque_mesh();
 	void delete_opaque_mesh();
 
 	Ref<Mesh> mesh;
 	bool enable_hole_punch = true;
 	RID geometry_instance;
+	// The opaque mesh is a preview in the editor, and a batched hole punch otherwise.
 	MeshInstance3D *opaque_mesh = nullptr;
+	RID hole_punch;
 
 protected:
 	void _notification(int p_what);
@@ -34,13 +34,20 @@
 
 #include <godot_cpp/classes/node.hpp>
 #include <godot_cpp/classes/packed_scene.hpp>
+#include <godot_cpp/classes/xr_positional_tracker.hpp>
 #include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
 
 #include "classes/openxr_fb_spatial_entity.h"
+#include "extensions/openxr_fb_scene_extension_wrapper.h"
+#include "scene_anchor_bvh.h"
+#include "scene_cache.h"
+#include "uuid_hash_map.h"
 
 namespace godot {
 class XROrigin3D;
 class XRAnchor3D;
+class XRPose;
 
 class OpenXRFbSceneManager : public Node {
 	GDCLASS(OpenXRFbSceneManager, Node);
@@ -49,13 +56,17 @@ class OpenXRFbSceneManager : public Node {
 	StringName scene_setup_method = "setup_scene";
 	bool auto_create = true;
 	bool visible = true;
-	HashMap<StringName, Ref<PackedScene>> scenes;
+	// Indexed by semantic label, with the labels that have a scene in scene_label_mask.
+	Ref<PackedScene> scenes[OpenXRFbSceneExtensionWrapper::SEMANTIC_LABEL_COUNT];
+	uint32_t scene_label_mask = 0;
 
 	XROrigin3D *xr_origin = nullptr;
 
 	struct Anchor {
 		ObjectID node;
 		Ref<OpenXRFbSpatialEntity> entity;
+		int32_t bvh_item = -1;
+		Ref<XRPositionalTracker> tracker;
 
 		Anchor(Node *p_node, const Ref<OpenXRFbSpatialEntity> &p_entity) {
 			node = p_node->get_instance_id();
@@ -63,9 +74,87 @@ class OpenXRFbSceneManager : public Node {
 		}
 		Anchor() {}
 	};
-	HashMap<StringName, Anchor> anchors;
+	UuidHashMap<Anchor> anchors;
 	bool anchors_created = false;
 
+	// Scene anchors are set up and instantiated over several frames, within
+	// instantiation_budget_usec per frame.
+	int instantiation_budget_usec = 2000;
+
+	struct PendingAnchor {
+		Ref<OpenXRFbSpatialEntity> entity;
+		Ref<PackedScene> packed_scene;
+		float distance = 0.0;
+	};
+
+	struct PendingAnchorFarthestFirst {
+		_FORCE_INLINE_ bool operator()(const PendingAnchor &p_a, const PendingAnchor &p_b) const {
+			return p_a.distance > p_b.distance;
+		}
+	};
+
+	// Entities from the anchor query that haven't been set up yet.
+	LocalVector<Ref<OpenXRFbSpatialEntity>> pending_entities;
+	// Locatable entities waiting to be instantiated, sorted so the nearest is last.
+	LocalVector<PendingAnchor> pending_anchors;
+	bool pending_anchors_sorted = true;
+
+	// Scene data of the last captured rooms, used to instantiate the scene
+	// anchors before the runtime has answered any queries.
+	String scene_cache_path;
+	SceneCache scene_cache;
+	// Cache key of the rooms whose anchors are instantiated (see
+	// SceneCache::make_room_key()), and the data being captured for them.
+	XrUuidEXT scene_room = {};
+	bool has_scene_room = false;
+	SceneCache::Room scene_snapshot;
+	bool capturing_scene_snapshot = false;
+
+	// Scene data of a runtime entity being captured. The triangle mesh is fetched
+	// and compared against the cached anchor on a worker thread, since that's
+	// too slow to fit in the instantiation budget.
+	struct SceneCapture {
+		Ref<OpenXRFbSpatialEntity> entity;
+		Ref<OpenXRFbSpatialEntity> cached_entity;
+		SceneCache::EntityData data;
+		bool unchanged = false;
+		int64_t task_id = -1;
+	};
+	// Sized for the whole anchor query up front, since workers index into it.
+	LocalVector<SceneCapture> scene_captures;
+	uint32_t scene_captures_started = 0;
+	uint32_t scene_captures_left = 0;
+	// Bumped when the captures are cancelled, to drop their pending results.
+	uint32_t scene_capture_generation = 0;
+
+	void _create_cached_scene_anchors();
+	void _remove_cached_scene_anchors(const Array &p_keep_entities);
+	void _capture_scene_anchor(const Ref<OpenXRFbSpatialEntity> &p_entity);
+	void _scene_capture_task(uint32_t p_index);
+	void _finish_scene_capture(uint32_t p_index, uint32_t p_generation);
+	void _cancel_scene_captures();
+	Ref<OpenXRFbSpatialEntity> _find_cached_entity(const XrUuidEXT &p_uuid) const;
+	void _finish_scene_snapshot();
+	void _update_scene_cache_poses();
+	void _save_scene_cache();
+
+	void _free_anchor(Anchor &p_anchor);
+	void _remove_scene_anchor(const XrUuidEXT &p_uuid);
+
+	// Anchor bounds, kept up to date from the anchor trackers' poses.
+	SceneAnchorBVH anchor_bvh;
+
+	void _add_anchor_to_bvh(Anchor &p_anchor);
+	void _connect_anchor_tracker(Anchor &p_anchor, const Ref<XRPositionalTracker> &p_tracker);
+	void _on_tracker_added(const StringName &p_tracker_name, int p_type);
+	void _on_anchor_pose_changed(const Ref<XRPose> &p_pose, int32_t p_bvh_item);
+	Dictionary _make_anchor_result(int32_t p_bvh_item) const;
+
+	void _update_pending_work_processing();
+	void _process_pending_work();
+	void _sort_pending_anchors();
+	void _clear_pending_work();
+
 protected:
 	bool _set(const StringName &p_name, const Variant &p_value);
 	bool _get(const StringName &p_name, Variant &r_ret) const;
@@ -78,6 +167,8 @@ protected:
 
 	void _on_room_layout_query_completed(Array p_results);
 	void _on_anchor_query_completed(const Array &p_results);
+	void _setup_scene_anchor(const Ref<OpenXRFbSpatialEntity> &p_entity, bool p_unchanged);
+	void _queue_scene_anchor(const Ref<OpenXRFbSpatialEntity> &p_entity, const Ref<PackedScene> &p_packed_scene);
 	void _on_anchor_enable_locatable_completed(bool p_succeeded, OpenXRFbSpatialEntity::ComponentType p_component, bool p_enabled, const Ref<OpenXRFbSpatialEntity> &p_entity, const Ref<PackedScene> &p_packed_scene);
 	void _create_scene_anchor(const Ref<OpenXRFbSpatialEntity> &p_entity, const Ref<PackedScene> &p_packed_scene);
 	Ref<PackedScene> get_scene_for_entity(const Ref<OpenXRFbSpatialEntity> &p_entity) const;
@@ -96,6 +187,12 @@ public:
 	void set_auto_create(bool p_auto_create);
 	bool get_auto_create() const;
 
+	void set_instantiation_budget_usec(int p_usec);
+	int get_instantiation_budget_usec() const;
+
+	void set_scene_cache_path(const String &p_path);
+	String get_scene_cache_path() const;
+
 	void set_visible(bool p_visible);
 	bool get_visible() const;
 	void show();
@@ -111,9 +208,13 @@ public:
 
 	static void _scene_capture_callback(XrResult p_result, void *p_userdata);
 
-	Array get_anchor_uuids() const;
+	Array get_anchor_uuids(BitField<OpenXRFbSpatialEntity::SemanticLabelFlags> p_label_mask = 0) const;
 	XRAnchor3D *get_anchor_node(const StringName &p_uuid) const;
 	Ref<OpenXRFbSpatialEntity> get_spatial_entity(const StringName &p_uuids) const;
+
+	Dictionary raycast_anchors(const Vector3 &p_from, const Vector3 &p_to, BitField<OpenXRFbSpatialEntity::SemanticLabelFlags> p_label_mask = 0);
+	Array get_anchors_in_sphere(const Vector3 &p_center, float p_radius, BitField<OpenXRFbSpatialEntity::SemanticLabelFlags> p_label_mask = 0);
+	Array get_nearest_anchors(const Vector3 &p_point, int p_count = 1, BitField<OpenXRFbSpatialEntity::SemanticLabelFlags> p_label_mask = 0);
 };
 } // namespace godot
 
@@ -34,8 +34,11 @@
 
 #include <godot_cpp/classes/node.hpp>
 #include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
 
 #include "classes/openxr_fb_spatial_entity.h"
+#include "spatial_anchor_index.h"
+#include "uuid_hash_map.h"
 
 namespace godot {
 class PackedScene;
@@ -48,30 +51,66 @@ class OpenXRFbSpatialAnchorManager : public Node {
 	Ref<PackedScene> scene;
 	StringName scene_setup_method = "setup_scene";
 	bool visible = true;
+	bool batch_storage_saves = false;
 
 	XROrigin3D *xr_origin = nullptr;
 
+	// Anchors restored from the anchor index have no entity until the runtime
+	// has loaded them.
 	struct Anchor {
 		ObjectID node;
+		ObjectID scene_node;
 		Ref<OpenXRFbSpatialEntity> entity;
 
-		Anchor(Node *p_node, const Ref<OpenXRFbSpatialEntity> &p_entity) {
+		Anchor(Node *p_node, Node *p_scene_node, const Ref<OpenXRFbSpatialEntity> &p_entity) {
 			node = p_node->get_instance_id();
+			if (p_scene_node) {
+				scene_node = p_scene_node->get_instance_id();
+			}
 			entity = p_entity;
 		}
 		Anchor() {}
 	};
-	HashMap<StringName, Anchor> anchors;
+	UuidHashMap<Anchor> anchors;
+
+	struct PendingSave {
+		Ref<OpenXRFbSpatialEntity> entity;
+		bool new_anchor = false;
+
+		PendingSave(const Ref<OpenXRFbSpatialEntity> &p_entity, bool p_new_anchor) {
+			entity = p_entity;
+			new_anchor = p_new_anchor;
+		}
+		PendingSave() {}
+	};
+	LocalVector<PendingSave> pending_saves;
+	bool pending_saves_flush_queued = false;
+
+	String anchor_index_path;
+	SpatialAnchorIndex anchor_index;
+	bool anchor_index_flush_queued = false;
 
 	void _cleanup_anchors();
 
+	Node *_instantiate_anchor_scene(XRAnchor3D *p_node, const String &p_scene_path);
+	void _restore_indexed_anchor(const XrUuidEXT &p_uuid);
+	void _remove_restored_anchor(const XrUuidEXT &p_uuid, bool p_erase_record);
+	void _update_anchor_index_poses();
+	void _queue_anchor_index_flush();
+	void _flush_anchor_index();
+
 	void _track_anchor(const Ref<OpenXRFbSpatialEntity> &p_spatial_entity, bool p_new_anchor);
 
 	void _on_anchor_created(bool p_success, const Transform3D &p_transform, const Ref<OpenXRFbSpatialEntity> &p_spatial_entity);
-	void _on_anchor_load_query_completed(const Array &p_results, const Dictionary &p_anchors_custom_data, OpenXRFbSpatialEntity::StorageLocation p_location, bool p_erase_unknown_anchors);
+	void _on_anchor_load_query_results(const Array &p_results, const Dictionary &p_anchors_custom_data, bool p_erase_unknown_anchors);
+	void _on_anchor_load_query_completed(const Array &p_results, const Dictionary &p_anchors_custom_data, OpenXRFbSpatialEntity::StorageLocation p_location, uint64_t p_query_id);
+	void _on_anchor_track_failed(const Ref<OpenXRFbSpatialEntity> &p_spatial_entity);
 	void _on_anchor_track_enable_locatable_completed(bool p_succeeded, OpenXRFbSpatialEntity::ComponentType p_component, bool p_enabled, const Ref<OpenXRFbSpatialEntity> &p_entity, bool p_new_anchor);
 	void _on_anchor_track_enable_storable_completed(bool p_succeeded, OpenXRFbSpatialEntity::ComponentType p_component, bool p_enabled, const Ref<OpenXRFbSpatialEntity> &p_entity, bool p_new_anchor);
 	void _on_anchor_saved(bool p_succeeded, OpenXRFbSpatialEntity::StorageLocation p_location, const Ref<OpenXRFbSpatialEntity> &p_spatial_entity, bool p_new_anchor);
+	void _queue_anchor_save(const Ref<OpenXRFbSpatialEntity> &p_spatial_entity, bool p_new_anchor);
+	void _flush_anchor_saves();
+	void _on_anchor_batch_saved(bool p_succeeded, OpenXRFbSpatialEntity::StorageLocation p_location, const Array &p_spatial_entities, const Array &p_new_anchors);
 	void _complete_anchor_setup(const Ref<OpenXRFbSpatialEntity> &p_spatial_entity, bool p_new_anchor);
 
 	void _untrack_anchor(const Ref<OpenXRFbSpatialEntity> &p_spatial_entity);
@@ -100,15 +139,23 @@ public:
 	void show();
 	void hide();
 
+	void set_batch_storage_saves(bool p_enable);
+	bool get_batch_storage_saves() const;
+
+	void set_anchor_index_path(const String &p_path);
+	String get_anchor_index_path() const;
+
 	void create_anchor(const Transform3D &p_transform, const Dictionary &p_custom_data);
 	void load_anchor(const StringName &p_uuid, const Dictionary &p_custom_data, OpenXRFbSpatialEntity::StorageLocation p_location);
 	void load_anchors(const TypedArray<StringName> &p_uuids, const Dictionary &p_all_custom_data, OpenXRFbSpatialEntity::StorageLocation p_location, bool p_erase_unknown_anchors = false);
+	void load_indexed_anchors(OpenXRFbSpatialEntity::StorageLocation p_location, bool p_erase_unknown_anchors = false);
 	void track_anchor(const Ref<OpenXRFbSpatialEntity> &p_spatial_entity);
 	void untrack_anchor(const Variant &p_spatial_entity_or_uuid);
 
 	Array get_anchor_uuids() const;
 	XRAnchor3D *get_anchor_node(const StringName &p_uuid) const;
 	Ref<OpenXRFbSpatialEntity> get_spatial_entity(const StringName &p_uuids) const;
+	Array get_indexed_anchor_uuids() const;
 };
 } // namespace godot
 
@@ -32,9 +32,12 @@
 
 #include <openxr/openxr.h>
 
+#include <godot_cpp/classes/array_mesh.hpp>
 #include <godot_cpp/classes/ref_counted.hpp>
 #include <godot_cpp/templates/hash_map.hpp>
 
+#include "scene_cache.h"
+
 namespace godot {
 class Node3D;
 class MeshInstance3D;
@@ -62,11 +65,63 @@ public:
 		COMPONENT_TYPE_TRIANGLE_MESH,
 	};
 
+	// Bit order follows OpenXRFbSceneExtensionWrapper::get_supported_semantic_labels().
+	enum SemanticLabelFlags {
+		SEMANTIC_LABEL_CEILING = 1 << 0,
+		SEMANTIC_LABEL_DOOR_FRAME = 1 << 1,
+		SEMANTIC_LABEL_FLOOR = 1 << 2,
+		SEMANTIC_LABEL_INVISIBLE_WALL_FACE = 1 << 3,
+		SEMANTIC_LABEL_WALL_ART = 1 << 4,
+		SEMANTIC_LABEL_WALL_FACE = 1 << 5,
+		SEMANTIC_LABEL_WINDOW_FRAME = 1 << 6,
+		SEMANTIC_LABEL_COUCH = 1 << 7,
+		SEMANTIC_LABEL_TABLE = 1 << 8,
+		SEMANTIC_LABEL_BED = 1 << 9,
+		SEMANTIC_LABEL_LAMP = 1 << 10,
+		SEMANTIC_LABEL_PLANT = 1 << 11,
+		SEMANTIC_LABEL_SCREEN = 1 << 12,
+		SEMANTIC_LABEL_STORAGE = 1 << 13,
+		SEMANTIC_LABEL_GLOBAL_MESH = 1 << 14,
+		SEMANTIC_LABEL_OTHER = 1 << 15,
+	};
+
 private:
 	XrSpace space = XR_NULL_HANDLE;
-	StringName uuid;
+	XrUuidEXT uuid = {};
+	bool has_uuid = false;
+
+	// Text form of the UUID, only built when it's needed.
+	mutable StringName uuid_name;
 	Dictionary custom_data;
 
+	// Scene data loaded from the SceneCache, used until a space is attached.
+	bool cached = false;
+	SceneCache::EntityData cached_data;
+
+	// Semantic labels are read from the runtime once, along with their mask.
+	mutable bool semantic_labels_parsed = false;
+	mutable PackedStringArray semantic_labels;
+	mutable uint32_t semantic_label_mask = 0;
+	mutable int primary_semantic_label = -1;
+
+	void parse_semantic_labels() const;
+	bool get_triangle_mesh_data(Vector<XrVector3f> &r_vertices, Vector<uint32_t> &r_indices) const;
+
+	// State of create_geometry_async(). Only touched by the worker while a
+	// task is running, and by the main thread otherwise.
+	Ref<OpenXRFbSpatialEntity> geometry_task_owner;
+	int64_t geometry_task_id = -1;
+	bool geometry_task_triangle_mesh = false;
+	bool geometry_task_cached = false;
+	bool geometry_task_mesh_instance = false;
+	bool geometry_task_collision_shape = false;
+	Ref<ArrayMesh> geometry_task_mesh;
+	PackedVector3Array geometry_task_faces;
+
+	void _create_geometry_task();
+	void _finish_geometry_task();
+	void wait_for_geometry_task();
+
 protected:
 	static void _bind_methods();
 
@@ -80,6 +135,7 @@ protected:
 
 public:
 	StringName get_uuid() const;
+	const XrUuidEXT &get_xr_uuid() const { return uuid; }
 
 	void set_custom_data(const Dictionary &p_custom_data);
 	Dictionary get_custom_data() const;
@@ -90,6 +146,10 @@ public:
 	void set_component_enabled(ComponentType p_component, bool p_enabled);
 
 	PackedStringArray get_semantic_labels() const;
+	BitField<SemanticLabelFlags> get_semantic_label_mask() const;
+	bool has_semantic_label(BitField<SemanticLabelFlags> p_label_mask) const;
+	// Index of the first label given by the runtime, or -1 if it has none.
+	int get_primary_semantic_label() const;
 	Dictionary get_room_layout() const;
 	Array get_contained_uuids() const;
 	Rect2 get_bounding_box_2d() const;
@@ -103,6 +163,8 @@ public:
 
 	MeshInstance3D *create_mesh_instance() const;
 	Node3D *create_collision_shape() const;
+	void create_geometry_async(bool p_mesh_instance = true, bool p_collision_shape = true);
+	bool is_creating_geometry() const;
 
 	static Ref<OpenXRFbSpatialEntity> create_spatial_anchor(const Transform3D &p_transform);
 
@@ -118,12 +180,25 @@ public:
 
 	XrSpace get_space();
 
+	// Cached entities answer scene queries from their cached data, until the
+	// space for the same UUID is attached from the runtime.
+	bool is_cached() const { return cached && space == XR_NULL_HANDLE; }
+	const SceneCache::EntityData &get_cached_data() const { return cached_data; }
+	void attach_space(XrSpace p_space);
+	// Captures the scene data of the entity for the scene cache, except for the
+	// triangle mesh, which is added by fetch_scene_mesh_data(). Only the latter
+	// is safe to call from worker threads.
+	bool capture_scene_data(SceneCache::EntityData &r_data) const;
+	void fetch_scene_mesh_data(SceneCache::EntityData &r_data) const;
+
 	OpenXRFbSpatialEntity() = default;
 	OpenXRFbSpatialEntity(XrSpace p_space, const XrUuidEXT &p_uuid);
+	OpenXRFbSpatialEntity(const XrUuidEXT &p_uuid, const SceneCache::EntityData &p_cached_data);
 };
 } // namespace godot
 
 VARIANT_ENUM_CAST(OpenXRFbSpatialEntity::StorageLocation);
 VARIANT_ENUM_CAST(OpenXRFbSpatialEntity::ComponentType);
+VARIANT_BITFIELD_CAST(OpenXRFbSpatialEntity::SemanticLabelFlags);
 
 #endif
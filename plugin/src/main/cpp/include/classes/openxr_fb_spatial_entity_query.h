@@ -54,8 +54,13 @@ private:
 	uint32_t max_results = 25;
 	float timeout = 0.0f;
 	Array uuids;
+	bool stream_results = false;
+
+	// Entities created from each page of results, when streaming.
+	Array streamed_results;
 
 	bool executed = false;
+	bool successful = false;
 
 protected:
 	static void _bind_methods();
@@ -71,6 +76,9 @@ public:
 	void set_timeout(float p_timeout);
 	float get_timeout() const;
 
+	void set_stream_results(bool p_stream_results);
+	bool get_stream_results() const;
+
 	void query_all();
 	void query_by_uuid(Array p_uuids, OpenXRFbSpatialEntity::StorageLocation p_location = OpenXRFbSpatialEntity::STORAGE_LOCAL);
 	void query_by_component(OpenXRFbSpatialEntity::ComponentType p_component_type, OpenXRFbSpatialEntity::StorageLocation p_location = OpenXRFbSpatialEntity::STORAGE_LOCAL);
@@ -82,8 +90,10 @@ public:
 
 	Error execute();
 	bool is_executed() const;
+	bool is_successful() const;
 
-	static void _results_callback(const Vector<XrSpaceQueryResultFB> &p_results, void *p_userdata);
+	static void _results_callback(XrResult p_result, const Vector<XrSpaceQueryResultFB> &p_results, void *p_userdata);
+	static void _results_page_callback(const XrSpaceQueryResultFB *p_results, uint32_t p_count, void *p_userdata);
 };
 } // namespace godot
 
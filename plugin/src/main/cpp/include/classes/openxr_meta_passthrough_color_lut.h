@@ -33,6 +33,8 @@
 #include <godot_cpp/classes/image.hpp>
 #include <godot_cpp/classes/ref_counted.hpp>
 
+#include <atomic>
+
 namespace godot {
 class OpenXRMetaPassthroughColorLut : public RefCounted {
 	GDCLASS(OpenXRMetaPassthroughColorLut, RefCounted);
@@ -47,7 +49,34 @@ private:
 	RID color_lut_handle;
 	int image_cell_resolution = 0;
 	ColorLutChannels channels;
+	// Left empty when the color LUT is shared with an identical one.
 	PackedByteArray buffer;
+	uint64_t content_hash = 0;
+
+	// State of the rows being populated, which may be spread over worker threads.
+	Ref<OpenXRMetaPassthroughColorLut> populate_task_owner;
+	int64_t populate_task_prepare_id = -1;
+	bool populate_task_prepared = false;
+	int64_t populate_task_id = -1;
+	PackedByteArray populate_task_image_data;
+	Image::Format populate_task_image_format = Image::FORMAT_MAX;
+	bool populate_task_image_mipmaps = false;
+	int populate_task_image_width = 0;
+	int populate_task_rows = 0;
+	std::atomic<int> populate_task_rows_left{ 0 };
+	const uint8_t *populate_task_src = nullptr;
+	uint8_t *populate_task_dst = nullptr;
+
+	bool begin_populate(const Ref<Image> &p_image, ColorLutChannels p_channels);
+	bool prepare_populate();
+	bool start_populate();
+	void end_populate();
+
+	void _prepare_populate_task();
+	void _on_populate_prepared();
+	void _populate_row(uint32_t p_row);
+	void _populate_row_task(uint32_t p_row);
+	void _finish_populate_task();
 
 protected:
 	static void _bind_methods();
@@ -56,12 +85,16 @@ protected:
 
 public:
 	static Ref<OpenXRMetaPassthroughColorLut> create_from_image(Ref<Image> p_image, ColorLutChannels p_channels);
+	static Ref<OpenXRMetaPassthroughColorLut> create_from_image_async(Ref<Image> p_image, ColorLutChannels p_channels);
+
+	bool is_creating() const;
 
 	RID get_handle() const { return color_lut_handle; }
 
 	int get_image_cell_resolution() const { return image_cell_resolution; }
 	PackedByteArray get_buffer() const { return buffer; }
 	ColorLutChannels get_channels() const { return channels; }
+	uint64_t get_content_hash() const { return content_hash; }
 
 	~OpenXRMetaPassthroughColorLut();
 };
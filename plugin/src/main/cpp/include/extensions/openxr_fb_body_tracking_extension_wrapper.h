@@ -37,11 +37,14 @@
 #endif
 
 #include <openxr/openxr.h>
+#include <godot_cpp/classes/file_access.hpp>
 #include <godot_cpp/classes/open_xr_extension_wrapper_extension.hpp>
 #include <godot_cpp/classes/xr_body_tracker.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 #include <map>
 
+#include "pose_history.h"
 #include "util.h"
 
 using namespace godot;
@@ -69,6 +72,33 @@ public:
 
 	bool is_enabled() const;
 
+	void set_joint_filter_enabled(bool p_enabled);
+	bool is_joint_filter_enabled() const;
+
+	void set_joint_filter_min_cutoff(float p_min_cutoff);
+	float get_joint_filter_min_cutoff() const;
+
+	void set_joint_filter_beta(float p_beta);
+	float get_joint_filter_beta() const;
+
+	void set_joint_filter_derivative_cutoff(float p_derivative_cutoff);
+	float get_joint_filter_derivative_cutoff() const;
+
+	Vector3 get_joint_linear_velocity(XRBodyTracker::Joint p_joint) const;
+	Vector3 get_joint_angular_velocity(XRBodyTracker::Joint p_joint) const;
+
+	Error start_recording(const String &p_path);
+	void stop_recording();
+	bool is_recording() const;
+
+	Error start_replay(const String &p_path, bool p_loop);
+	void stop_replay();
+	bool is_replaying() const;
+	bool process_replay_frame();
+
+	PackedInt64Array get_process_time_histogram() const;
+	void reset_process_time_histogram();
+
 	OpenXRFbBodyTrackingExtensionWrapper();
 	~OpenXRFbBodyTrackingExtensionWrapper();
 
@@ -93,6 +123,16 @@ private:
 
 	void cleanup();
 
+	void create_xr_body_tracker(bool p_lower_body_supported);
+
+	void process_body_joints(XrTime p_display_time);
+
+	void convert_joint_locations(const XrBodyJointLocationFB *p_locations, uint32_t p_entry_count, XrTime p_time);
+
+	void filter_joints(uint32_t p_entry_count, XrTime p_time);
+
+	void reset_joint_filters();
+
 	static OpenXRFbBodyTrackingExtensionWrapper *singleton;
 
 	std::map<godot::String, bool *> request_extensions;
@@ -113,6 +153,86 @@ private:
 	// Godot XRBodyTracker instance.
 	Ref<XRBodyTracker> xr_body_tracker;
 
+	// Structure-of-arrays conversion buffers, indexed by joint table entry.
+	// These are preallocated so the per-frame conversion can run as flat
+	// loops over the joint table without touching the XRBodyTracker.
+	static constexpr int JOINT_BUFFER_SIZE = XRBodyTracker::JOINT_MAX;
+
+	struct JointConversionBuffers {
+		uint32_t location_flags[JOINT_BUFFER_SIZE];
+		real_t position_x[JOINT_BUFFER_SIZE];
+		real_t position_y[JOINT_BUFFER_SIZE];
+		real_t position_z[JOINT_BUFFER_SIZE];
+		real_t orientation_x[JOINT_BUFFER_SIZE];
+		real_t orientation_y[JOINT_BUFFER_SIZE];
+		real_t orientation_z[JOINT_BUFFER_SIZE];
+		real_t orientation_w[JOINT_BUFFER_SIZE];
+		real_t correction_x[JOINT_BUFFER_SIZE];
+		real_t correction_y[JOINT_BUFFER_SIZE];
+		real_t correction_z[JOINT_BUFFER_SIZE];
+		real_t correction_w[JOINT_BUFFER_SIZE];
+	};
+	JointConversionBuffers joint_buffers;
+
+	// Number of joint table entries covered by the default (upper body) joint set.
+	uint32_t default_joint_set_entry_count = 0;
+
+	// Per-joint pose history, velocity estimate and One-Euro filter state.
+	struct JointFilterState {
+		PoseHistory history;
+
+		Vector3 filtered_position;
+		Quaternion filtered_orientation;
+		Vector3 filtered_linear_speed;
+		real_t filtered_angular_speed = 0.0;
+
+		Vector3 linear_velocity;
+		Vector3 angular_velocity;
+	};
+	JointFilterState joint_filter_states[XRBodyTracker::JOINT_MAX];
+
+	XrTime last_filter_time = 0;
+
+	// Body tracking capture recording.
+	void record_frame(XrTime p_time, const XrBodyJointLocationsFB &p_locations);
+
+	Ref<FileAccess> record_file;
+	PackedByteArray record_frame_buffer;
+	uint32_t record_joint_count = 0;
+
+	// Body tracking capture replay, used in place of xrLocateBodyJointsFB.
+	void locate_replay_body_joints(XrBodyJointLocationsFB &r_locations) const;
+
+	struct ReplayFrame {
+		XrTime time = 0;
+		bool is_active = false;
+		float confidence = 0.0;
+	};
+
+	bool replaying = false;
+	bool replay_loop = false;
+	LocalVector<ReplayFrame> replay_frames;
+	LocalVector<XrBodyJointLocationFB> replay_joints;
+	uint32_t replay_joint_count = 0;
+	uint32_t replay_frame_index = 0;
+
+	// Histogram of body joint processing times, in power-of-two microsecond buckets.
+	static constexpr uint32_t PROCESS_TIME_HISTOGRAM_SIZE = 16;
+
+	void record_process_time(uint64_t p_usec);
+
+	uint64_t process_time_histogram[PROCESS_TIME_HISTOGRAM_SIZE] = {};
+
+	// One-Euro filter settings.
+	bool joint_filter_enabled = false;
+	float joint_filter_min_cutoff = 1.0;
+	float joint_filter_beta = 0.5;
+	float joint_filter_derivative_cutoff = 1.0;
+
+	// Converted joint data, indexed by XRBodyTracker::Joint, ready to publish.
+	Transform3D joint_transforms[XRBodyTracker::JOINT_MAX];
+	int64_t joint_flags[XRBodyTracker::JOINT_MAX];
+
 	// META_body_tracking_full_body extension.
 public:
 	bool is_full_body_tracking_supported();
@@ -36,6 +36,7 @@
 #include <godot_cpp/variant/utility_functions.hpp>
 #include <map>
 
+#include "face_expression_mapper.h"
 #include "util.h"
 
 using namespace godot;
@@ -63,6 +64,9 @@ public:
 
 	bool is_enabled() const;
 
+	void set_confidence_threshold(float p_threshold);
+	float get_confidence_threshold() const;
+
 	OpenXRFbFaceTrackingExtensionWrapper();
 	~OpenXRFbFaceTrackingExtensionWrapper();
 
@@ -102,6 +106,12 @@ private:
 
 	// Godot XRFaceTracker instance.
 	Ref<XRFaceTracker> xr_face_tracker;
+
+	// Maps Meta weights to Godot weights, holding low-confidence regions.
+	FaceExpressionMapper face_mapper;
+
+	// Minimum region confidence required to update its weights.
+	float confidence_threshold = 0.0;
 };
 
 #endif // OPENXR_FB_FACE_TRACKING_EXTENSION_WRAPPER_H
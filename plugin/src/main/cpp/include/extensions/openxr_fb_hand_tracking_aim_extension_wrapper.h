@@ -37,6 +37,8 @@
 
 #include <map>
 
+#include "pose_history.h"
+
 using namespace godot;
 
 // Wrapper for the set of Facebook XR hand tracking aim extension.
@@ -85,6 +87,38 @@ private:
 	Ref<XRPositionalTracker> trackers[Hand::HAND_MAX];
 
 	XrHandTrackingAimStateFB aim_state[Hand::HAND_MAX];
+
+	enum AimInput {
+		AIM_INPUT_INDEX_PINCH,
+		AIM_INPUT_MIDDLE_PINCH,
+		AIM_INPUT_RING_PINCH,
+		AIM_INPUT_LITTLE_PINCH,
+		AIM_INPUT_INDEX_PINCH_STRENGTH,
+		AIM_INPUT_MIDDLE_PINCH_STRENGTH,
+		AIM_INPUT_RING_PINCH_STRENGTH,
+		AIM_INPUT_LITTLE_PINCH_STRENGTH,
+		AIM_INPUT_DOMINANT_HAND,
+		AIM_INPUT_MENU_GESTURE,
+		AIM_INPUT_MENU_PRESSED,
+		AIM_INPUT_SYSTEM_GESTURE,
+		AIM_INPUT_MAX,
+	};
+
+	// Input names, interned once so publishing doesn't hash strings.
+	StringName default_pose_name;
+	StringName input_names[AIM_INPUT_MAX];
+
+	// Last published input values, so only changed inputs are pushed.
+	float input_values[Hand::HAND_MAX][AIM_INPUT_MAX];
+	bool inputs_published[Hand::HAND_MAX] = {};
+
+	void set_input(int p_hand, AimInput p_input, bool p_value);
+	void set_input(int p_hand, AimInput p_input, float p_value);
+
+	// Aim pose history, used for finite-difference velocities.
+	PoseHistory aim_history[Hand::HAND_MAX];
+
+	void update_aim_velocity(int p_hand, const Transform3D &p_transform, XrTime p_time, Vector3 &r_linear_velocity, Vector3 &r_angular_velocity);
 };
 
 #endif // OPENXR_FB_HAND_TRACKING_AIM_EXTENSION_WRAPPER_H
@@ -32,7 +32,9 @@
 
 #include <openxr/openxr.h>
 #include <godot_cpp/classes/open_xr_extension_wrapper_extension.hpp>
+#include <godot_cpp/classes/collision_shape3d.hpp>
 #include <godot_cpp/classes/xr_hand_tracker.hpp>
+#include <godot_cpp/variant/typed_array.hpp>
 #include <map>
 
 using namespace godot;
@@ -50,6 +52,8 @@ public:
 
 	uint64_t _set_hand_joint_locations_and_get_next_pointer(int32_t p_hand_index, void *p_next_pointer) override;
 
+	void _on_process() override;
+
 	bool is_enabled() {
 		return fb_hand_tracking_capsules_ext;
 	}
@@ -60,6 +64,13 @@ public:
 	float get_hand_capsule_radius(int p_hand_index, int p_capsule_index) const;
 	HandJoint get_hand_capsule_joint(int p_hand_index, int p_capsule_index) const;
 
+	// Number of floats per capsule in get_hand_capsules(): origin (3),
+	// rotation quaternion (4), height and radius.
+	static const int CAPSULE_DATA_STRIDE = 9;
+
+	PackedFloat32Array get_hand_capsules(int p_hand_index) const;
+	void update_hand_capsule_shapes(int p_hand_index, const TypedArray<CollisionShape3D> &p_shapes);
+
 	static OpenXRFbHandTrackingCapsulesExtensionWrapper *get_singleton();
 
 	OpenXRFbHandTrackingCapsulesExtensionWrapper();
@@ -79,6 +90,17 @@ private:
 
 	static const int HAND_MAX = 2;
 	XrHandTrackingCapsulesStateFB capsules_state[HAND_MAX];
+
+	// Capsule geometry, computed once per frame in _on_process().
+	struct CapsuleCache {
+		Transform3D transforms[XR_HAND_TRACKING_CAPSULE_COUNT_FB];
+		float heights[XR_HAND_TRACKING_CAPSULE_COUNT_FB] = {};
+		float radii[XR_HAND_TRACKING_CAPSULE_COUNT_FB] = {};
+		HandJoint joints[XR_HAND_TRACKING_CAPSULE_COUNT_FB] = {};
+	};
+	CapsuleCache capsule_cache[HAND_MAX];
+
+	void update_capsule_cache(int p_hand_index);
 };
 
 #endif // OPENXR_FB_HAND_TRACKING_CAPSULES_EXTENSION_WRAPPER_H
@@ -90,6 +90,15 @@ private:
 			(XrHandTrackerEXT), handTracker,
 			(XrHandTrackingMeshFB *), mesh);
 
+	EXT_PROTO_XRRESULT_FUNC2(xrGetInstanceProperties,
+			(XrInstance), instance,
+			(XrInstanceProperties *), instanceProperties);
+
+	EXT_PROTO_XRRESULT_FUNC3(xrGetSystemProperties,
+			(XrInstance), instance,
+			(XrSystemId), systemId,
+			(XrSystemProperties *), properties);
+
 	bool initialize_fb_hand_tracking_mesh_extension(const XrInstance instance);
 
 	void cleanup();
@@ -106,12 +115,65 @@ private:
 	};
 	LocalVector<FetchCallback> fetch_callbacks;
 
+	// Raw mesh data as returned by xrGetHandMeshFB. This is also the layout
+	// of the on-disk cache.
+	struct MeshData {
+		LocalVector<XrVector3f> vertex_positions;
+		LocalVector<XrVector3f> vertex_normals;
+		LocalVector<XrVector2f> vertex_uvs;
+		LocalVector<XrVector4sFB> vertex_blend_indices;
+		LocalVector<XrVector4f> vertex_blend_weights;
+		LocalVector<int16_t> indices;
+
+		void reset() {
+			vertex_positions.reset();
+			vertex_normals.reset();
+			vertex_uvs.reset();
+			vertex_blend_indices.reset();
+			vertex_blend_weights.reset();
+			indices.reset();
+		}
+	};
+
+	enum FetchState {
+		FETCH_IDLE,
+		FETCH_LOADING_CACHE,
+		FETCH_BUILDING_MESHES,
+	};
+
 	bool should_fetch_hand_mesh_data = false;
 	Ref<ArrayMesh> hand_mesh[Hand::HAND_MAX];
 	BoneData bone_data[Hand::HAND_MAX];
 	XrHandTrackingScaleFB hand_tracking_scale[Hand::HAND_MAX];
 
+	// Mesh data and results of the worker task. Only touched by the worker
+	// while a task is running, and by the main thread otherwise. Bone data
+	// read from the cache is kept apart until finish_fetch_task() publishes
+	// it, as bone_data may be in use for a hand that already has its mesh;
+	// workers only read bone_data, when saving the cache.
+	MeshData mesh_data[Hand::HAND_MAX];
+	BoneData cached_bone_data[Hand::HAND_MAX];
+	Ref<ArrayMesh> built_hand_mesh[Hand::HAND_MAX];
+	bool cache_loaded = false;
+
+	FetchState fetch_state = FETCH_IDLE;
+	int64_t fetch_task_id = -1;
+	bool mesh_cache_checked = false;
+	String mesh_cache_key;
+
 	bool fetch_hand_mesh_data(Hand p_hand);
+	void start_fetch_task(FetchState p_state);
+	void finish_fetch_task();
+	void wait_for_fetch_task();
+
+	void _load_cache_task();
+	void _build_meshes_task();
+
+	static Ref<ArrayMesh> build_hand_mesh(const MeshData &p_mesh_data);
+
+	String get_mesh_cache_key();
+	bool load_mesh_cache();
+	void save_mesh_cache() const;
 };
 
 #endif // OPENXR_FB_HAND_TRACKING_MESH_EXTENSION_WRAPPER_H
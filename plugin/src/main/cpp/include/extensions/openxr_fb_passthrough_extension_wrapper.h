@@ -38,7 +38,10 @@
 #include <godot_cpp/classes/gradient.hpp>
 #include <godot_cpp/classes/mesh.hpp>
 #include <godot_cpp/classes/open_xr_extension_wrapper_extension.hpp>
+#include <godot_cpp/classes/shader_material.hpp>
 #include <godot_cpp/classes/xr_interface.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
 #include <godot_cpp/templates/rid_owner.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 
@@ -47,6 +50,7 @@
 #include "util.h"
 
 #include <map>
+#include <mutex>
 
 using namespace godot;
 
@@ -110,12 +114,26 @@ public:
 	LayerPurpose get_current_layer_purpose() { return current_passthrough_layer; }
 
 	RID geometry_instance_create(const Array &p_array_mesh, const Transform3D &p_transform);
+	RID geometry_instance_create(const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices, const Transform3D &p_transform);
 	void geometry_instance_set_transform(RID p_geometry_instance, const Transform3D &p_transform);
 	void geometry_instance_free(RID p_geometry_instance);
 
-	RID color_lut_create(OpenXRMetaPassthroughColorLut::ColorLutChannels p_channels, uint32_t p_image_cell_resolution, const PackedByteArray &p_buffer);
+	// Hole punches sharing a mesh and scenario are drawn together, as a single
+	// MultiMesh instance using the shared hole punch material.
+	Ref<ShaderMaterial> get_hole_punch_material();
+	RID hole_punch_create(const Ref<Mesh> &p_mesh, RID p_scenario, const Transform3D &p_transform);
+	void hole_punch_set_transform(RID p_hole_punch, const Transform3D &p_transform);
+	void hole_punch_free(RID p_hole_punch);
+
+	// Color LUTs are shared by content hash, and reference counted. Unreferenced
+	// color LUTs are kept for reuse, up to get_max_unused_color_luts().
+	RID color_lut_acquire(uint64_t p_content_hash);
+	RID color_lut_create(OpenXRMetaPassthroughColorLut::ColorLutChannels p_channels, uint32_t p_image_cell_resolution, const PackedByteArray &p_buffer, uint64_t p_content_hash);
 	void color_lut_free(RID p_color_lut);
 
+	void set_max_unused_color_luts(int p_max_unused_color_luts);
+	int get_max_unused_color_luts() const;
+
 	void set_texture_opacity_factor(float p_value);
 	float get_texture_opacity_factor();
 
@@ -387,16 +405,72 @@ private:
 
 	RID_Owner<GeometryInstance, true> geometry_instances;
 
+	struct GeometryInstanceTransform {
+		RID geometry_instance;
+		Transform3D transform;
+	};
+
+	// Transforms set during the frame, keeping only the last one per geometry instance.
+	// They're handed to the render thread together, once the frame's deferred calls run.
+	HashMap<RID, Transform3D> geometry_instance_transforms;
+	bool geometry_instance_transforms_flush_queued = false;
+
+	std::mutex geometry_instance_transforms_rt_mutex;
+	LocalVector<GeometryInstanceTransform> geometry_instance_transforms_rt;
+
+	void _flush_geometry_instance_transforms();
+
+	Ref<ShaderMaterial> hole_punch_material;
+
+	struct HolePunchBatch {
+		Ref<Mesh> mesh;
+		RID scenario;
+		RID multimesh;
+		RID instance;
+		LocalVector<RID> hole_punches;
+		uint32_t allocated_count = 0;
+		bool dirty = false;
+	};
+
+	struct HolePunch {
+		RID batch;
+		uint32_t index = 0;
+		Transform3D transform;
+	};
+
+	RID_Owner<HolePunchBatch> hole_punch_batches;
+	RID_Owner<HolePunch> hole_punches;
+	LocalVector<RID> hole_punch_batch_list;
+	bool hole_punch_flush_queued = false;
+
+	void _queue_hole_punch_flush(HolePunchBatch *p_batch);
+	void _flush_hole_punches();
+
 	struct ColorLut {
 		XrPassthroughColorLutChannelsMETA channels;
 		uint32_t image_cell_resolution;
 		PackedByteArray buffer;
 
 		XrPassthroughColorLutMETA handle = XR_NULL_HANDLE;
+
+		uint64_t content_hash = 0;
+		uint32_t reference_count = 1;
 	};
 
 	RID_Owner<ColorLut, true> color_luts;
 
+	// Guards the cache, the unused list and the reference counts, since color LUTs
+	// can be freed on the render thread when it holds their last reference.
+	std::mutex color_lut_cache_mutex;
+	HashMap<uint64_t, RID> color_lut_cache;
+	// Least recently used first.
+	LocalVector<RID> unused_color_luts;
+	int max_unused_color_luts = 4;
+
+	// Both expect color_lut_cache_mutex to be locked.
+	RID _color_lut_acquire(uint64_t p_content_hash);
+	void _trim_unused_color_luts();
+
 	void _set_passthrough_started(bool p_started) {
 		passthrough_started = p_started;
 	}
@@ -426,8 +500,8 @@ private:
 	XrPassthroughColorLutMETA _color_lut_get_handle_rt(RID p_color_lut);
 	void _color_lut_free_rt(RID p_color_lut);
 
-	void _geometry_instance_initialize_rt(RID p_geometry_instance, const Array &p_array_mesh, const Transform3D &p_transform);
-	void _geometry_instance_set_transform_rt(RID p_geometry_instance, const Transform3D &p_transform);
+	void _geometry_instance_initialize_rt(RID p_geometry_instance, const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices, const Transform3D &p_transform);
+	void _geometry_instance_set_transforms_rt();
 	void _geometry_instance_free_rt(RID p_geometry_instance);
 };
 
@@ -61,13 +61,20 @@ public:
 
 	static const PackedStringArray &get_supported_semantic_labels();
 
+	// Labels are also represented as bits, following their order in
+	// get_supported_semantic_labels(), so they can be matched as masks.
+	static const int SEMANTIC_LABEL_COUNT = 16;
+
+	static int find_semantic_label(const String &p_label);
+	static uint32_t get_semantic_label_mask(const PackedStringArray &p_labels);
+
 	struct RoomLayout {
 		XrUuidEXT floor;
 		XrUuidEXT ceiling;
 		Vector<XrUuidEXT> walls;
 	};
 
-	PackedStringArray get_semantic_labels(const XrSpace p_space);
+	bool get_semantic_labels(const XrSpace p_space, PackedStringArray &r_labels, uint32_t &r_mask);
 	bool get_room_layout(const XrSpace p_space, RoomLayout &r_room_layout);
 	Rect2 get_bounding_box_2d(const XrSpace p_space);
 	AABB get_bounding_box_3d(const XrSpace p_space);
@@ -104,6 +111,8 @@ private:
 
 	bool initialize_fb_scene_extension(const XrInstance instance);
 
+	static int find_semantic_label(const char *p_label, int p_length);
+
 	HashMap<String, bool *> request_extensions;
 
 	void cleanup();
@@ -33,8 +33,10 @@
 #include <godot_cpp/classes/open_xr_extension_wrapper_extension.hpp>
 #include <godot_cpp/classes/xr_positional_tracker.hpp>
 #include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
 
 #include "util.h"
+#include "uuid_hash_map.h"
 
 using namespace godot;
 
@@ -47,6 +49,7 @@ public:
 
 	void _on_instance_created(uint64_t instance) override;
 	void _on_instance_destroyed() override;
+	void _on_session_destroyed() override;
 	void _on_process() override;
 
 	bool is_spatial_entity_supported() {
@@ -63,9 +66,31 @@ public:
 	bool is_component_enabled(const XrSpace &p_space, XrSpaceComponentTypeFB p_component);
 	bool set_component_enabled(const XrSpace &p_space, XrSpaceComponentTypeFB p_component, bool p_enabled, SetComponentEnabledCallback p_callback, void *p_userdata);
 
-	void track_entity(const StringName &p_name, const XrSpace &p_space);
-	void untrack_entity(const StringName &p_name);
-	bool is_entity_tracked(const StringName &p_name) const;
+	// Component statuses are cached once settled, and kept up to date from
+	// set_component_enabled() completions. Invalidate the cache for a space if
+	// its components may have been changed some other way.
+	void invalidate_component_status(const XrSpace &p_space);
+	void clear_component_status_cache();
+
+	void track_entity(const XrUuidEXT &p_uuid, const XrSpace &p_space);
+	void untrack_entity(const XrUuidEXT &p_uuid);
+	bool is_entity_tracked(const XrUuidEXT &p_uuid) const;
+
+	// Locates a single space in the play space, at the predicted display time.
+	bool locate_space(const XrSpace &p_space, Vector3 &r_position);
+
+	void set_static_entity_update_interval(int p_frames);
+	int get_static_entity_update_interval() const;
+
+	void set_pose_update_threshold(float p_distance);
+	float get_pose_update_threshold() const;
+
+	void set_rotation_update_threshold(float p_angle);
+	float get_rotation_update_threshold() const;
+
+	bool is_locate_spaces_supported() const {
+		return khr_locate_spaces_ext;
+	}
 
 	virtual bool _on_event_polled(const void *event) override;
 
@@ -112,7 +137,13 @@ private:
 			(XrTime), time,
 			(XrSpaceLocation *), location)
 
+	EXT_PROTO_XRRESULT_FUNC3(xrLocateSpacesKHR,
+			(XrSession), session,
+			(const XrSpacesLocateInfo *), locateInfo,
+			(XrSpaceLocations *), spaceLocations)
+
 	bool initialize_fb_spatial_entity_extension(const XrInstance &instance);
+	bool initialize_khr_locate_spaces_extension(const XrInstance &instance);
 	void on_spatial_anchor_created(const XrEventDataSpatialAnchorCreateCompleteFB *event);
 	void on_set_component_enabled_complete(const XrEventDataSpaceSetStatusCompleteFB *event);
 
@@ -144,21 +175,69 @@ private:
 	};
 	HashMap<XrAsyncRequestIdFB, SetComponentEnabledInfo> set_component_enabled_info;
 
+	struct ComponentStatusKey {
+		XrSpace space = XR_NULL_HANDLE;
+		XrSpaceComponentTypeFB component = XR_SPACE_COMPONENT_TYPE_MAX_ENUM_FB;
+
+		bool operator==(const ComponentStatusKey &p_other) const {
+			return space == p_other.space && component == p_other.component;
+		}
+
+		static uint32_t hash(const ComponentStatusKey &p_key) {
+			return hash_murmur3_one_32(uint32_t(p_key.component), hash_murmur3_one_64(uint64_t(p_key.space)));
+		}
+
+		ComponentStatusKey(XrSpace p_space, XrSpaceComponentTypeFB p_component) {
+			space = p_space;
+			component = p_component;
+		}
+
+		ComponentStatusKey() {}
+	};
+	HashMap<ComponentStatusKey, bool, ComponentStatusKey> component_status_cache;
+
 	struct TrackedEntity {
 		XrSpace space = XR_NULL_HANDLE;
 		Ref<XRPositionalTracker> tracker;
 
+		// Last published pose, and whether it was published as tracked.
+		Transform3D published_transform;
+		bool published_tracked = false;
+
+		// Entities whose pose hasn't changed for a while are located less often.
+		uint32_t stable_frames = 0;
+		uint64_t next_locate_frame = 0;
+
 		TrackedEntity(XrSpace p_space) {
 			space = p_space;
 		}
 
 		TrackedEntity(){};
 	};
-	HashMap<StringName, TrackedEntity> tracked_entities;
+	UuidHashMap<TrackedEntity> tracked_entities;
+
+	// Flat list of tracked entities, rebuilt when entities are (un)tracked.
+	// HashMap elements don't move, so the pointers stay valid until erased.
+	LocalVector<TrackedEntity *> tracked_entity_list;
+	bool tracked_entity_list_dirty = false;
+
+	// Per-frame locate buffers, reused between frames.
+	LocalVector<XrSpace> locate_spaces;
+	LocalVector<TrackedEntity *> locate_entities;
+	LocalVector<XrSpaceLocationData> locate_results;
+
+	uint64_t process_frame = 0;
+	int static_entity_update_interval = 10;
+	float pose_update_threshold = 0.0005;
+	float rotation_update_threshold = 0.001;
+
+	void rebuild_tracked_entity_list();
+	void update_tracked_entity(TrackedEntity &p_entity, const XrSpaceLocationData &p_location);
 
 	void cleanup();
 
 	static OpenXRFbSpatialEntityExtensionWrapper *singleton;
 
 	bool fb_spatial_entity_ext = false;
+	bool khr_locate_spaces_ext = false;
 };
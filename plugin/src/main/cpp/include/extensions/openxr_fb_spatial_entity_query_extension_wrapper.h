@@ -55,11 +55,14 @@ public:
 
 	static OpenXRFbSpatialEntityQueryExtensionWrapper *get_singleton();
 
-	typedef void (*QueryCompleteCallback)(const Vector<XrSpaceQueryResultFB> &p_results, void *p_userdata);
+	typedef void (*QueryCompleteCallback)(XrResult p_result, const Vector<XrSpaceQueryResultFB> &p_results, void *p_userdata);
+	typedef void (*QueryResultsCallback)(const XrSpaceQueryResultFB *p_results, uint32_t p_count, void *p_userdata);
 
 	// Attempts to query spatial entities given an XrSpaceQueryInfoFB. The callback will run to
-	// deliver results when they are available.
-	bool query_spatial_entities(const XrSpaceQueryInfoBaseHeaderFB *p_info, QueryCompleteCallback p_callback, void *p_userdata);
+	// deliver all results once the query is complete, or with the failed result if it couldn't be
+	// run. If given, the results callback will also run each time the runtime makes a new page of
+	// results available.
+	bool query_spatial_entities(const XrSpaceQueryInfoBaseHeaderFB *p_info, QueryCompleteCallback p_callback, void *p_userdata, QueryResultsCallback p_results_callback = nullptr);
 
 	OpenXRFbSpatialEntityQueryExtensionWrapper();
 	~OpenXRFbSpatialEntityQueryExtensionWrapper();
@@ -86,13 +89,15 @@ private:
 
 	struct QueryInfo {
 		QueryCompleteCallback callback = nullptr;
+		QueryResultsCallback results_callback = nullptr;
 		void *userdata = nullptr;
 		Vector<XrSpaceQueryResultFB> results;
 
 		QueryInfo() {}
 
-		QueryInfo(QueryCompleteCallback p_callback, void *p_userdata) {
+		QueryInfo(QueryCompleteCallback p_callback, QueryResultsCallback p_results_callback, void *p_userdata) {
 			callback = p_callback;
+			results_callback = p_results_callback;
 			userdata = p_userdata;
 		}
 	};
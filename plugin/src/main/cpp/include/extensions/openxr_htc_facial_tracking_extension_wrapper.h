@@ -36,6 +36,7 @@
 #include <godot_cpp/variant/utility_functions.hpp>
 #include <map>
 
+#include "face_expression_mapper.h"
 #include "util.h"
 
 using namespace godot;
@@ -104,6 +105,9 @@ private:
 
 	// Godot XRFaceTracker instance.
 	Ref<XRFaceTracker> xr_face_tracker;
+
+	// Maps HTC weights to Godot weights, holding inactive trackers.
+	FaceExpressionMapper face_mapper;
 };
 
 #endif // OPENXR_HTC_FACIAL_TRACKING_EXTENSION_WRAPPER_H
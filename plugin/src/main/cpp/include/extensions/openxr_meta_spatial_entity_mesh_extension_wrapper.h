@@ -58,6 +58,10 @@ public:
 
 	bool get_triangle_mesh(const XrSpace &p_space, TriangleMesh &r_triangle_mesh);
 
+	// Same as get_triangle_mesh(), but without checking that the component is
+	// enabled, so it's safe to call from worker threads.
+	bool fetch_triangle_mesh(const XrSpace &p_space, TriangleMesh &r_triangle_mesh);
+
 	static OpenXRMetaSpatialEntityMeshExtensionWrapper *get_singleton();
 
 	OpenXRMetaSpatialEntityMeshExtensionWrapper();
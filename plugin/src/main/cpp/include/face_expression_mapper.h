@@ -0,0 +1,136 @@
+/**************************************************************************/
+/*  face_expression_mapper.h                                              */
+/**************************************************************************/
+/*                       This file is part of:                            */
+/*                              GODOT XR                                  */
+/*                      https://godotengine.org                           */
+/**************************************************************************/
+/* Copyright (c) 2022-present Godot XR contributors (see CONTRIBUTORS.md) */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef FACE_EXPRESSION_MAPPER_H
+#define FACE_EXPRESSION_MAPPER_H
+
+#include <godot_cpp/classes/xr_face_tracker.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+
+using namespace godot;
+
+// Data-driven mapping of runtime face expression weights to Godot
+// XRFaceTracker blend shapes, shared by the face tracking wrappers.
+//
+// A mapping is described by a list of terms, each adding a weighted runtime
+// expression to a blend shape. The list is expanded at compile time into a
+// fixed-width matrix so every blend shape is evaluated with the same
+// branch-free multiply-add sequence.
+class FaceExpressionMapper {
+public:
+	// Maximum number of terms contributing to a single blend shape.
+	static constexpr int MAX_TERMS = 4;
+
+	// Maximum number of confidence regions (groups of expressions that are
+	// updated or held together).
+	static constexpr int MAX_REGIONS = 2;
+
+	// Default minimum change for a blend shape to be published again.
+	static constexpr float DEFAULT_CHANGE_EPSILON = 0.0001f;
+
+	// Adds weight * source expression to a blend shape.
+	struct Term {
+		XRFaceTracker::BlendShapeEntry xr_shape;
+		uint8_t source;
+		float weight;
+	};
+
+	// Returns the region of a source expression.
+	typedef uint8_t (*RegionFunc)(uint8_t p_source);
+
+	struct Mapping {
+		uint8_t source[XRFaceTracker::FT_MAX][MAX_TERMS];
+		float weight[XRFaceTracker::FT_MAX][MAX_TERMS];
+		uint8_t region[XRFaceTracker::FT_MAX];
+	};
+
+	template <size_t N>
+	static constexpr bool terms_fit(const Term (&p_terms)[N], RegionFunc p_region) {
+		int counts[XRFaceTracker::FT_MAX] = {};
+		for (const Term &term : p_terms) {
+			if (++counts[term.xr_shape] > MAX_TERMS || p_region(term.source) >= MAX_REGIONS) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	template <size_t N>
+	static constexpr Mapping build_mapping(const Term (&p_terms)[N], RegionFunc p_region) {
+		Mapping mapping = {};
+		int counts[XRFaceTracker::FT_MAX] = {};
+		for (const Term &term : p_terms) {
+			const int slot = counts[term.xr_shape]++;
+			mapping.source[term.xr_shape][slot] = term.source;
+			mapping.weight[term.xr_shape][slot] = term.weight;
+			mapping.region[term.xr_shape] = p_region(term.source);
+		}
+		return mapping;
+	}
+
+	void set_change_epsilon(float p_epsilon) { change_epsilon = p_epsilon; }
+	float get_change_epsilon() const { return change_epsilon; }
+
+	// Evaluates the mapping over the runtime weights into the back buffer, in
+	// place. Blend shapes of invalid regions hold their previous values.
+	// Returns true if any blend shape moved by more than the change epsilon
+	// since the last publish.
+	bool update(const Mapping &p_mapping, const float *p_source_weights, const bool *p_region_valid);
+
+	// Publishes the changed blend shapes to the tracker.
+	void publish(const Ref<XRFaceTracker> &p_tracker);
+
+	// Clears all held blend shapes, and forces a full publish.
+	void reset();
+
+	const float *get_weights() const { return back; }
+
+private:
+	// Dirty ranges up to this many blend shapes are pushed one at a time,
+	// larger ones go through a single bulk update.
+	static constexpr int MAX_SPARSE_PUBLISH = 16;
+
+	// Back buffer, written by update(), and front buffer, mirroring the
+	// weights the tracker currently holds.
+	float back[XRFaceTracker::FT_MAX] = {};
+	float front[XRFaceTracker::FT_MAX] = {};
+
+	// Dirty blend shapes since the last publish, as [dirty_begin, dirty_end).
+	int dirty_begin = 0;
+	int dirty_end = 0;
+	int dirty_count = 0;
+	bool publish_all = true;
+
+	float change_epsilon = DEFAULT_CHANGE_EPSILON;
+
+	// Persistent bulk publish buffer, so publishing doesn't allocate.
+	PackedFloat32Array published_weights;
+};
+
+#endif // FACE_EXPRESSION_MAPPER_H
@@ -0,0 +1,109 @@
+/**************************************************************************/
+/*  pose_history.h                                                        */
+/**************************************************************************/
+/*                       This file is part of:                            */
+/*                              GODOT XR                                  */
+/*                      https://godotengine.org                           */
+/**************************************************************************/
+/* Copyright (c) 2022-present Godot XR contributors (see CONTRIBUTORS.md) */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef POSE_HISTORY_H
+#define POSE_HISTORY_H
+
+#include <openxr/openxr.h>
+
+#include <godot_cpp/core/math.hpp>
+#include <godot_cpp/variant/quaternion.hpp>
+#include <godot_cpp/variant/vector3.hpp>
+
+using namespace godot;
+
+// Rotation from p_from to p_to, as an axis scaled by the angle in radians.
+static inline Vector3 rotation_delta(const Quaternion &p_from, const Quaternion &p_to) {
+	Quaternion delta = p_to * p_from.inverse();
+	if (delta.w < 0.0) {
+		delta = -delta;
+	}
+
+	const Vector3 axis = Vector3(delta.x, delta.y, delta.z);
+	const real_t sin_half_angle = axis.length();
+	if (sin_half_angle < CMP_EPSILON) {
+		return Vector3();
+	}
+
+	const real_t angle = 2.0 * Math::atan2(sin_half_angle, delta.w);
+	return axis * (angle / sin_half_angle);
+}
+
+// Ring of the most recent timestamped poses of a tracked object, used to
+// estimate its velocities by finite differences.
+struct PoseHistory {
+	static constexpr uint32_t SIZE = 4;
+
+	Vector3 positions[SIZE];
+	Quaternion orientations[SIZE];
+	XrTime times[SIZE] = {};
+	uint32_t head = 0;
+	uint32_t count = 0;
+
+	void clear() {
+		count = 0;
+	}
+
+	// Adds a pose, unless it isn't newer than the latest one (for example, the
+	// same frame processed twice). Returns true if the pose was added.
+	bool push(const Vector3 &p_position, const Quaternion &p_orientation, XrTime p_time) {
+		if (p_time == 0 || (count > 0 && p_time <= times[head])) {
+			return false;
+		}
+
+		head = (head + 1) % SIZE;
+		positions[head] = p_position;
+		orientations[head] = p_orientation;
+		times[head] = p_time;
+		if (count < SIZE) {
+			count++;
+		}
+		return true;
+	}
+
+	// Velocities between the oldest and newest poses. Returns false, leaving the
+	// outputs untouched, until the history spans some time.
+	bool get_velocities(Vector3 &r_linear_velocity, Vector3 &r_angular_velocity) const {
+		if (count < 2) {
+			return false;
+		}
+
+		const uint32_t oldest = (head + SIZE - (count - 1)) % SIZE;
+		const real_t span = real_t(times[head] - times[oldest]) * 1e-9;
+		if (span <= 0.0) {
+			return false;
+		}
+
+		r_linear_velocity = (positions[head] - positions[oldest]) / span;
+		r_angular_velocity = rotation_delta(orientations[oldest], orientations[head]) / span;
+		return true;
+	}
+};
+
+#endif // POSE_HISTORY_H
@@ -0,0 +1,125 @@
+/**************************************************************************/
+/*  scene_anchor_bvh.h                                                    */
+/**************************************************************************/
+/*                       This file is part of:                            */
+/*                              GODOT XR                                  */
+/*                      https://godotengine.org                           */
+/**************************************************************************/
+/* Copyright (c) 2022-present Godot XR contributors (see CONTRIBUTORS.md) */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SCENE_ANCHOR_BVH_H
+#define SCENE_ANCHOR_BVH_H
+
+#include <openxr/openxr.h>
+
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/variant/aabb.hpp>
+#include <godot_cpp/variant/transform3d.hpp>
+
+using namespace godot;
+
+// Bounding volume hierarchy over scene anchors, for ray and proximity queries.
+//
+// Each item is an anchor's bounding box (in the anchor's own space) and its
+// current pose. Items are placed in the tree once they have a pose. Adding or
+// removing items rebuilds the tree on the next query, while pose changes only
+// refit the bounds from the item's leaf up to the root.
+class SceneAnchorBVH {
+public:
+	struct RayHit {
+		int32_t item = -1;
+		float distance = 0.0;
+		Vector3 position;
+		Vector3 normal;
+	};
+
+	// Returns the id of the new item, which stays valid until it's removed.
+	int32_t add_item(const XrUuidEXT &p_uuid, const AABB &p_bounds, uint32_t p_label_mask);
+	void remove_item(int32_t p_item);
+	void set_item_transform(int32_t p_item, const Transform3D &p_transform);
+	const XrUuidEXT &get_item_uuid(int32_t p_item) const;
+	void clear();
+
+	// Finds the closest item hit by the ray, within p_max_distance.
+	// p_direction must be normalized. Items match if they have any of the labels
+	// in p_label_mask, or always if it's 0.
+	bool raycast(const Vector3 &p_from, const Vector3 &p_direction, float p_max_distance, uint32_t p_label_mask, RayHit &r_hit);
+	// Finds all items within p_radius of p_center.
+	void sphere_overlap(const Vector3 &p_center, float p_radius, uint32_t p_label_mask, LocalVector<int32_t> &r_items);
+	// Finds the p_count items closest to p_point, nearest first.
+	void nearest(const Vector3 &p_point, int p_count, uint32_t p_label_mask, LocalVector<int32_t> &r_items);
+
+private:
+	struct Item {
+		XrUuidEXT uuid = {};
+		AABB local_bounds;
+		uint32_t label_mask = 0;
+		Transform3D transform;
+		Transform3D inverse;
+		AABB bounds;
+		int32_t leaf = -1;
+		bool used = false;
+		bool placed = false;
+	};
+
+	struct Node {
+		AABB bounds;
+		int32_t parent = -1;
+		// Inner nodes have two children, leaves have a range of leaf_items.
+		int32_t left = -1;
+		int32_t right = -1;
+		uint32_t first = 0;
+		uint32_t count = 0;
+	};
+
+	struct CentroidComparator {
+		const Item *items = nullptr;
+		int axis = 0;
+
+		_FORCE_INLINE_ bool operator()(int32_t p_a, int32_t p_b) const {
+			return items[p_a].bounds.get_center()[axis] < items[p_b].bounds.get_center()[axis];
+		}
+	};
+
+	static const uint32_t MAX_LEAF_ITEMS = 4;
+
+	LocalVector<Item> items;
+	LocalVector<int32_t> free_items;
+	LocalVector<Node> nodes;
+	LocalVector<int32_t> leaf_items;
+	int32_t root = -1;
+	bool needs_rebuild = false;
+
+	void update();
+	void rebuild();
+	int32_t build_node(uint32_t p_begin, uint32_t p_end, int32_t p_parent);
+	void refit_node(int32_t p_node);
+
+	bool matches(const Item &p_item, uint32_t p_label_mask) const;
+	float get_item_distance(const Item &p_item, const Vector3 &p_point) const;
+
+	static float get_aabb_distance(const AABB &p_aabb, const Vector3 &p_point);
+	static bool intersect_ray_aabb(const AABB &p_aabb, const Vector3 &p_from, const Vector3 &p_direction, float p_max_distance, float &r_distance, int &r_axis);
+};
+
+#endif
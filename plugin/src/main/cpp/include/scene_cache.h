@@ -0,0 +1,111 @@
+/**************************************************************************/
+/*  scene_cache.h                                                         */
+/**************************************************************************/
+/*                       This file is part of:                            */
+/*                              GODOT XR                                  */
+/*                      https://godotengine.org                           */
+/**************************************************************************/
+/* Copyright (c) 2022-present Godot XR contributors (see CONTRIBUTORS.md) */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SCENE_CACHE_H
+#define SCENE_CACHE_H
+
+#include <openxr/openxr.h>
+
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/templates/vector.hpp>
+#include <godot_cpp/variant/aabb.hpp>
+#include <godot_cpp/variant/packed_string_array.hpp>
+#include <godot_cpp/variant/packed_vector2_array.hpp>
+#include <godot_cpp/variant/rect2.hpp>
+#include <godot_cpp/variant/transform3d.hpp>
+
+#include "uuid_hash_map.h"
+
+using namespace godot;
+
+// On-disk snapshot of the scene data of each room, keyed by the room layouts
+// it spans (see make_room_key()), so scene anchors can be instantiated before
+// the runtime has answered any queries.
+//
+// The file holds the MAX_ROOMS most recently captured rooms, least recent
+// first. It's small enough to be read and written as a whole.
+class SceneCache {
+public:
+	struct EntityData {
+		// Bitmask of the enabled OpenXRFbSpatialEntity::ComponentType values.
+		uint32_t components = 0;
+		PackedStringArray semantic_labels;
+		Rect2 bounding_box_2d;
+		AABB bounding_box_3d;
+		PackedVector2Array boundary_2d;
+		// Triangle mesh, as returned by the runtime.
+		Vector<XrVector3f> mesh_vertices;
+		Vector<uint32_t> mesh_indices;
+		// Last known transform of the anchor, relative to the XROrigin3D.
+		Transform3D pose;
+		bool has_pose = false;
+
+		bool has_same_geometry(const EntityData &p_other) const;
+	};
+
+	typedef UuidHashMap<EntityData> Room;
+
+	// Oldest rooms are evicted past this count.
+	static const uint32_t MAX_ROOMS = 8;
+
+	// Key of the room made up of the given room layouts. That's the UUID of
+	// the room layout if there's only one, otherwise it's derived from all of
+	// them, regardless of their order.
+	static XrUuidEXT make_room_key(const LocalVector<XrUuidEXT> &p_room_layouts);
+
+	// Loads the cache from the given path, which is also used by save().
+	// A missing file gives an empty cache.
+	Error load(const String &p_path);
+	Error save();
+	void clear();
+
+	bool is_dirty() const { return dirty; }
+	const String &get_path() const { return path; }
+
+	bool get_last_room(XrUuidEXT &r_uuid) const;
+	const Room *get_room(const XrUuidEXT &p_uuid) const;
+	// Replaces the data of a room, and marks it as the last room.
+	// Evicts the least recently set rooms past MAX_ROOMS.
+	void set_room(const XrUuidEXT &p_uuid, const Room &p_room);
+	void erase_room(const XrUuidEXT &p_uuid);
+	void set_entity_pose(const XrUuidEXT &p_room, const XrUuidEXT &p_entity, const Transform3D &p_pose);
+
+private:
+	static const uint32_t VERSION = 1;
+
+	void _evict_rooms();
+
+	UuidHashMap<Room> rooms;
+	XrUuidEXT last_room = {};
+	bool has_last_room = false;
+	String path;
+	bool dirty = false;
+};
+
+#endif
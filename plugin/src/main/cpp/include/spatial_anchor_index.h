@@ -0,0 +1,139 @@
+/**************************************************************************/
+/*  spatial_anchor_index.h                                                */
+/**************************************************************************/
+/*                       This file is part of:                            */
+/*                              GODOT XR                                  */
+/*                      https://godotengine.org                           */
+/**************************************************************************/
+/* Copyright (c) 2022-present Godot XR contributors (see CONTRIBUTORS.md) */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SPATIAL_ANCHOR_INDEX_H
+#define SPATIAL_ANCHOR_INDEX_H
+
+#include <openxr/openxr.h>
+
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/transform3d.hpp>
+
+#include "uuid_hash_map.h"
+
+using namespace godot;
+
+// Persistent index of spatial anchor metadata, keyed by the anchor's 128-bit
+// UUID, so anchors can be restored before the runtime has loaded them.
+//
+// The file is a header followed by a table of fixed-size slots and a data
+// region. Slots hold the UUID, the last known pose and the location of the
+// anchor's data (scene path and custom data) in the data region, so the
+// whole table can be read with a single copy. Changes are written back in
+// place: pose updates only touch the pose of a slot, and data that no longer
+// fits its old location is appended to the data region. The file is only
+// rewritten from scratch when the slot table is full, or once most of the data
+// region is unused.
+class SpatialAnchorIndex {
+public:
+	struct Record {
+		Transform3D pose;
+		String scene_path;
+		Dictionary custom_data;
+	};
+
+	// Loads the index from the given path, which is also used by flush().
+	// A missing file gives an empty index.
+	Error load(const String &p_path);
+
+	// Writes all changes since the last load or flush to disk.
+	Error flush();
+
+	void clear();
+
+	bool is_dirty() const { return dirty; }
+	const String &get_path() const { return path; }
+
+	bool has_record(const XrUuidEXT &p_uuid) const;
+	const Record *get_record(const XrUuidEXT &p_uuid) const;
+	Array get_uuids() const;
+	Dictionary get_all_custom_data() const;
+
+	void set_record(const XrUuidEXT &p_uuid, const Transform3D &p_pose, const String &p_scene_path, const Dictionary &p_custom_data);
+	void set_pose(const XrUuidEXT &p_uuid, const Transform3D &p_pose);
+	void erase_record(const XrUuidEXT &p_uuid);
+
+private:
+	static constexpr uint32_t VERSION = 1;
+	static constexpr uint32_t MIN_SLOT_CAPACITY = 32;
+	static constexpr uint32_t INVALID_SLOT = UINT32_MAX;
+	static constexpr uint32_t SLOT_FLAG_USED = 1;
+
+	struct Header {
+		char magic[4];
+		uint32_t version;
+		uint32_t slot_capacity;
+		uint32_t reserved;
+	};
+
+	struct Slot {
+		uint8_t uuid[16];
+		uint32_t flags;
+		float pose[12];
+		uint32_t data_offset;
+		uint32_t data_size;
+		uint32_t reserved;
+	};
+
+	struct Entry {
+		Record record;
+		uint32_t slot = INVALID_SLOT;
+		uint32_t data_offset = 0;
+		uint32_t data_size = 0;
+		bool pose_dirty = false;
+		bool data_dirty = false;
+	};
+
+	String path;
+	UuidHashMap<Entry> entries;
+
+	uint32_t slot_capacity = 0;
+	LocalVector<uint32_t> free_slots;
+	LocalVector<uint32_t> erased_slots;
+
+	// End of the data region, and the number of bytes in it no record uses.
+	uint32_t data_end = 0;
+	uint32_t unused_data = 0;
+
+	bool dirty = false;
+	bool needs_rewrite = true;
+
+	uint32_t get_data_start() const { return sizeof(Header) + slot_capacity * sizeof(Slot); }
+
+	static void encode_pose(const Transform3D &p_pose, float *r_pose);
+	static Transform3D decode_pose(const float *p_pose);
+	static PackedByteArray encode_data(const Record &p_record);
+
+	void fill_slot(const XrUuidEXT &p_uuid, const Entry &p_entry, Slot &r_slot) const;
+	Error rewrite();
+};
+
+#endif // SPATIAL_ANCHOR_INDEX_H
@@ -30,6 +30,7 @@
 #ifndef UTIL_H
 #define UTIL_H
 
+#include <godot_cpp/variant/string.hpp>
 #include <godot_cpp/variant/string_name.hpp>
 
 struct XrUuid;
@@ -126,7 +127,16 @@ struct XrMatrix4x4f;
 #define SESSION (XrSession) get_openxr_api()->get_session()
 
 namespace OpenXRUtilities {
+// Length of a UUID formatted as text, not including the terminating null.
+constexpr int UUID_STRING_LENGTH = 36;
+
+// Formats a UUID as "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx" into the given buffer,
+// which must hold at least UUID_STRING_LENGTH + 1 characters.
+void uuid_to_chars(const XrUuid &p_uuid, char *r_chars);
 godot::StringName uuid_to_string_name(const XrUuid &p_uuid);
+
+// Parses a UUID of 32 hex digits, optionally separated by dashes.
+bool string_to_uuid(const godot::String &p_string, XrUuid &r_uuid);
 void xrMatrix4x4f_to_godot_projection(XrMatrix4x4f *m, godot::Projection &p);
 }; //namespace OpenXRUtilities
 
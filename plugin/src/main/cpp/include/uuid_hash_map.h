@@ -0,0 +1,64 @@
+/**************************************************************************/
+/*  uuid_hash_map.h                                                       */
+/**************************************************************************/
+/*                       This file is part of:                            */
+/*                              GODOT XR                                  */
+/*                      https://godotengine.org                           */
+/**************************************************************************/
+/* Copyright (c) 2022-present Godot XR contributors (see CONTRIBUTORS.md) */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef UUID_HASH_MAP_H
+#define UUID_HASH_MAP_H
+
+#include <openxr/openxr.h>
+
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/hashfuncs.hpp>
+
+#include <cstring>
+
+using namespace godot;
+
+// Hashes and compares UUIDs as two 64-bit words, so spatial entities can be
+// looked up by their binary UUID without formatting or interning strings.
+struct UuidHasher {
+	static _FORCE_INLINE_ uint32_t hash(const XrUuidEXT &p_uuid) {
+		uint64_t words[2];
+		memcpy(words, p_uuid.data, sizeof(words));
+		uint32_t h = hash_murmur3_one_64(words[0]);
+		h = hash_murmur3_one_64(words[1], h);
+		return hash_fmix32(h);
+	}
+};
+
+struct UuidComparator {
+	static _FORCE_INLINE_ bool compare(const XrUuidEXT &p_lhs, const XrUuidEXT &p_rhs) {
+		return memcmp(p_lhs.data, p_rhs.data, XR_UUID_SIZE_EXT) == 0;
+	}
+};
+
+// HashMap is open-addressing (Robin Hood hashing), so this only needs the UUID hasher.
+template <typename TValue>
+using UuidHashMap = HashMap<XrUuidEXT, TValue, UuidHasher, UuidComparator>;
+
+#endif // UUID_HASH_MAP_H
@@ -0,0 +1,392 @@
+/**************************************************************************/
+/*  scene_anchor_bvh.cpp                                                  */
+/**************************************************************************/
+/*                       This file is part of:                            */
+/*                              GODOT XR                                  */
+/*                      https://godotengine.org                           */
+/**************************************************************************/
+/* Copyright (c) 2022-present Godot XR contributors (see CONTRIBUTORS.md) */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "scene_anchor_bvh.h"
+
+#include <godot_cpp/templates/sort_array.hpp>
+
+int32_t SceneAnchorBVH::add_item(const XrUuidEXT &p_uuid, const AABB &p_bounds, uint32_t p_label_mask) {
+	int32_t index;
+	if (free_items.is_empty()) {
+		index = items.size();
+		items.push_back(Item());
+	} else {
+		index = free_items[free_items.size() - 1];
+		free_items.resize(free_items.size() - 1);
+	}
+
+	Item &item = items[index];
+	item = Item();
+	item.uuid = p_uuid;
+	item.local_bounds = p_bounds;
+	item.label_mask = p_label_mask;
+	item.used = true;
+
+	// The item is only placed in the tree once it has a pose.
+	return index;
+}
+
+void SceneAnchorBVH::remove_item(int32_t p_item) {
+	ERR_FAIL_INDEX(p_item, (int32_t)items.size());
+	Item &item = items[p_item];
+	ERR_FAIL_COND(!item.used);
+
+	if (item.placed) {
+		needs_rebuild = true;
+	}
+
+	item = Item();
+	free_items.push_back(p_item);
+}
+
+void SceneAnchorBVH::set_item_transform(int32_t p_item, const Transform3D &p_transform) {
+	ERR_FAIL_INDEX(p_item, (int32_t)items.size());
+	Item &item = items[p_item];
+	ERR_FAIL_COND(!item.used);
+
+	item.transform = p_transform;
+	item.inverse = p_transform.affine_inverse();
+	item.bounds = p_transform.xform(item.local_bounds);
+
+	if (!item.placed) {
+		item.placed = true;
+		needs_rebuild = true;
+	} else if (!needs_rebuild && item.leaf >= 0) {
+		refit_node(item.leaf);
+	}
+}
+
+const XrUuidEXT &SceneAnchorBVH::get_item_uuid(int32_t p_item) const {
+	static const XrUuidEXT empty_uuid = {};
+	ERR_FAIL_INDEX_V(p_item, (int32_t)items.size(), empty_uuid);
+	return items[p_item].uuid;
+}
+
+void SceneAnchorBVH::clear() {
+	items.clear();
+	free_items.clear();
+	nodes.clear();
+	leaf_items.clear();
+	root = -1;
+	needs_rebuild = false;
+}
+
+void SceneAnchorBVH::update() {
+	if (needs_rebuild) {
+		rebuild();
+	}
+}
+
+void SceneAnchorBVH::rebuild() {
+	nodes.clear();
+	leaf_items.clear();
+	root = -1;
+	needs_rebuild = false;
+
+	for (uint32_t i = 0; i < items.size(); i++) {
+		items[i].leaf = -1;
+		if (items[i].used && items[i].placed) {
+			leaf_items.push_back(i);
+		}
+	}
+
+	if (leaf_items.is_empty()) {
+		return;
+	}
+
+	nodes.reserve(2 * (leaf_items.size() / MAX_LEAF_ITEMS + 1));
+	root = build_node(0, leaf_items.size(), -1);
+}
+
+int32_t SceneAnchorBVH::build_node(uint32_t p_begin, uint32_t p_end, int32_t p_parent) {
+	const int32_t index = nodes.size();
+	nodes.push_back(Node());
+	nodes[index].parent = p_parent;
+
+	AABB bounds = items[leaf_items[p_begin]].bounds;
+	AABB centroid_bounds(bounds.get_center(), Vector3());
+	for (uint32_t i = p_begin + 1; i < p_end; i++) {
+		const AABB &item_bounds = items[leaf_items[i]].bounds;
+		bounds.merge_with(item_bounds);
+		centroid_bounds.expand_to(item_bounds.get_center());
+	}
+	nodes[index].bounds = bounds;
+
+	if (p_end - p_begin <= MAX_LEAF_ITEMS) {
+		nodes[index].first = p_begin;
+		nodes[index].count = p_end - p_begin;
+		for (uint32_t i = p_begin; i < p_end; i++) {
+			items[leaf_items[i]].leaf = index;
+		}
+		return index;
+	}
+
+	// Split at the median centroid along the longest axis.
+	SortArray<int32_t, CentroidComparator> sorter;
+	sorter.compare.items = items.ptr();
+	sorter.compare.axis = centroid_bounds.get_longest_axis_index();
+	sorter.sort(leaf_items.ptr() + p_begin, p_end - p_begin);
+
+	const uint32_t middle = (p_begin + p_end) / 2;
+	const int32_t left = build_node(p_begin, middle, index);
+	const int32_t right = build_node(middle, p_end, index);
+	nodes[index].left = left;
+	nodes[index].right = right;
+
+	return index;
+}
+
+void SceneAnchorBVH::refit_node(int32_t p_node) {
+	for (int32_t n = p_node; n >= 0; n = nodes[n].parent) {
+		Node &node = nodes[n];
+		if (node.left < 0) {
+			AABB bounds = items[leaf_items[node.first]].bounds;
+			for (uint32_t i = node.first + 1; i < node.first + node.count; i++) {
+				bounds.merge_with(items[leaf_items[i]].bounds);
+			}
+			node.bounds = bounds;
+		} else {
+			node.bounds = nodes[node.left].bounds.merge(nodes[node.right].bounds);
+		}
+	}
+}
+
+bool SceneAnchorBVH::matches(const Item &p_item, uint32_t p_label_mask) const {
+	return p_label_mask == 0 || (p_item.label_mask & p_label_mask) != 0;
+}
+
+float SceneAnchorBVH::get_item_distance(const Item &p_item, const Vector3 &p_point) const {
+	// Measure against the oriented bounds, in the item's own space.
+	const Vector3 local_point = p_item.inverse.xform(p_point);
+	const Vector3 closest = local_point.clamp(p_item.local_bounds.position, p_item.local_bounds.get_end());
+	return p_item.transform.basis.xform(local_point - closest).length();
+}
+
+float SceneAnchorBVH::get_aabb_distance(const AABB &p_aabb, const Vector3 &p_point) {
+	return p_point.distance_to(p_point.clamp(p_aabb.position, p_aabb.get_end()));
+}
+
+bool SceneAnchorBVH::intersect_ray_aabb(const AABB &p_aabb, const Vector3 &p_from, const Vector3 &p_direction, float p_max_distance, float &r_distance, int &r_axis) {
+	float t_near = 0.0;
+	float t_far = p_max_distance;
+	int axis = -1;
+
+	for (int i = 0; i < 3; i++) {
+		const float low = p_aabb.position[i];
+		const float high = low + p_aabb.size[i];
+
+		if (Math::is_zero_approx(p_direction[i])) {
+			if (p_from[i] < low || p_from[i] > high) {
+				return false;
+			}
+			continue;
+		}
+
+		const float inverse_direction = 1.0 / p_direction[i];
+		float t0 = (low - p_from[i]) * inverse_direction;
+		float t1 = (high - p_from[i]) * inverse_direction;
+		if (t0 > t1) {
+			SWAP(t0, t1);
+		}
+
+		if (t0 > t_near) {
+			t_near = t0;
+			axis = i;
+		}
+		if (t1 < t_far) {
+			t_far = t1;
+		}
+		if (t_near > t_far) {
+			return false;
+		}
+	}
+
+	r_distance = t_near;
+	r_axis = axis;
+	return true;
+}
+
+bool SceneAnchorBVH::raycast(const Vector3 &p_from, const Vector3 &p_direction, float p_max_distance, uint32_t p_label_mask, RayHit &r_hit) {
+	update();
+	if (root < 0) {
+		return false;
+	}
+
+	float closest = p_max_distance;
+	bool hit = false;
+
+	LocalVector<int32_t> stack;
+	stack.push_back(root);
+
+	while (!stack.is_empty()) {
+		const Node &node = nodes[stack[stack.size() - 1]];
+		stack.resize(stack.size() - 1);
+
+		float distance;
+		int axis;
+		if (!intersect_ray_aabb(node.bounds, p_from, p_direction, closest, distance, axis)) {
+			continue;
+		}
+
+		if (node.left >= 0) {
+			stack.push_back(node.left);
+			stack.push_back(node.right);
+			continue;
+		}
+
+		for (uint32_t i = node.first; i < node.first + node.count; i++) {
+			const int32_t item_index = leaf_items[i];
+			const Item &item = items[item_index];
+			if (!matches(item, p_label_mask)) {
+				continue;
+			}
+
+			// Test against the oriented bounds, in the item's own space.
+			const Vector3 local_from = item.inverse.xform(p_from);
+			const Vector3 local_direction = item.inverse.basis.xform(p_direction);
+			if (!intersect_ray_aabb(item.local_bounds, local_from, local_direction, closest, distance, axis)) {
+				continue;
+			}
+
+			closest = distance;
+			hit = true;
+
+			r_hit.item = item_index;
+			r_hit.distance = distance;
+			r_hit.position = p_from + p_direction * distance;
+			if (axis < 0) {
+				// The ray starts inside the bounds.
+				r_hit.normal = -p_direction;
+			} else {
+				Vector3 local_normal;
+				local_normal[axis] = local_direction[axis] > 0.0 ? -1.0 : 1.0;
+				r_hit.normal = item.transform.basis.xform(local_normal).normalized();
+			}
+		}
+	}
+
+	return hit;
+}
+
+void SceneAnchorBVH::sphere_overlap(const Vector3 &p_center, float p_radius, uint32_t p_label_mask, LocalVector<int32_t> &r_items) {
+	r_items.clear();
+
+	update();
+	if (root < 0) {
+		return;
+	}
+
+	LocalVector<int32_t> stack;
+	stack.push_back(root);
+
+	while (!stack.is_empty()) {
+		const Node &node = nodes[stack[stack.size() - 1]];
+		stack.resize(stack.size() - 1);
+
+		if (get_aabb_distance(node.bounds, p_center) > p_radius) {
+			continue;
+		}
+
+		if (node.left >= 0) {
+			stack.push_back(node.left);
+			stack.push_back(node.right);
+			continue;
+		}
+
+		for (uint32_t i = node.first; i < node.first + node.count; i++) {
+			const Item &item = items[leaf_items[i]];
+			if (matches(item, p_label_mask) && get_item_distance(item, p_center) <= p_radius) {
+				r_items.push_back(leaf_items[i]);
+			}
+		}
+	}
+}
+
+void SceneAnchorBVH::nearest(const Vector3 &p_point, int p_count, uint32_t p_label_mask, LocalVector<int32_t> &r_items) {
+	r_items.clear();
+
+	update();
+	if (root < 0 || p_count <= 0) {
+		return;
+	}
+
+	// Distances of the items found so far, nearest first.
+	LocalVector<float> distances;
+
+	LocalVector<int32_t> stack;
+	stack.push_back(root);
+
+	while (!stack.is_empty()) {
+		const Node &node = nodes[stack[stack.size() - 1]];
+		stack.resize(stack.size() - 1);
+
+		const bool full = distances.size() == (uint32_t)p_count;
+		if (full && get_aabb_distance(node.bounds, p_point) >= distances[distances.size() - 1]) {
+			continue;
+		}
+
+		if (node.left >= 0) {
+			// Visit the nearer child first, so more of the tree can be skipped.
+			const float left_distance = get_aabb_distance(nodes[node.left].bounds, p_point);
+			const float right_distance = get_aabb_distance(nodes[node.right].bounds, p_point);
+			if (left_distance < right_distance) {
+				stack.push_back(node.right);
+				stack.push_back(node.left);
+			} else {
+				stack.push_back(node.left);
+				stack.push_back(node.right);
+			}
+			continue;
+		}
+
+		for (uint32_t i = node.first; i < node.first + node.count; i++) {
+			const Item &item = items[leaf_items[i]];
+			if (!matches(item, p_label_mask)) {
+				continue;
+			}
+
+			const float distance = get_item_distance(item, p_point);
+			if (distances.size() == (uint32_t)p_count && distance >= distances[distances.size() - 1]) {
+				continue;
+			}
+
+			uint32_t position = distances.size();
+			while (position > 0 && distances[position - 1] > distance) {
+				position--;
+			}
+			distances.insert(position, distance);
+			r_items.insert(position, leaf_items[i]);
+
+			if (distances.size() > (uint32_t)p_count) {
+				distances.resize(p_count);
+				r_items.resize(p_count);
+			}
+		}
+	}
+}
@@ -0,0 +1,400 @@
+/**************************************************************************/
+/*  scene_cache.cpp                                                       */
+/**************************************************************************/
+/*                       This file is part of:                            */
+/*                              GODOT XR                                  */
+/*                      https://godotengine.org                           */
+/**************************************************************************/
+/* Copyright (c) 2022-present Godot XR contributors (see CONTRIBUTORS.md) */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "scene_cache.h"
+
+#include <godot_cpp/classes/dir_access.hpp>
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/templates/hashfuncs.hpp>
+
+static const char cache_magic[4] = { 'F', 'B', 'S', 'C' };
+
+enum {
+	CACHE_FLAG_HAS_LAST_ROOM = 1 << 0,
+};
+
+enum {
+	ENTITY_FLAG_HAS_POSE = 1 << 0,
+};
+
+static void store_uuid(const Ref<FileAccess> &p_file, const XrUuidEXT &p_uuid) {
+	PackedByteArray bytes;
+	bytes.resize(XR_UUID_SIZE_EXT);
+	memcpy(bytes.ptrw(), p_uuid.data, XR_UUID_SIZE_EXT);
+	p_file->store_buffer(bytes);
+}
+
+static bool get_uuid(const Ref<FileAccess> &p_file, XrUuidEXT &r_uuid) {
+	const PackedByteArray bytes = p_file->get_buffer(XR_UUID_SIZE_EXT);
+	if (bytes.size() != XR_UUID_SIZE_EXT) {
+		return false;
+	}
+	memcpy(r_uuid.data, bytes.ptr(), XR_UUID_SIZE_EXT);
+	return true;
+}
+
+template <typename T>
+static void store_array(const Ref<FileAccess> &p_file, const T *p_data, uint32_t p_count) {
+	p_file->store_32(p_count);
+	if (p_count == 0) {
+		return;
+	}
+
+	PackedByteArray bytes;
+	bytes.resize(p_count * sizeof(T));
+	memcpy(bytes.ptrw(), p_data, bytes.size());
+	p_file->store_buffer(bytes);
+}
+
+template <typename T>
+static bool get_array(const Ref<FileAccess> &p_file, Vector<T> &r_array) {
+	const uint32_t count = p_file->get_32();
+	if (uint64_t(count) * sizeof(T) > p_file->get_length() - p_file->get_position()) {
+		return false;
+	}
+
+	r_array.resize(count);
+	if (count == 0) {
+		return true;
+	}
+
+	const PackedByteArray bytes = p_file->get_buffer(count * sizeof(T));
+	if (bytes.size() != int64_t(count * sizeof(T))) {
+		return false;
+	}
+	memcpy(r_array.ptrw(), bytes.ptr(), bytes.size());
+	return true;
+}
+
+static void store_transform(const Ref<FileAccess> &p_file, const Transform3D &p_transform) {
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			p_file->store_float(p_transform.basis.rows[i][j]);
+		}
+	}
+	for (int i = 0; i < 3; i++) {
+		p_file->store_float(p_transform.origin[i]);
+	}
+}
+
+static Transform3D get_transform(const Ref<FileAccess> &p_file) {
+	Transform3D transform;
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			transform.basis.rows[i][j] = p_file->get_float();
+		}
+	}
+	for (int i = 0; i < 3; i++) {
+		transform.origin[i] = p_file->get_float();
+	}
+	return transform;
+}
+
+static void store_entity(const Ref<FileAccess> &p_file, const XrUuidEXT &p_uuid, const SceneCache::EntityData &p_data) {
+	store_uuid(p_file, p_uuid);
+	p_file->store_32(p_data.components);
+	p_file->store_32(p_data.has_pose ? ENTITY_FLAG_HAS_POSE : 0);
+
+	p_file->store_32(p_data.semantic_labels.size());
+	for (int i = 0; i < p_data.semantic_labels.size(); i++) {
+		p_file->store_pascal_string(p_data.semantic_labels[i]);
+	}
+
+	p_file->store_float(p_data.bounding_box_2d.position.x);
+	p_file->store_float(p_data.bounding_box_2d.position.y);
+	p_file->store_float(p_data.bounding_box_2d.size.x);
+	p_file->store_float(p_data.bounding_box_2d.size.y);
+
+	for (int i = 0; i < 3; i++) {
+		p_file->store_float(p_data.bounding_box_3d.position[i]);
+	}
+	for (int i = 0; i < 3; i++) {
+		p_file->store_float(p_data.bounding_box_3d.size[i]);
+	}
+
+	p_file->store_32(p_data.boundary_2d.size());
+	for (int i = 0; i < p_data.boundary_2d.size(); i++) {
+		p_file->store_float(p_data.boundary_2d[i].x);
+		p_file->store_float(p_data.boundary_2d[i].y);
+	}
+
+	store_array(p_file, p_data.mesh_vertices.ptr(), p_data.mesh_vertices.size());
+	store_array(p_file, p_data.mesh_indices.ptr(), p_data.mesh_indices.size());
+
+	store_transform(p_file, p_data.pose);
+}
+
+static bool get_entity(const Ref<FileAccess> &p_file, XrUuidEXT &r_uuid, SceneCache::EntityData &r_data) {
+	if (!get_uuid(p_file, r_uuid)) {
+		return false;
+	}
+	r_data.components = p_file->get_32();
+	r_data.has_pose = p_file->get_32() & ENTITY_FLAG_HAS_POSE;
+
+	const uint32_t label_count = p_file->get_32();
+	if (label_count > p_file->get_length() - p_file->get_position()) {
+		return false;
+	}
+	r_data.semantic_labels.resize(label_count);
+	for (uint32_t i = 0; i < label_count; i++) {
+		r_data.semantic_labels[i] = p_file->get_pascal_string();
+	}
+
+	r_data.bounding_box_2d.position.x = p_file->get_float();
+	r_data.bounding_box_2d.position.y = p_file->get_float();
+	r_data.bounding_box_2d.size.x = p_file->get_float();
+	r_data.bounding_box_2d.size.y = p_file->get_float();
+
+	for (int i = 0; i < 3; i++) {
+		r_data.bounding_box_3d.position[i] = p_file->get_float();
+	}
+	for (int i = 0; i < 3; i++) {
+		r_data.bounding_box_3d.size[i] = p_file->get_float();
+	}
+
+	const uint32_t boundary_count = p_file->get_32();
+	if (uint64_t(boundary_count) * 2 * sizeof(float) > p_file->get_length() - p_file->get_position()) {
+		return false;
+	}
+	r_data.boundary_2d.resize(boundary_count);
+	for (uint32_t i = 0; i < boundary_count; i++) {
+		r_data.boundary_2d[i].x = p_file->get_float();
+		r_data.boundary_2d[i].y = p_file->get_float();
+	}
+
+	if (!get_array(p_file, r_data.mesh_vertices) || !get_array(p_file, r_data.mesh_indices)) {
+		return false;
+	}
+
+	r_data.pose = get_transform(p_file);
+
+	return !p_file->eof_reached();
+}
+
+bool SceneCache::EntityData::has_same_geometry(const EntityData &p_other) const {
+	if (components != p_other.components ||
+			semantic_labels != p_other.semantic_labels ||
+			bounding_box_2d != p_other.bounding_box_2d ||
+			bounding_box_3d != p_other.bounding_box_3d ||
+			boundary_2d != p_other.boundary_2d) {
+		return false;
+	}
+
+	if (mesh_vertices.size() != p_other.mesh_vertices.size() || mesh_indices.size() != p_other.mesh_indices.size()) {
+		return false;
+	}
+
+	return memcmp(mesh_vertices.ptr(), p_other.mesh_vertices.ptr(), mesh_vertices.size() * sizeof(XrVector3f)) == 0 &&
+			memcmp(mesh_indices.ptr(), p_other.mesh_indices.ptr(), mesh_indices.size() * sizeof(uint32_t)) == 0;
+}
+
+struct UuidLess {
+	_FORCE_INLINE_ bool operator()(const XrUuidEXT &p_a, const XrUuidEXT &p_b) const {
+		return memcmp(p_a.data, p_b.data, XR_UUID_SIZE_EXT) < 0;
+	}
+};
+
+XrUuidEXT SceneCache::make_room_key(const LocalVector<XrUuidEXT> &p_room_layouts) {
+	if (p_room_layouts.size() == 1) {
+		return p_room_layouts[0];
+	}
+
+	LocalVector<XrUuidEXT> sorted = p_room_layouts;
+	sorted.sort_custom<UuidLess>();
+
+	XrUuidEXT key;
+	for (uint32_t i = 0; i < XR_UUID_SIZE_EXT / sizeof(uint32_t); i++) {
+		const uint32_t word = hash_murmur3_buffer(sorted.ptr(), sorted.size() * sizeof(XrUuidEXT), HASH_MURMUR3_SEED + i);
+		memcpy(key.data + i * sizeof(uint32_t), &word, sizeof(uint32_t));
+	}
+	return key;
+}
+
+Error SceneCache::load(const String &p_path) {
+	clear();
+	path = p_path;
+
+	if (!FileAccess::file_exists(path)) {
+		return OK;
+	}
+
+	Ref<FileAccess> file = FileAccess::open(path, FileAccess::READ);
+	if (file.is_null()) {
+		WARN_PRINT(vformat("Failed to open scene cache: %s", path));
+		return ERR_FILE_CANT_OPEN;
+	}
+
+	const PackedByteArray magic = file->get_buffer(4);
+	if (magic.size() != 4 || memcmp(magic.ptr(), cache_magic, 4) != 0 || file->get_32() != VERSION) {
+		WARN_PRINT(vformat("Scene cache has an unknown format, ignoring it: %s", path));
+		return ERR_FILE_UNRECOGNIZED;
+	}
+
+	const uint32_t flags = file->get_32();
+	XrUuidEXT file_last_room;
+	bool valid = get_uuid(file, file_last_room);
+
+	const uint32_t room_count = valid ? file->get_32() : 0;
+	for (uint32_t i = 0; valid && i < room_count; i++) {
+		XrUuidEXT room_uuid;
+		valid = get_uuid(file, room_uuid);
+		const uint32_t entity_count = valid ? file->get_32() : 0;
+
+		Room room;
+		for (uint32_t j = 0; valid && j < entity_count; j++) {
+			XrUuidEXT entity_uuid;
+			EntityData entity_data;
+			valid = get_entity(file, entity_uuid, entity_data);
+			if (valid) {
+				room.insert(entity_uuid, entity_data);
+			}
+		}
+
+		if (valid) {
+			// Rooms are stored least recent first, which keeps them in that order here.
+			rooms.insert(room_uuid, room);
+		}
+	}
+
+	if (!valid) {
+		WARN_PRINT(vformat("Scene cache is truncated, ignoring it: %s", path));
+		clear();
+		path = p_path;
+		return ERR_FILE_CORRUPT;
+	}
+
+	if ((flags & CACHE_FLAG_HAS_LAST_ROOM) && rooms.has(file_last_room)) {
+		last_room = file_last_room;
+		has_last_room = true;
+	}
+	_evict_rooms();
+
+	return OK;
+}
+
+Error SceneCache::save() {
+	ERR_FAIL_COND_V(path.is_empty(), ERR_FILE_BAD_PATH);
+
+	// Write next to the cache and move it over, so an interrupted save doesn't lose the rooms.
+	const String temp_path = path + ".tmp";
+	Ref<FileAccess> file = FileAccess::open(temp_path, FileAccess::WRITE);
+	if (file.is_null()) {
+		WARN_PRINT(vformat("Failed to write scene cache: %s", path));
+		return ERR_FILE_CANT_WRITE;
+	}
+
+	PackedByteArray magic;
+	magic.resize(4);
+	memcpy(magic.ptrw(), cache_magic, 4);
+	file->store_buffer(magic);
+	file->store_32(VERSION);
+	file->store_32(has_last_room ? CACHE_FLAG_HAS_LAST_ROOM : 0);
+	store_uuid(file, last_room);
+
+	file->store_32(rooms.size());
+	for (const KeyValue<XrUuidEXT, Room> &E : rooms) {
+		store_uuid(file, E.key);
+		file->store_32(E.value.size());
+		for (const KeyValue<XrUuidEXT, EntityData> &F : E.value) {
+			store_entity(file, F.key, F.value);
+		}
+	}
+	file->close();
+
+	if (DirAccess::rename_absolute(temp_path, path) != OK) {
+		WARN_PRINT(vformat("Failed to replace scene cache: %s", path));
+		return ERR_FILE_CANT_WRITE;
+	}
+
+	dirty = false;
+	return OK;
+}
+
+void SceneCache::clear() {
+	rooms.clear();
+	last_room = {};
+	has_last_room = false;
+	path = String();
+	dirty = false;
+}
+
+bool SceneCache::get_last_room(XrUuidEXT &r_uuid) const {
+	if (!has_last_room) {
+		return false;
+	}
+	r_uuid = last_room;
+	return true;
+}
+
+const SceneCache::Room *SceneCache::get_room(const XrUuidEXT &p_uuid) const {
+	return rooms.getptr(p_uuid);
+}
+
+void SceneCache::set_room(const XrUuidEXT &p_uuid, const Room &p_room) {
+	// Re-insert to move the room to the end, as the most recent.
+	rooms.erase(p_uuid);
+	rooms.insert(p_uuid, p_room);
+	last_room = p_uuid;
+	has_last_room = true;
+	dirty = true;
+	_evict_rooms();
+}
+
+void SceneCache::erase_room(const XrUuidEXT &p_uuid) {
+	if (!rooms.erase(p_uuid)) {
+		return;
+	}
+
+	if (has_last_room && UuidComparator::compare(last_room, p_uuid)) {
+		last_room = {};
+		has_last_room = false;
+	}
+	dirty = true;
+}
+
+void SceneCache::set_entity_pose(const XrUuidEXT &p_room, const XrUuidEXT &p_entity, const Transform3D &p_pose) {
+	Room *room = rooms.getptr(p_room);
+	EntityData *entity_data = room ? room->getptr(p_entity) : nullptr;
+	if (!entity_data) {
+		return;
+	}
+
+	if (!entity_data->has_pose || entity_data->pose != p_pose) {
+		entity_data->pose = p_pose;
+		entity_data->has_pose = true;
+		dirty = true;
+	}
+}
+
+void SceneCache::_evict_rooms() {
+	while (rooms.size() > MAX_ROOMS) {
+		const XrUuidEXT oldest = rooms.begin()->key;
+		erase_room(oldest);
+	}
+}
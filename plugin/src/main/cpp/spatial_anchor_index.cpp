@@ -0,0 +1,382 @@
+/**************************************************************************/
+/*  spatial_anchor_index.cpp                                              */
+/**************************************************************************/
+/*                       This file is part of:                            */
+/*                              GODOT XR                                  */
+/*                      https://godotengine.org                           */
+/**************************************************************************/
+/* Copyright (c) 2022-present Godot XR contributors (see CONTRIBUTORS.md) */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "spatial_anchor_index.h"
+
+#include <cstddef>
+
+#include <godot_cpp/classes/dir_access.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+#include "util.h"
+
+static const char index_magic[4] = { 'F', 'B', 'A', 'I' };
+
+template <typename T>
+static PackedByteArray to_bytes(const T &p_value) {
+	PackedByteArray bytes;
+	bytes.resize(sizeof(T));
+	memcpy(bytes.ptrw(), &p_value, sizeof(T));
+	return bytes;
+}
+
+void SpatialAnchorIndex::encode_pose(const Transform3D &p_pose, float *r_pose) {
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			r_pose[i * 3 + j] = p_pose.basis.rows[i][j];
+		}
+		r_pose[9 + i] = p_pose.origin[i];
+	}
+}
+
+Transform3D SpatialAnchorIndex::decode_pose(const float *p_pose) {
+	Transform3D pose;
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			pose.basis.rows[i][j] = p_pose[i * 3 + j];
+		}
+		pose.origin[i] = p_pose[9 + i];
+	}
+	return pose;
+}
+
+PackedByteArray SpatialAnchorIndex::encode_data(const Record &p_record) {
+	Array data;
+	data.push_back(p_record.scene_path);
+	data.push_back(p_record.custom_data);
+	return UtilityFunctions::var_to_bytes(data);
+}
+
+void SpatialAnchorIndex::fill_slot(const XrUuidEXT &p_uuid, const Entry &p_entry, Slot &r_slot) const {
+	memcpy(r_slot.uuid, p_uuid.data, XR_UUID_SIZE_EXT);
+	r_slot.flags = SLOT_FLAG_USED;
+	encode_pose(p_entry.record.pose, r_slot.pose);
+	r_slot.data_offset = p_entry.data_offset;
+	r_slot.data_size = p_entry.data_size;
+	r_slot.reserved = 0;
+}
+
+Error SpatialAnchorIndex::load(const String &p_path) {
+	clear();
+	path = p_path;
+
+	if (!FileAccess::file_exists(path)) {
+		return OK;
+	}
+
+	const PackedByteArray data = FileAccess::get_file_as_bytes(path);
+	const uint64_t size = data.size();
+
+	Header header;
+	if (size < sizeof(Header)) {
+		WARN_PRINT(vformat("Spatial anchor index is truncated, ignoring it: %s", path));
+		return ERR_FILE_CORRUPT;
+	}
+	memcpy(&header, data.ptr(), sizeof(Header));
+	if (memcmp(header.magic, index_magic, 4) != 0 || header.version != VERSION) {
+		WARN_PRINT(vformat("Spatial anchor index has an unknown format, ignoring it: %s", path));
+		return ERR_FILE_UNRECOGNIZED;
+	}
+
+	const uint64_t data_start = sizeof(Header) + uint64_t(header.slot_capacity) * sizeof(Slot);
+	if (data_start > size) {
+		WARN_PRINT(vformat("Spatial anchor index is truncated, ignoring it: %s", path));
+		return ERR_FILE_CORRUPT;
+	}
+
+	slot_capacity = header.slot_capacity;
+	data_end = data_start;
+
+	uint32_t used_data = 0;
+	const Slot *slots = reinterpret_cast<const Slot *>(data.ptr() + sizeof(Header));
+	for (uint32_t i = 0; i < slot_capacity; i++) {
+		Slot slot;
+		memcpy(&slot, slots + i, sizeof(Slot));
+		if (!(slot.flags & SLOT_FLAG_USED)) {
+			free_slots.push_back(i);
+			continue;
+		}
+
+		const uint64_t slot_data_end = uint64_t(slot.data_offset) + slot.data_size;
+		Variant slot_data;
+		if (slot.data_offset >= data_start && slot_data_end <= size) {
+			slot_data = UtilityFunctions::bytes_to_var(data.slice(slot.data_offset, slot_data_end));
+		}
+		if (slot_data.get_type() != Variant::ARRAY || Array(slot_data).size() != 2) {
+			WARN_PRINT(vformat("Spatial anchor index has a corrupt record, dropping it: %s", path));
+			free_slots.push_back(i);
+			erased_slots.push_back(i);
+			dirty = true;
+			continue;
+		}
+
+		XrUuidEXT uuid;
+		memcpy(uuid.data, slot.uuid, XR_UUID_SIZE_EXT);
+
+		const Entry *duplicate = entries.getptr(uuid);
+		if (duplicate) {
+			// Keep the later record, and free the earlier slot so it isn't leaked.
+			WARN_PRINT(vformat("Spatial anchor index has a duplicate record, dropping the earlier one: %s", path));
+			free_slots.push_back(duplicate->slot);
+			erased_slots.push_back(duplicate->slot);
+			used_data -= duplicate->data_size;
+			dirty = true;
+		}
+
+		Entry &entry = entries[uuid];
+		entry.slot = i;
+		entry.data_offset = slot.data_offset;
+		entry.data_size = slot.data_size;
+		entry.record.pose = decode_pose(slot.pose);
+		entry.record.scene_path = Array(slot_data)[0];
+		entry.record.custom_data = Array(slot_data)[1];
+
+		used_data += slot.data_size;
+		data_end = MAX(data_end, uint32_t(slot_data_end));
+	}
+
+	unused_data = data_end - data_start - used_data;
+	needs_rewrite = false;
+
+	return OK;
+}
+
+Error SpatialAnchorIndex::flush() {
+	ERR_FAIL_COND_V_MSG(path.is_empty(), ERR_FILE_BAD_PATH, "Spatial anchor index has no path.");
+
+	if (!dirty) {
+		return OK;
+	}
+
+	// Compact once more than half of the data region is unused.
+	if (needs_rewrite || unused_data > (data_end - get_data_start()) / 2) {
+		return rewrite();
+	}
+
+	Ref<FileAccess> file = FileAccess::open(path, FileAccess::READ_WRITE);
+	if (file.is_null()) {
+		return rewrite();
+	}
+
+	const Slot empty_slot = {};
+	for (uint32_t slot : erased_slots) {
+		file->seek(sizeof(Header) + slot * sizeof(Slot));
+		file->store_buffer(to_bytes(empty_slot));
+	}
+	erased_slots.clear();
+
+	for (KeyValue<XrUuidEXT, Entry> &E : entries) {
+		Entry &entry = E.value;
+		if (entry.data_dirty) {
+			const PackedByteArray entry_data = encode_data(entry.record);
+			const uint32_t entry_data_size = entry_data.size();
+			if (entry.data_size > 0 && entry_data_size <= entry.data_size) {
+				unused_data += entry.data_size - entry_data_size;
+			} else {
+				unused_data += entry.data_size;
+				entry.data_offset = data_end;
+				data_end += entry_data_size;
+			}
+			entry.data_size = entry_data_size;
+
+			file->seek(entry.data_offset);
+			file->store_buffer(entry_data);
+		}
+
+		if (entry.data_dirty) {
+			Slot slot;
+			fill_slot(E.key, entry, slot);
+			file->seek(sizeof(Header) + entry.slot * sizeof(Slot));
+			file->store_buffer(to_bytes(slot));
+		} else if (entry.pose_dirty) {
+			float pose[12];
+			encode_pose(entry.record.pose, pose);
+			file->seek(sizeof(Header) + entry.slot * sizeof(Slot) + offsetof(Slot, pose));
+			file->store_buffer(to_bytes(pose));
+		}
+
+		entry.data_dirty = false;
+		entry.pose_dirty = false;
+	}
+
+	dirty = false;
+	return OK;
+}
+
+Error SpatialAnchorIndex::rewrite() {
+	slot_capacity = MIN_SLOT_CAPACITY;
+	while (slot_capacity < entries.size() * 2) {
+		slot_capacity *= 2;
+	}
+
+	PackedByteArray file_data;
+	file_data.resize(get_data_start());
+	memset(file_data.ptrw(), 0, file_data.size());
+
+	Header header = {};
+	memcpy(header.magic, index_magic, 4);
+	header.version = VERSION;
+	header.slot_capacity = slot_capacity;
+	memcpy(file_data.ptrw(), &header, sizeof(Header));
+
+	uint32_t slot_index = 0;
+	for (KeyValue<XrUuidEXT, Entry> &E : entries) {
+		Entry &entry = E.value;
+		const PackedByteArray entry_data = encode_data(entry.record);
+		entry.slot = slot_index++;
+		entry.data_offset = file_data.size();
+		entry.data_size = entry_data.size();
+		entry.data_dirty = false;
+		entry.pose_dirty = false;
+		file_data.append_array(entry_data);
+
+		Slot slot;
+		fill_slot(E.key, entry, slot);
+		memcpy(file_data.ptrw() + sizeof(Header) + entry.slot * sizeof(Slot), &slot, sizeof(Slot));
+	}
+
+	free_slots.clear();
+	for (uint32_t i = slot_capacity; i > slot_index; i--) {
+		free_slots.push_back(i - 1);
+	}
+	erased_slots.clear();
+	data_end = file_data.size();
+	unused_data = 0;
+
+	// Write next to the index and move it over, so an interrupted write doesn't lose the anchors.
+	const String temp_path = path + ".tmp";
+	Ref<FileAccess> file = FileAccess::open(temp_path, FileAccess::WRITE);
+	if (file.is_null()) {
+		WARN_PRINT(vformat("Failed to write spatial anchor index: %s", path));
+		needs_rewrite = true;
+		return ERR_FILE_CANT_WRITE;
+	}
+	file->store_buffer(file_data);
+	file->close();
+
+	if (DirAccess::rename_absolute(temp_path, path) != OK) {
+		WARN_PRINT(vformat("Failed to replace spatial anchor index: %s", path));
+		needs_rewrite = true;
+		return ERR_FILE_CANT_WRITE;
+	}
+
+	dirty = false;
+	needs_rewrite = false;
+	return OK;
+}
+
+void SpatialAnchorIndex::clear() {
+	entries.clear();
+	free_slots.clear();
+	erased_slots.clear();
+	slot_capacity = 0;
+	data_end = 0;
+	unused_data = 0;
+	dirty = false;
+	needs_rewrite = true;
+}
+
+bool SpatialAnchorIndex::has_record(const XrUuidEXT &p_uuid) const {
+	return entries.has(p_uuid);
+}
+
+const SpatialAnchorIndex::Record *SpatialAnchorIndex::get_record(const XrUuidEXT &p_uuid) const {
+	const Entry *entry = entries.getptr(p_uuid);
+	return entry ? &entry->record : nullptr;
+}
+
+Array SpatialAnchorIndex::get_uuids() const {
+	Array ret;
+	ret.resize(entries.size());
+	int i = 0;
+	for (const KeyValue<XrUuidEXT, Entry> &E : entries) {
+		ret[i++] = OpenXRUtilities::uuid_to_string_name(E.key);
+	}
+	return ret;
+}
+
+Dictionary SpatialAnchorIndex::get_all_custom_data() const {
+	Dictionary ret;
+	for (const KeyValue<XrUuidEXT, Entry> &E : entries) {
+		ret[OpenXRUtilities::uuid_to_string_name(E.key)] = E.value.record.custom_data;
+	}
+	return ret;
+}
+
+void SpatialAnchorIndex::set_record(const XrUuidEXT &p_uuid, const Transform3D &p_pose, const String &p_scene_path, const Dictionary &p_custom_data) {
+	Entry *entry = entries.getptr(p_uuid);
+	if (!entry) {
+		Entry new_entry;
+		if (free_slots.is_empty()) {
+			needs_rewrite = true;
+		} else {
+			new_entry.slot = free_slots[free_slots.size() - 1];
+			free_slots.resize(free_slots.size() - 1);
+		}
+		entry = &entries.insert(p_uuid, new_entry)->value;
+		entry->data_dirty = true;
+	} else if (entry->record.scene_path != p_scene_path || entry->record.custom_data != p_custom_data) {
+		entry->data_dirty = true;
+	}
+
+	if (entry->record.pose != p_pose) {
+		entry->pose_dirty = true;
+	}
+
+	entry->record.pose = p_pose;
+	entry->record.scene_path = p_scene_path;
+	entry->record.custom_data = p_custom_data;
+	dirty = dirty || entry->data_dirty || entry->pose_dirty;
+}
+
+void SpatialAnchorIndex::set_pose(const XrUuidEXT &p_uuid, const Transform3D &p_pose) {
+	Entry *entry = entries.getptr(p_uuid);
+	if (!entry || entry->record.pose == p_pose) {
+		return;
+	}
+
+	entry->record.pose = p_pose;
+	entry->pose_dirty = true;
+	dirty = true;
+}
+
+void SpatialAnchorIndex::erase_record(const XrUuidEXT &p_uuid) {
+	Entry *entry = entries.getptr(p_uuid);
+	if (!entry) {
+		return;
+	}
+
+	if (entry->slot != INVALID_SLOT) {
+		free_slots.push_back(entry->slot);
+		erased_slots.push_back(entry->slot);
+	}
+	unused_data += entry->data_size;
+	entries.erase(p_uuid);
+	dirty = true;
+}
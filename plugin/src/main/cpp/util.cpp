@@ -31,25 +31,69 @@
 
 #include <openxr/internal/xr_linear.h>
 #include <openxr/openxr.h>
-#include <stdio.h>
 #include <godot_cpp/variant/projection.hpp>
 
 using namespace godot;
 
-StringName OpenXRUtilities::uuid_to_string_name(const XrUuid &p_uuid) {
-	const uint8_t *data = p_uuid.data;
-	char uuid_str[37];
+void OpenXRUtilities::uuid_to_chars(const XrUuid &p_uuid, char *r_chars) {
+	static const char hex_digits[] = "0123456789abcdef";
 
-	sprintf(uuid_str, "%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x",
-			data[0], data[1], data[2], data[3],
-			data[4], data[5],
-			data[6], data[7],
-			data[8], data[9],
-			data[10], data[11], data[12], data[13], data[14], data[15]);
+	char *c = r_chars;
+	for (int i = 0; i < XR_UUID_SIZE; i++) {
+		if (i == 4 || i == 6 || i == 8 || i == 10) {
+			*c++ = '-';
+		}
+		*c++ = hex_digits[p_uuid.data[i] >> 4];
+		*c++ = hex_digits[p_uuid.data[i] & 0xf];
+	}
+	*c = '\0';
+}
 
+StringName OpenXRUtilities::uuid_to_string_name(const XrUuid &p_uuid) {
+	char uuid_str[UUID_STRING_LENGTH + 1];
+	uuid_to_chars(p_uuid, uuid_str);
 	return StringName(uuid_str);
 }
 
+static inline int hex_digit_value(char32_t p_char) {
+	if (p_char >= '0' && p_char <= '9') {
+		return p_char - '0';
+	}
+	if (p_char >= 'a' && p_char <= 'f') {
+		return p_char - 'a' + 10;
+	}
+	if (p_char >= 'A' && p_char <= 'F') {
+		return p_char - 'A' + 10;
+	}
+	return -1;
+}
+
+bool OpenXRUtilities::string_to_uuid(const String &p_string, XrUuid &r_uuid) {
+	const char32_t *c = p_string.ptr();
+	if (c == nullptr) {
+		return false;
+	}
+
+	int digits = 0;
+	for (; *c != 0; c++) {
+		if (*c == '-') {
+			continue;
+		}
+		const int value = hex_digit_value(*c);
+		if (value < 0 || digits == XR_UUID_SIZE * 2) {
+			return false;
+		}
+		if (digits % 2 == 0) {
+			r_uuid.data[digits / 2] = value << 4;
+		} else {
+			r_uuid.data[digits / 2] |= value;
+		}
+		digits++;
+	}
+
+	return digits == XR_UUID_SIZE * 2;
+}
+
 void OpenXRUtilities::xrMatrix4x4f_to_godot_projection(XrMatrix4x4f *m, godot::Projection &p) {
 	for (int j = 0; j < 4; j++) {
 		for (int i = 0; i < 4; i++) {